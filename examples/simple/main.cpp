@@ -27,9 +27,15 @@ int main(int argc, const char* argv[]) {
   // Prepopulate narrowphases, this is necessary for thread safety.
   narrowphases.prepopulate();
 
+  // Worker threads are also an injected dependency. The thread calling step()
+  // participates in the work, hence the -1.
+  unsigned int hw_threads = std::thread::hardware_concurrency();
+  phys::ThreadPool thread_pool(hw_threads > 1 ? hw_threads - 1 : 0);
+
   // Create a world
   World world(2,              // Announce that we expect 2 objects. (This is just a hint)
-              &narrowphases); // Provide our narrowphase factory.
+              &narrowphases,  // Provide our narrowphase factory.
+              &thread_pool);  // Optional: Provide worker threads.
   
   // We'll need two shapes:
   // 1. a plane, for the floor.
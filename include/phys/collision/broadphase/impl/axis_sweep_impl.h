@@ -168,8 +168,8 @@ void AxisSweepBroadphase<CFG>::sortMinUp_(int axis, uint32_t edge_id,
     std::swap(*edge, *next_edge);
 
     // The sentinel value will force us out of the loop if necessary.
-    edge--;
-    next_edge--;
+    edge++;
+    next_edge++;
   }
 }
 
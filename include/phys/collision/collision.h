@@ -1,8 +1,14 @@
 #ifndef PHYS_COLLISION_COLLISION_H
 #define PHYS_COLLISION_COLLISION_H
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include "phys/collision/collision_object.h"
-#include "phys/util_types/static_vector.h"
 
 namespace phys {
 
@@ -23,14 +29,228 @@ struct Contact {
   real_t distance;
 
   real_t total_restitution = 0;
+
+  // Impulse the solver applied along the normal at this point during the
+  // last step. Points persist across steps as long as they match, so the
+  // next step can start from it.
+  real_t applied_impulse = 0;
+};
+
+// Blocks of contacts of a given capacity, recycled through one free list per
+// capacity so that manifolds do not each go through the allocator. The
+// blocks are carved out of chunks that grow with the pool.
+//
+// It is not thread safe. The collision world only takes and returns blocks
+// from its serial passes, and algorithms that manage collisions of their own
+// own a pool for them.
+template <typename CFG>
+class ContactPool {
+ public:
+  enum {
+    max_capacity = CFG::max_contact_points_per_collision,
+    max_blocks_per_chunk = 64,
+  };
+
+  ContactPool() = default;
+  ContactPool(ContactPool const&) = delete;
+  ContactPool& operator=(ContactPool const&) = delete;
+
+  Contact<CFG>* acquire(std::size_t capacity) {
+    assert(capacity > 0 && capacity <= max_capacity);
+    auto& free_blocks = free_[capacity];
+    if(free_blocks.empty()) {
+      // Chunks double in size, so that small pools stay small.
+      std::size_t block_count = std::max<std::size_t>(
+          1, std::min<std::size_t>(block_count_[capacity],
+                                   max_blocks_per_chunk));
+      chunks_.emplace_back(new Contact<CFG>[block_count * capacity]);
+      for(std::size_t i = block_count; i-- > 0;) {
+        free_blocks.push_back(chunks_.back().get() + i * capacity);
+      }
+      block_count_[capacity] += block_count;
+    }
+
+    auto result = free_blocks.back();
+    free_blocks.pop_back();
+    return result;
+  }
+
+  void release(Contact<CFG>* block, std::size_t capacity) {
+    free_[capacity].push_back(block);
+  }
+
+ private:
+  std::array<std::vector<Contact<CFG>*>, max_capacity + 1> free_;
+  std::array<std::size_t, max_capacity + 1> block_count_ = {};
+  std::vector<std::unique_ptr<Contact<CFG>[]>> chunks_;
+};
+
+// The contact points of a collision, up to a capacity set by its narrowphase
+// algorithm.
+//
+// Many pairs never touch at more than one point, such as most of the ones
+// involving a sphere, so the points are stored in a block sized to the
+// capacity. It comes from the pool given to setCapacity(), which is then
+// where it returns, or from the heap when there is none.
+template <typename CFG>
+class ContactManifold {
+ public:
+  using iterator = Contact<CFG>*;
+  using const_iterator = Contact<CFG> const*;
+
+  ContactManifold() = default;
+
+  ~ContactManifold() {
+    release_();
+  }
+
+  ContactManifold(ContactManifold const& rhs) {
+    *this = rhs;
+  }
+
+  ContactManifold(ContactManifold&& rhs) {
+    *this = std::move(rhs);
+  }
+
+  ContactManifold& operator=(ContactManifold&& rhs) {
+    if(this == &rhs) {
+      return *this;
+    }
+    release_();
+    block_ = rhs.block_;
+    pool_ = rhs.pool_;
+    capacity_ = rhs.capacity_;
+    size_ = rhs.size_;
+    rhs.block_ = nullptr;
+    rhs.size_ = 0;
+    return *this;
+  }
+
+  ContactManifold& operator=(ContactManifold const& rhs) {
+    if(this == &rhs) {
+      return *this;
+    }
+    size_ = 0;
+    setCapacity(rhs.capacity_, rhs.pool_);
+    for(auto const& contact : rhs) {
+      emplace_back() = contact;
+    }
+    return *this;
+  }
+
+  // Changes how many points the manifold can hold. It must not hold more
+  // than that already. pool is optional, and must outlive the manifold.
+  // Since this is where the block is taken from it, this must only be called
+  // from where the pool may be used.
+  void setCapacity(std::size_t capacity, ContactPool<CFG>* pool = nullptr) {
+    assert(capacity > 0 && capacity <= CFG::max_contact_points_per_collision);
+    assert(size_ <= capacity);
+
+    if(block_ && capacity == capacity_ && pool == pool_) {
+      return;
+    }
+
+    Contact<CFG>* old_block = block_;
+    ContactPool<CFG>* old_pool = pool_;
+    std::size_t old_capacity = capacity_;
+
+    capacity_ = uint32_t(capacity);
+    pool_ = pool;
+    allocate_();
+    if(old_block) {
+      std::copy(old_block, old_block + size_, block_);
+      free_(old_block, old_pool, old_capacity);
+    }
+  }
+
+  std::size_t capacity() const {
+    return capacity_;
+  }
+
+  iterator begin() {
+    return block_;
+  }
+
+  iterator end() {
+    return block_ + size_;
+  }
+
+  const_iterator begin() const {
+    return block_;
+  }
+
+  const_iterator end() const {
+    return block_ + size_;
+  }
+
+  Contact<CFG>& emplace_back() {
+    assert(!full());
+
+    // Without a prior setCapacity(), which the collision world always does.
+    if(!block_) {
+      allocate_();
+    }
+    return block_[size_++] = Contact<CFG>();
+  }
+
+  bool full() const {
+    return size_ == capacity_;
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+  void pop_back() {
+    --size_;
+  }
+
+  // Only shrinks the manifold.
+  void resize(std::size_t size) {
+    assert(size <= size_);
+    size_ = uint32_t(size);
+  }
+
+  Contact<CFG>& operator[](std::size_t i) {
+    return block_[i];
+  }
+
+  Contact<CFG> const& operator[](std::size_t i) const {
+    return block_[i];
+  }
+
+ private:
+  Contact<CFG>* block_ = nullptr;
+  ContactPool<CFG>* pool_ = nullptr;
+  uint32_t capacity_ = CFG::max_contact_points_per_collision;
+  uint32_t size_ = 0;
+
+  void allocate_() {
+    block_ = pool_ ? pool_->acquire(capacity_) : new Contact<CFG>[capacity_];
+  }
+
+  void release_() {
+    if(block_) {
+      free_(block_, pool_, capacity_);
+      block_ = nullptr;
+    }
+  }
+
+  static void free_(Contact<CFG>* block, ContactPool<CFG>* pool,
+                    std::size_t capacity) {
+    if(pool) {
+      pool->release(block, capacity);
+    } else {
+      delete[] block;
+    }
+  }
 };
 
 template <typename CFG>
 struct Collision {
   using real_t = typename CFG::real_t;
 
-  using points_container =
-      StaticVector<Contact<CFG>, CFG::max_contact_points_per_collision>;
+  using points_container = ContactManifold<CFG>;
 
   // The objects involved in the collision.
   std::array<col::Object<CFG>*, 2> objects;
@@ -39,54 +259,156 @@ struct Collision {
   points_container points;
 
   // Which simulation island this collision has been assigned to.
-  mutable uint32_t island_id_;
+  mutable uint32_t island_id_ = 0;
+
+  // Lower bound of the distance between the two objects, reported by
+  // narrowphases that did not find any contact. It is eroded by the objects'
+  // motion every frame, and the narrowphase can be skipped until it reaches
+  // the contact distance. Algorithms that do not report it leave it at 0,
+  // which never skips.
+  real_t separation_ = 0;
+
+  // Support mapping hints for each object, see
+  // Convex::getSupportingVertexWithHint().
+  std::array<uint32_t, 2> support_hints_ = {{0, 0}};
+
+  // The objects' Object::transform_version_ as of the last refresh. The
+  // points do not need to be refreshed until either of them changes.
+  std::array<uint32_t, 2> refreshed_versions_ = {{0, 0}};
+
+  // Pose of the first object in the second one's space when the narrowphase
+  // last ran, how many points it left, and whether those were all it would
+  // find. See canReuseManifold().
+  Transform<CFG> manifold_pose_;
+  uint32_t manifold_point_count_ = 0;
+  bool manifold_complete_ = false;
 
-  real_t getContactDistance() {
+  // Friction impulses the solver applied to the whole collision during the
+  // last step, see Contact::applied_impulse. The tangent impulse is in world
+  // space, the twist one is around the normal.
+  typename CFG::vec3_t friction_impulse_ = {0, 0, 0};
+  real_t twist_impulse_ = 0;
+
+  // Fixed part of the contact distance. Contacts within it are resting or
+  // sliding ones, rather than speculative ones.
+  real_t getRestingMargin() const {
     return 0.02f;
   }
 
-  real_t getContactDistanceSq() {
-    return 0.02f * 0.02f;
+  // Contacts are generated and kept up to this distance. On top of the
+  // resting margin, it covers how much closer the objects can get over the
+  // coming step: such speculative contacts let the solver stop fast objects
+  // at the surface instead of finding them on the other side of it.
+  real_t getContactDistance() const {
+    return getRestingMargin() + objects[0]->getSweepDistance() +
+           objects[1]->getSweepDistance();
+  }
+
+  // Squared distance within which points are taken for the same one, and
+  // past which a point that slid along the contact plane expires. It is the
+  // resting margin's square, and does not grow with the objects' motion
+  // like getContactDistance() does.
+  real_t getMatchToleranceSq() const {
+    return getRestingMargin() * getRestingMargin();
   }
 
+  void setSeparation(real_t distance) {
+    separation_ = distance;
+  }
+
+  // Accounts for this frame's motion of both objects. Returns true if they
+  // still cannot be within contact distance of each other, in which case the
+  // narrowphase does not need to run.
+  bool updateSeparation() {
+    separation_ -= objects[0]->frame_motion_ + objects[1]->frame_motion_;
+    if(points.size() == 0 && separation_ > getContactDistance()) {
+      return true;
+    }
+
+    // The narrowphase will report a fresh value if it has one.
+    separation_ = 0;
+    return false;
+  }
+
+  // Whether either object moved since the points were last refreshed.
+  bool needsRefresh() const {
+    return refreshed_versions_[0] != objects[0]->transform_version_ ||
+           refreshed_versions_[1] != objects[1]->transform_version_;
+  }
+
+  // Recomputes the points' world space data from the objects' current
+  // transforms, and drops the ones that drifted out of contact, preserving
+  // the order of the others.
   void refresh() {
     auto const& transform_0 = objects[0]->transform;
     auto const& transform_1 = objects[1]->transform;
 
-    for(std::size_t i = 0; i < points.size();) {
-      points[i].ws_position[0] =
-          transform_0.applyToVec(points[i].os_position[0]);
-      points[i].ws_position[1] =
-          transform_1.applyToVec(points[i].os_position[1]);
+    std::size_t kept = 0;
+    for(std::size_t i = 0; i < points.size(); ++i) {
+      auto& point = points[i];
+      point.ws_position[0] = transform_0.applyToVec(point.os_position[0]);
+      point.ws_position[1] = transform_1.applyToVec(point.os_position[1]);
 
       // This ws_normal feels wrong. If the objects are rotating, that'll be
       // wrong.
-      points[i].distance =
-          dot(points[i].ws_position[0] - points[i].ws_position[1],
-              points[i].ws_normal);
-
-      bool remove_point = false;
-      if(points[i].distance > getContactDistance()) {
-        remove_point = true;
-      } else {
-        auto projected =
-            points[i].ws_position[0] - points[i].ws_normal * points[i].distance;
-        auto projected_diff = points[i].ws_position[1] - projected;
-        auto dist_2d = dot(projected_diff, projected_diff);
-        ;
-        if(dist_2d > getContactDistanceSq()) {
-          remove_point = true;
-        }
-      }
-      if(remove_point) {
-        if(i != points.size() - 1) {
-          std::swap(points[i], points[points.size() - 1]);
+      point.distance =
+          dot(point.ws_position[0] - point.ws_position[1], point.ws_normal);
+
+      auto projected = point.ws_position[0] - point.ws_normal * point.distance;
+      auto projected_diff = point.ws_position[1] - projected;
+      if(point.distance <= getContactDistance() &&
+         dot(projected_diff, projected_diff) <= getMatchToleranceSq()) {
+        if(kept != i) {
+          points[kept] = point;
         }
-        points.pop_back();
-      } else {
-        ++i;
+        ++kept;
       }
     }
+    points.resize(kept);
+
+    refreshed_versions_ = {
+        {objects[0]->transform_version_, objects[1]->transform_version_}};
+  }
+
+  // Remembers the objects' relative pose, to be called right after the
+  // narrowphase ran. one_shot is the narrowphase's Narrowphase::oneShot().
+  void recordManifoldPose(bool one_shot) {
+    manifold_pose_ = getRelativePose_();
+    manifold_point_count_ = uint32_t(points.size());
+    manifold_complete_ = one_shot || points.full();
+  }
+
+  // Whether the narrowphase would find the same points as it did when
+  // recordManifoldPose() was last called, which is assumed as long as the
+  // objects are still touching with all of these points and their relative
+  // pose stayed within max_translation and max_rotation (in radians) of what
+  // it was. Refreshing the points is then enough to keep them up to date.
+  //
+  // Narrowphases that add a point per call only fill the manifold over
+  // several calls, so until it is full, it is never reused.
+  bool canReuseManifold(real_t max_translation, real_t max_rotation) const {
+    if(!manifold_complete_ || points.size() == 0 ||
+       points.size() != manifold_point_count_) {
+      return false;
+    }
+
+    auto pose = getRelativePose_();
+    auto d_trans = pose.getTranslation() - manifold_pose_.getTranslation();
+    if(dot(d_trans, d_trans) > max_translation * max_translation) {
+      return false;
+    }
+
+    // The trace of the rotation between the two poses gives its angle.
+    auto const& rot = pose.getRotationMatrix();
+    auto const& prev_rot = manifold_pose_.getRotationMatrix();
+    real_t trace = dot(rot[0], prev_rot[0]) + dot(rot[1], prev_rot[1]) +
+                   dot(rot[2], prev_rot[2]);
+    return (trace - 1) * real_t(0.5) >= std::cos(max_rotation);
+  }
+
+ private:
+  Transform<CFG> getRelativePose_() const {
+    return objects[1]->transform.inverse() * objects[0]->transform;
   }
 };
 }
@@ -21,6 +21,13 @@ struct CollisionCacheEntry {
     collision.objects = {a, b};
   }
 
+  // Rough relative cost of updating this entry, used to balance the
+  // narrowphase across threads. Existing contact points all need to be
+  // refreshed on top of running the narrowphase itself.
+  std::size_t estimatedCost() const {
+    return 1 + collision.points.size();
+  }
+
   // The collision itself.
   Collision<CFG> collision;
 
@@ -1,6 +1,7 @@
 #ifndef PHYS_COLLISION_OBJECT_H
 #define PHYS_COLLISION_OBJECT_H
 
+#include <algorithm>
 #include "phys/collision/broadphase/axis_sweep.h"
 #include "phys/collision/shape.h"
 #include "phys/math_types/transform.h"
@@ -21,12 +22,33 @@ struct Object {
   Shape<CFG>* shape;
   Transform<CFG> transform;
 
+  // Friction coefficient. Contacts use the geometric mean of both objects'.
+  typename CFG::real_t friction = typename CFG::real_t(0.5);
+
   // index of the object in the collision world.
   uint32_t world_index_;
 
   OwnerType owner_type_ = NO_OWNER;
   void* owner_ = nullptr;
 
+  // Conservative bound on how far any point of the object travelled between
+  // the last two calls to updateMotion(). Objects that are never updated,
+  // such as static ones, are considered immobile.
+  typename CFG::real_t frame_motion_ = 0;
+
+  // Transform as of the last call to updateMotion().
+  Transform<CFG> motion_reference_;
+
+  // Bumped by updateMotion() whenever the transform changed, so that data
+  // derived from it, such as contact points, can tell when it is stale.
+  uint32_t transform_version_ = 0;
+
+  // Expected displacement over the coming step, and a bound on how far its
+  // rotation can move any point of the object. The object's bounds are swept
+  // along them, and its collisions look that much further ahead.
+  typename CFG::vec3_t sweep_ = {0, 0, 0};
+  typename CFG::real_t sweep_rotation_ = 0;
+
   bool isActive() const {
     return true;
   }
@@ -36,7 +58,61 @@ struct Object {
   }
 
   void getAabb(Aabb<CFG>* dst) {
+    using vec3_t = typename CFG::vec3_t;
+
     shape->getAabb(dst, transform);
+
+    vec3_t zero = {0, 0, 0};
+    vec3_t rotation = {sweep_rotation_, sweep_rotation_, sweep_rotation_};
+    dst->min_bound += min(sweep_, zero) - rotation;
+    dst->max_bound += max(sweep_, zero) + rotation;
+  }
+
+  // How much closer to anything this object can get over the coming step.
+  typename CFG::real_t getSweepDistance() const {
+    return length(sweep_) + sweep_rotation_;
+  }
+
+  // Predicts the coming step's motion from the object's velocities.
+  void setSweep(typename CFG::vec3_t const& linear_vel,
+                typename CFG::vec3_t const& angular_vel,
+                typename CFG::real_t dt) {
+    using real_t = typename CFG::real_t;
+
+    sweep_ = linear_vel * dt;
+
+    // A rotation by an angle moves points by at most that angle times their
+    // distance to the axis, and never more than the shape's diameter.
+    real_t angle = std::min(length(angular_vel) * dt, real_t(2));
+    sweep_rotation_ = angle * shape->getBoundingRadius();
+  }
+
+  // Measures the motion since the last call from the transform itself, so
+  // that it accounts for integration, penetration pushes and user-applied
+  // teleports alike.
+  void updateMotion() {
+    using real_t = typename CFG::real_t;
+
+    auto d_trans =
+        transform.getTranslation() - motion_reference_.getTranslation();
+
+    // The frobenius norm of the rotation delta is an upper bound of how far a
+    // point at unit distance from the origin can have moved.
+    auto const& rot = transform.getRotationMatrix();
+    auto const& prev_rot = motion_reference_.getRotationMatrix();
+    real_t d_rot_sq = 0;
+    for(int i = 0; i < 3; ++i) {
+      auto d_col = rot[i] - prev_rot[i];
+      d_rot_sq += dot(d_col, d_col);
+    }
+
+    frame_motion_ =
+        length(d_trans) + sqrt(d_rot_sq) * shape->getBoundingRadius();
+    motion_reference_ = transform;
+
+    if(dot(d_trans, d_trans) > 0 || d_rot_sq > 0) {
+      ++transform_version_;
+    }
   }
 };
 
@@ -5,6 +5,7 @@
 #include "phys/collision/broadphase/axis_sweep.h"
 #include "phys/collision/collision_cache.h"
 #include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/util_types/thread_pool.h"
 
 namespace phys {
 
@@ -14,9 +15,34 @@ namespace phys {
 template <typename CFG>
 struct CollisionWorld {
   using Object = col::Object<CFG>;
-
-  CollisionWorld(col::NarrowphaseFactory<CFG>* np_factory)
-      : narrowphase_factory_(np_factory) {}
+  using real_t = typename CFG::real_t;
+
+  enum {
+    // Below this estimated cost, the narrowphase is not worth dispatching to
+    // the thread pool.
+    min_parallel_narrowphase_cost = 256,
+
+    // Splitting the work in more chunks than threads lets the pool balance
+    // out the error in our cost estimates.
+    narrowphase_chunks_per_thread = 4,
+  };
+
+  // Objects resting on each other keep producing the same contacts. When
+  // enabled, pairs that are touching skip the narrowphase, and only have
+  // their points refreshed, for as long as their relative pose stays within
+  // these tolerances of the one the points were found at.
+  //
+  // The points then drift along with the objects instead of being found
+  // again, by up to the tolerances, which is why this is opt-in.
+  struct ManifoldReuse {
+    bool enabled = false;
+    real_t max_translation = real_t(0.005);
+    real_t max_rotation = real_t(0.01);
+  };
+
+  CollisionWorld(col::NarrowphaseFactory<CFG>* np_factory,
+                 ThreadPool* thread_pool = nullptr)
+      : narrowphase_factory_(np_factory), thread_pool_(thread_pool) {}
 
   using collision_mask_t = typename CFG::collision_mask_t;
 
@@ -33,21 +59,66 @@ struct CollisionWorld {
   }
 
   void updateNarrowphase() {
+    // Assigning narrowphases goes through the factory's lookup tables, so it
+    // is done serially. Once every pair has one, the pairs are fully
+    // independent from each other.
+    narrowphase_queue_.resize(0);
+    std::size_t total_cost = 0;
     for(auto& pair : collisions()) {
       auto& entry = pair.second;
 
       if(!entry.narrowphase_) {
         // find a narrowphase for this pair.
-        pair.second.narrowphase_ = narrowphase_factory_->getNarrowphase(
+        entry.narrowphase_ = narrowphase_factory_->getNarrowphase(
             entry.collision.objects[0]->shape,
             entry.collision.objects[1]->shape);
+        entry.collision.points.setCapacity(
+            entry.narrowphase_->contactCapacity(), &contact_pool_);
+      }
+
+      if(entry.collision.updateSeparation()) {
+        continue;
       }
 
-      // update existing contacts before adding any new ones.
-      entry.collision.refresh();
+      narrowphase_queue_.push_back(&entry);
+      total_cost += entry.estimatedCost();
+    }
 
-      pair.second.narrowphase_->process(&entry.collision);
+    if(!thread_pool_ || thread_pool_->threadCount() == 1 ||
+       total_cost < min_parallel_narrowphase_cost) {
+      for(auto entry : narrowphase_queue_) {
+        processEntry_(entry);
+      }
+      return;
     }
+
+    // Split the queue in contiguous chunks of roughly equal cost.
+    std::size_t chunk_count =
+        thread_pool_->threadCount() * narrowphase_chunks_per_thread;
+    std::size_t cost_per_chunk = (total_cost + chunk_count - 1) / chunk_count;
+
+    narrowphase_chunks_.resize(0);
+    narrowphase_chunks_.push_back(0);
+    std::size_t chunk_cost = 0;
+    for(std::size_t i = 0; i < narrowphase_queue_.size(); ++i) {
+      chunk_cost += narrowphase_queue_[i]->estimatedCost();
+      if(chunk_cost >= cost_per_chunk) {
+        narrowphase_chunks_.push_back(i + 1);
+        chunk_cost = 0;
+      }
+    }
+    if(narrowphase_chunks_.back() != narrowphase_queue_.size()) {
+      narrowphase_chunks_.push_back(narrowphase_queue_.size());
+    }
+
+    thread_pool_->parallelFor(
+        narrowphase_chunks_.size() - 1, [this](std::size_t chunk, std::size_t) {
+          auto begin = narrowphase_chunks_[chunk];
+          auto end = narrowphase_chunks_[chunk + 1];
+          for(auto i = begin; i < end; ++i) {
+            processEntry_(narrowphase_queue_[i]);
+          }
+        });
   }
 
   std::vector<Object*> objects_;
@@ -56,7 +127,41 @@ struct CollisionWorld {
   std::vector<Object*> isolatable_objects_;
 
   col::NarrowphaseFactory<CFG>* narrowphase_factory_;
+
+  // Holds the collisions' points, it must outlive collisions_cache_.
+  ContactPool<CFG> contact_pool_;
   col::CollisionCache<CFG> collisions_cache_;
+
+  // Optional, the narrowphase runs serially without it.
+  ThreadPool* thread_pool_;
+
+  ManifoldReuse manifold_reuse;
+
+ private:
+  // Scratch data for updateNarrowphase(), kept around to avoid reallocating
+  // every frame.
+  std::vector<col::CollisionCacheEntry<CFG>*> narrowphase_queue_;
+  std::vector<std::size_t> narrowphase_chunks_;
+
+  void processEntry_(col::CollisionCacheEntry<CFG>* entry) {
+    // update existing contacts before adding any new ones. Resting objects
+    // keep the same transform, and so do their contacts.
+    if(entry->collision.needsRefresh()) {
+      entry->collision.refresh();
+    }
+
+    if(!manifold_reuse.enabled) {
+      entry->narrowphase_->process(&entry->collision);
+      return;
+    }
+
+    if(entry->collision.canReuseManifold(manifold_reuse.max_translation,
+                                         manifold_reuse.max_rotation)) {
+      return;
+    }
+    entry->narrowphase_->process(&entry->collision);
+    entry->collision.recordManifoldPose(entry->narrowphase_->oneShot());
+  }
 };
 
 template <typename CFG, typename BROADPHASE_T>
@@ -66,8 +171,10 @@ struct BP_CollisionWorld : public CollisionWorld<CFG> {
   using BP_Object = col::BP_Object<CFG, BROADPHASE_T>;
 
   BP_CollisionWorld(uint32_t object_count_hint,
-                    col::NarrowphaseFactory<CFG>* np_factory)
-      : CollisionWorld<CFG>(np_factory), broadphase_(object_count_hint) {}
+                    col::NarrowphaseFactory<CFG>* np_factory,
+                    ThreadPool* thread_pool = nullptr)
+      : CollisionWorld<CFG>(np_factory, thread_pool),
+        broadphase_(object_count_hint) {}
 
   void add(BP_Object* obj) {
     obj->world_index_ = uint32_t(objects_.size());
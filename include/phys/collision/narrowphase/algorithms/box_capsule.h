@@ -0,0 +1,136 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_BOX_CAPSULE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_BOX_CAPSULE_H
+
+#include <algorithm>
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/math_types/closest_points.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class BoxCapsule : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = BOX_SHAPE,
+    rhs_type = CAPSULE_SHAPE,
+  };
+
+  // Finds both ends of the capsule at once.
+  bool oneShot() const override {
+    return true;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto box_obj = result->objects[0];
+    auto capsule_obj = result->objects[1];
+
+    shapes::Box<CFG> const* box_shape =
+        static_cast<shapes::Box<CFG> const*>(box_obj->shape);
+    shapes::Capsule<CFG> const* capsule_shape =
+        static_cast<shapes::Capsule<CFG> const*>(capsule_obj->shape);
+
+    auto const& box_trans = box_obj->transform;
+    auto half_extent = box_shape->getHalfExtent();
+    auto radius = capsule_shape->getRadius();
+
+    // Everything happens in the box's space.
+    vec3_t ends[2];
+    capsule_shape->getSegment(capsule_obj->transform, &ends[0], &ends[1]);
+    ends[0] = box_trans.applyInverse(ends[0]);
+    ends[1] = box_trans.applyInverse(ends[1]);
+
+    real_t t;
+    real_t dist_sq =
+        closestPointSegmentBox<CFG>(half_extent, ends[0], ends[1], &t);
+
+    if(dist_sq <= std::numeric_limits<real_t>::epsilon()) {
+      processDeepPenetration_(result, half_extent, ends, radius);
+      return;
+    }
+
+    vec3_t on_segment = ends[0] + (ends[1] - ends[0]) * t;
+    real_t dist = addBoxContact_(result, half_extent, on_segment, radius);
+
+    // A capsule lying on a face touches it along a line, so also try both
+    // ends to get a stable manifold right away.
+    if(dist < result->getContactDistance()) {
+      for(auto const& end : ends) {
+        addBoxContact_(result, half_extent, end, radius);
+      }
+    } else {
+      result->setSeparation(dist);
+    }
+  }
+
+ private:
+  // Adds a contact between the box and a sphere of the capsule, centered
+  // outside of the box. Positions are in box space.
+  static real_t addBoxContact_(Collision<CFG>* result,
+                               vec3_t const& half_extent, vec3_t const& center,
+                               real_t radius) {
+    vec3_t on_box = clamp(center, -half_extent, half_extent);
+    vec3_t delta = on_box - center;
+    real_t len_sq = dot(delta, delta);
+    if(len_sq <= std::numeric_limits<real_t>::epsilon()) {
+      // Inside the box, the deep penetration path takes care of these.
+      return -radius;
+    }
+
+    real_t len = sqrt(len_sq);
+    real_t dist = len - radius;
+    if(dist < result->getContactDistance()) {
+      auto const& box_trans = result->objects[0]->transform;
+      vec3_t normal = delta / len;
+
+      addContact(*result, box_trans.getRotationMatrix() * normal,
+                 box_trans.applyToVec(center + normal * radius), dist);
+    }
+    return dist;
+  }
+
+  // The capsule's segment goes through the box. Push the capsule out along
+  // the box face that requires the least motion.
+  static void processDeepPenetration_(Collision<CFG>* result,
+                                      vec3_t const& half_extent,
+                                      vec3_t const* ends, real_t radius) {
+    int best_axis = 0;
+    real_t best_sign = 1;
+    real_t best_depth = std::numeric_limits<real_t>::max();
+    for(int axis = 0; axis < 3; ++axis) {
+      for(real_t sign : {real_t(-1), real_t(1)}) {
+        real_t lowest = std::min(ends[0][axis] * sign, ends[1][axis] * sign);
+        real_t depth = half_extent[axis] - lowest;
+        if(depth < best_depth) {
+          best_depth = depth;
+          best_axis = axis;
+          best_sign = sign;
+        }
+      }
+    }
+
+    auto const& box_trans = result->objects[0]->transform;
+
+    // The normal points from the capsule towards the box.
+    vec3_t normal = {0, 0, 0};
+    normal[best_axis] = -best_sign;
+    vec3_t ws_normal = box_trans.getRotationMatrix() * normal;
+
+    for(int i = 0; i < 2; ++i) {
+      real_t height = ends[i][best_axis] * best_sign - half_extent[best_axis];
+      real_t dist = height - radius;
+      if(dist < result->getContactDistance()) {
+        addContact(*result, ws_normal,
+                   box_trans.applyToVec(ends[i] + normal * radius), dist);
+      }
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_BOX_PLANE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_BOX_PLANE_H
+
+#include <algorithm>
+#include <array>
+#include "phys/collision/narrowphase/narrowphase.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class BoxPlane : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = BOX_SHAPE,
+    rhs_type = AXIS_ALIGNED_PLANE_SHAPE,
+  };
+
+  // Finds all the touching corners at once.
+  bool oneShot() const override {
+    return true;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto box_obj = result->objects[0];
+    auto plane_obj = result->objects[1];
+
+    // Infinite planes only work with identity transforms.
+    assert(plane_obj->transform == Transform<CFG>());
+
+    shapes::Box<CFG> const* box_shape =
+        static_cast<shapes::Box<CFG> const*>(box_obj->shape);
+    shapes::AxisAlignedPlane<CFG> const* plane_shape =
+        static_cast<shapes::AxisAlignedPlane<CFG> const*>(plane_obj->shape);
+
+    auto normal = plane_shape->getNormal();
+    auto plane_d = plane_shape->getDistance();
+
+    auto const& box_trans = box_obj->transform;
+    auto const& rot = box_trans.getRotationMatrix();
+    auto half_extent = box_shape->getHalfExtent();
+
+    // The height of every corner is the height of the center, plus or minus
+    // the half extent along each axis.
+    real_t center_height = dot(normal, box_trans.getTranslation()) - plane_d;
+    vec3_t axis_heights = {dot(normal, rot[0]) * half_extent[0],
+                           dot(normal, rot[1]) * half_extent[1],
+                           dot(normal, rot[2]) * half_extent[2]};
+
+    struct Corner {
+      vec3_t local;
+      real_t distance;
+    };
+    std::array<Corner, 8> corners;
+    for(int i = 0; i < 8; ++i) {
+      vec3_t sign = {i & 1 ? real_t(1) : real_t(-1),
+                     i & 2 ? real_t(1) : real_t(-1),
+                     i & 4 ? real_t(1) : real_t(-1)};
+      corners[i].local = half_extent * sign;
+      corners[i].distance = center_height + dot(axis_heights, sign);
+    }
+
+    // All the corners within reach are added at once, so that a box landing
+    // flat gets a full manifold right away. The deepest go first, the
+    // collision keeps them if there are more than it can hold.
+    std::sort(corners.begin(), corners.end(),
+              [](Corner const& lhs, Corner const& rhs) {
+                return lhs.distance < rhs.distance;
+              });
+
+    if(corners[0].distance >= result->getContactDistance()) {
+      result->setSeparation(corners[0].distance);
+      return;
+    }
+
+    int count = std::min<int>(8, CFG::max_contact_points_per_collision);
+    for(int i = 0; i < count; ++i) {
+      if(corners[i].distance >= result->getContactDistance()) {
+        break;
+      }
+
+      vec3_t corner = box_trans.applyToVec(corners[i].local);
+      addContact(*result, normal, corner - normal * corners[i].distance,
+                 corners[i].distance);
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_BOX_SPHERE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_BOX_SPHERE_H
+
+#include <algorithm>
+#include <cmath>
+#include "phys/collision/narrowphase/narrowphase.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class BoxSphere : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = BOX_SHAPE,
+    rhs_type = SPHERE_SHAPE,
+  };
+
+  std::size_t contactCapacity() const override {
+    return 1;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto box_obj = result->objects[0];
+    auto sphere_obj = result->objects[1];
+
+    shapes::Box<CFG> const* box_shape =
+        static_cast<shapes::Box<CFG> const*>(box_obj->shape);
+    shapes::Sphere<CFG> const* sphere_shape =
+        static_cast<shapes::Sphere<CFG> const*>(sphere_obj->shape);
+
+    auto const& box_trans = box_obj->transform;
+    auto const& rot = box_trans.getRotationMatrix();
+    auto half_extent = box_shape->getHalfExtent();
+    auto radius = sphere_shape->getRadius();
+
+    // Everything happens in the box's space.
+    vec3_t world_center = sphere_obj->transform.getTranslation();
+    vec3_t center = box_trans.applyInverse(world_center);
+    vec3_t on_box = clamp(center, -half_extent, half_extent);
+    vec3_t delta = center - on_box;
+    real_t len_sq = dot(delta, delta);
+
+    vec3_t normal;
+    real_t dist;
+    if(len_sq > std::numeric_limits<real_t>::epsilon()) {
+      real_t len = std::sqrt(len_sq);
+      dist = len - radius;
+      normal = -delta / len;
+    } else {
+      // The center is inside the box, push it out through the closest face.
+      int axis = 0;
+      real_t depth = std::numeric_limits<real_t>::max();
+      for(int i = 0; i < 3; ++i) {
+        real_t axis_depth = half_extent[i] - std::abs(center[i]);
+        if(axis_depth < depth) {
+          depth = axis_depth;
+          axis = i;
+        }
+      }
+      normal = {0, 0, 0};
+      normal[axis] = center[axis] < 0 ? real_t(1) : real_t(-1);
+      dist = -depth - radius;
+    }
+
+    if(dist >= result->getContactDistance()) {
+      result->setSeparation(dist);
+      return;
+    }
+
+    // The normal points from the sphere towards the box.
+    vec3_t ws_normal = rot * normal;
+    addContact(*result, ws_normal, world_center + ws_normal * radius, dist);
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CAPSULE_CAPSULE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_CAPSULE_CAPSULE_H
+
+#include <algorithm>
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/math_types/closest_points.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class CapsuleCapsule : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = CAPSULE_SHAPE,
+    rhs_type = CAPSULE_SHAPE,
+  };
+
+  // Finds both ends of parallel capsules at once.
+  bool oneShot() const override {
+    return true;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto capsule_a = result->objects[0];
+    auto capsule_b = result->objects[1];
+
+    shapes::Capsule<CFG> const* shape_a =
+        static_cast<shapes::Capsule<CFG> const*>(capsule_a->shape);
+    shapes::Capsule<CFG> const* shape_b =
+        static_cast<shapes::Capsule<CFG> const*>(capsule_b->shape);
+
+    real_t radius_a = shape_a->getRadius();
+    real_t radius_b = shape_b->getRadius();
+
+    vec3_t a[2], b[2];
+    shape_a->getSegment(capsule_a->transform, &a[0], &a[1]);
+    shape_b->getSegment(capsule_b->transform, &b[0], &b[1]);
+
+    // Intersecting cores have no meaningful direction, push them apart along
+    // the axis perpendicular to both.
+    vec3_t fallback = cross(a[1] - a[0], b[1] - b[0]);
+    real_t fallback_len = length(fallback);
+    if(fallback_len > std::numeric_limits<real_t>::epsilon()) {
+      fallback /= fallback_len;
+    } else {
+      fallback = capsule_b->transform.getRotationMatrix()[0];
+    }
+
+    real_t s, t;
+    closestPointsSegmentSegment<CFG>(a[0], a[1], b[0], b[1], &s, &t);
+    real_t min_dist = addSphereContact(
+        *result, a[0] + (a[1] - a[0]) * s, radius_a,
+        b[0] + (b[1] - b[0]) * t, radius_b, fallback);
+
+    // Capsules lying alongside each other touch along a line. Testing each
+    // endpoint against the other segment gives us both ends of that line
+    // right away, instead of building the manifold over several frames.
+    if(min_dist < result->getContactDistance()) {
+      for(auto const& end : a) {
+        real_t u = closestPointOnSegment<CFG>(b[0], b[1], end);
+        addSphereContact(*result, end, radius_a, b[0] + (b[1] - b[0]) * u,
+                         radius_b, fallback);
+      }
+      for(auto const& end : b) {
+        real_t u = closestPointOnSegment<CFG>(a[0], a[1], end);
+        addSphereContact(*result, a[0] + (a[1] - a[0]) * u, radius_a, end,
+                         radius_b, fallback);
+      }
+    } else {
+      result->setSeparation(min_dist);
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
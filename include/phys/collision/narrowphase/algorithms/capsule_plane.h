@@ -0,0 +1,72 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CAPSULE_PLANE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_CAPSULE_PLANE_H
+
+#include <algorithm>
+#include "phys/collision/narrowphase/narrowphase.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class CapsulePlane : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = CAPSULE_SHAPE,
+    rhs_type = AXIS_ALIGNED_PLANE_SHAPE,
+  };
+
+  // One point per end.
+  std::size_t contactCapacity() const override {
+    return 2;
+  }
+
+  // Finds both ends at once.
+  bool oneShot() const override {
+    return true;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto capsule_obj = result->objects[0];
+    auto plane_obj = result->objects[1];
+
+    // Infinite planes only work with identity transforms.
+    assert(plane_obj->transform == Transform<CFG>());
+
+    shapes::Capsule<CFG> const* capsule_shape =
+        static_cast<shapes::Capsule<CFG> const*>(capsule_obj->shape);
+    shapes::AxisAlignedPlane<CFG> const* plane_shape =
+        static_cast<shapes::AxisAlignedPlane<CFG> const*>(plane_obj->shape);
+
+    auto normal = plane_shape->getNormal();
+    auto plane_d = plane_shape->getDistance();
+    auto radius = capsule_shape->getRadius();
+
+    vec3_t ends[2];
+    capsule_shape->getSegment(capsule_obj->transform, &ends[0], &ends[1]);
+
+    // The deepest point of a capsule is always at one of its ends, and a
+    // capsule lying on the plane touches it with both.
+    real_t min_dist = std::numeric_limits<real_t>::max();
+    for(auto const& end : ends) {
+      real_t end_height = dot(normal, end) - plane_d;
+      real_t distance = end_height - radius;
+
+      if(distance < result->getContactDistance()) {
+        addContact(*result, normal, end - normal * end_height, distance);
+      }
+      min_dist = std::min(min_dist, distance);
+    }
+
+    if(min_dist >= result->getContactDistance()) {
+      result->setSeparation(min_dist);
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -1,23 +1,617 @@
 #ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_CONVEX_H
 #define PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_CONVEX_H
 
+#include <array>
+#include <cmath>
+#include <limits>
 #include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/util_types/static_vector.h"
 
 namespace phys {
 namespace col {
 namespace narrow {
+
+// Works on any two convex shapes, through their support mappings alone.
+//
+// GJK finds the points of the Minkowski difference of the shapes, a - b,
+// that are the closest to the origin, which are the closest points of the
+// shapes as long as they do not overlap. Once they do, the origin is inside
+// the difference, and EPA grows the simplex GJK stopped with until it finds
+// the face of the difference closest to the origin. That face's distance is
+// how deep the shapes overlap.
+//
+// A single point comes out of each run. The collision keeps the points of
+// the previous frames, which fills the manifold as the objects move around.
 template <typename CFG>
 class ConvexConvex : public Narrowphase<CFG> {
  public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+  using mat3x3_t = typename CFG::mat3x3_t;
+
   enum {
     lhs_type = CONVEX_SHAPE,
     rhs_type = CONVEX_SHAPE,
   };
 
-  void process(Collision<CFG>*) override {
-    assert(false);  // Implement me!
+  // Faces of the shapes' difference this close to its surface are on it,
+  // which ends EPA. Curved shapes need it that tight for the face's normal to
+  // be accurate, the iteration limit takes over when rounding errors get in
+  // the way.
+  real_t epa_tolerance = real_t(1e-6);
+
+  void process(Collision<CFG>* result) override {
+    Support_ support(result);
+
+    vec3_t start = result->objects[1]->transform.getTranslation() -
+                   result->objects[0]->transform.getTranslation();
+    if(dot(start, start) <= std::numeric_limits<real_t>::epsilon()) {
+      start = {1, 0, 0};
+    }
+
+    Simplex_ simplex;
+    simplex.vertices[0] = support(start);
+    simplex.weights[0] = 1;
+    simplex.size = 1;
+
+    real_t contact_dist = result->getContactDistance();
+    real_t touching_dist = touchingDist_();
+
+    // A step that gets the squared distance this little closer, relative to
+    // it, is as close as it gets.
+    real_t tolerance = real_t(1e-5);
+    vec3_t closest = simplex.vertices[0].w;
+    bool overlapping = false;
+    for(int i = 0; i < max_gjk_iterations; ++i) {
+      real_t closest_sq = dot(closest, closest);
+      if(closest_sq <= touching_dist * touching_dist) {
+        overlapping = true;
+        break;
+      }
+
+      // No point of the difference is much closer to the origin than the
+      // simplex already is along that direction.
+      Vertex_ vertex = support(-closest);
+      real_t progress = dot(closest, vertex.w);
+      if(closest_sq - progress <= tolerance * closest_sq ||
+         simplex.contains(vertex.w)) {
+        break;
+      }
+
+      // Nothing gets closer than progress along that direction, if that is
+      // already too far there is no need to go on.
+      if(progress > 0 && progress * progress > closest_sq * contact_dist *
+                                                  contact_dist) {
+        result->setSeparation(progress / std::sqrt(closest_sq));
+        return;
+      }
+
+      simplex.vertices[simplex.size++] = vertex;
+      if(!reduce_(&simplex)) {
+        overlapping = true;
+        break;
+      }
+      closest = simplex.point();
+    }
+
+    if(!overlapping) {
+      real_t dist = length(closest);
+      if(dist >= contact_dist) {
+        result->setSeparation(dist);
+      } else {
+        addContact(*result, closest / dist, simplex.pointOnB(), dist);
+      }
+      return;
+    }
+
+    vec3_t on_b = simplex.pointOnB();
+    if(!penetration_(support, simplex, result)) {
+      // The difference is too flat to find a way out of it, which only
+      // happens when the shapes barely touch.
+      addContact(*result, -normalize(start), on_b, real_t(0));
+    }
+  }
+
+ private:
+  enum {
+    max_gjk_iterations = 32,
+    max_epa_iterations = 64,
+    max_epa_vertices = max_epa_iterations + 4,
+    max_epa_faces = max_epa_vertices * 2,
+  };
+
+  // Below this, GJK cannot tell the direction between the shapes apart from
+  // rounding errors, and they are treated as overlapping.
+  static real_t touchingDist_() {
+    return real_t(1e-4);
+  }
+
+  // A point of the difference, along with the points of each shape it comes
+  // from.
+  struct Vertex_ {
+    vec3_t w;
+    vec3_t a;
+    vec3_t b;
+  };
+
+  // Support mapping of the difference of the collision's shapes.
+  class Support_ {
+   public:
+    explicit Support_(Collision<CFG>* result) : result_(result) {
+      for(int side = 0; side < 2; ++side) {
+        shapes_[side] = static_cast<shapes::Convex<CFG> const*>(
+            result->objects[side]->shape);
+        to_local_[side] =
+            transpose(result->objects[side]->transform.getRotationMatrix());
+      }
+    }
+
+    Vertex_ operator()(vec3_t const& direction) {
+      // Spheres and capsules scale the direction by their radius.
+      vec3_t unit = normalize(direction);
+
+      Vertex_ result;
+      result.a = vertex_(0, unit);
+      result.b = vertex_(1, -unit);
+      result.w = result.a - result.b;
+      return result;
+    }
+
+   private:
+    Collision<CFG>* result_;
+    std::array<shapes::Convex<CFG> const*, 2> shapes_;
+    std::array<mat3x3_t, 2> to_local_;
+
+    vec3_t vertex_(int side, vec3_t const& direction) {
+      vec3_t local = shapes_[side]->getSupportingVertexWithHint(
+          to_local_[side] * direction, &result_->support_hints_[side]);
+      return result_->objects[side]->transform.applyToVec(local);
+    }
+  };
+
+  // The point closest to the origin is the weighted sum of the vertices.
+  struct Simplex_ {
+    std::array<Vertex_, 4> vertices;
+    std::array<real_t, 4> weights;
+    int size = 0;
+
+    vec3_t point() const {
+      vec3_t result = {0, 0, 0};
+      for(int i = 0; i < size; ++i) {
+        result += vertices[i].w * weights[i];
+      }
+      return result;
+    }
+
+    vec3_t pointOnB() const {
+      vec3_t result = {0, 0, 0};
+      for(int i = 0; i < size; ++i) {
+        result += vertices[i].b * weights[i];
+      }
+      return result;
+    }
+
+    bool contains(vec3_t const& w) const {
+      for(int i = 0; i < size; ++i) {
+        vec3_t d = vertices[i].w - w;
+        if(dot(d, d) <= std::numeric_limits<real_t>::epsilon()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Drops the vertices that do not contribute to the closest point.
+    void compact() {
+      int count = 0;
+      for(int i = 0; i < size; ++i) {
+        if(weights[i] > 0) {
+          vertices[count] = vertices[i];
+          weights[count] = weights[i];
+          ++count;
+        }
+      }
+      size = count;
+    }
+  };
+
+  // Finds the point of the simplex closest to the origin, and keeps only the
+  // vertices of the feature it lies on. Returns false if the simplex is a
+  // tetrahedron holding the origin.
+  static bool reduce_(Simplex_* simplex) {
+    auto const& v = simplex->vertices;
+    switch(simplex->size) {
+      case 2: {
+        vec3_t ab = v[1].w - v[0].w;
+        real_t len_sq = dot(ab, ab);
+        real_t t = len_sq > std::numeric_limits<real_t>::epsilon()
+                       ? -dot(v[0].w, ab) / len_sq
+                       : real_t(0);
+        t = std::min(std::max(t, real_t(0)), real_t(1));
+        simplex->weights[0] = 1 - t;
+        simplex->weights[1] = t;
+        break;
+      }
+      case 3:
+        closestOnTriangle_(v[0].w, v[1].w, v[2].w, &simplex->weights[0]);
+        break;
+      case 4:
+        if(!closestOnTetrahedron_(simplex)) {
+          return false;
+        }
+        break;
+    }
+    simplex->compact();
+    return true;
+  }
+
+  // Writes the barycentric coordinates of the point of triangle (a, b, c)
+  // closest to the origin in weights, see Ericson's Real-Time Collision
+  // Detection, 5.1.5.
+  static void closestOnTriangle_(vec3_t const& a, vec3_t const& b,
+                                 vec3_t const& c, real_t* weights) {
+    auto set = [weights](real_t u, real_t v, real_t w) {
+      weights[0] = u;
+      weights[1] = v;
+      weights[2] = w;
+    };
+
+    vec3_t ab = b - a;
+    vec3_t ac = c - a;
+    real_t d1 = -dot(ab, a);
+    real_t d2 = -dot(ac, a);
+    if(d1 <= 0 && d2 <= 0) {
+      return set(1, 0, 0);
+    }
+
+    real_t d3 = -dot(ab, b);
+    real_t d4 = -dot(ac, b);
+    if(d3 >= 0 && d4 <= d3) {
+      return set(0, 1, 0);
+    }
+
+    real_t vc = d1 * d4 - d3 * d2;
+    if(vc <= 0 && d1 >= 0 && d3 <= 0) {
+      real_t t = d1 / (d1 - d3);
+      return set(1 - t, t, 0);
+    }
+
+    real_t d5 = -dot(ab, c);
+    real_t d6 = -dot(ac, c);
+    if(d6 >= 0 && d5 <= d6) {
+      return set(0, 0, 1);
+    }
+
+    real_t vb = d5 * d2 - d1 * d6;
+    if(vb <= 0 && d2 >= 0 && d6 <= 0) {
+      real_t t = d2 / (d2 - d6);
+      return set(1 - t, 0, t);
+    }
+
+    real_t va = d3 * d6 - d5 * d4;
+    if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+      real_t t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+      return set(0, 1 - t, t);
+    }
+
+    real_t denom = va + vb + vc;
+    if(denom <= std::numeric_limits<real_t>::epsilon()) {
+      // Degenerate, the closest vertex will do.
+      real_t da = dot(a, a);
+      real_t db = dot(b, b);
+      real_t dc = dot(c, c);
+      if(da <= db && da <= dc) {
+        return set(1, 0, 0);
+      }
+      return db <= dc ? set(0, 1, 0) : set(0, 0, 1);
+    }
+
+    real_t v = vb / denom;
+    real_t w = vc / denom;
+    set(1 - v - w, v, w);
+  }
+
+  // Same as above, on each face that has the origin on its outer side.
+  static bool closestOnTetrahedron_(Simplex_* simplex) {
+    auto const& v = simplex->vertices;
+    real_t best_sq = std::numeric_limits<real_t>::max();
+    std::array<real_t, 4> best_weights;
+    bool outside = false;
+
+    // Each face, with the vertex it leaves out last.
+    static int const faces[4][4] = {
+        {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+    for(auto const& face : faces) {
+      vec3_t a = v[face[0]].w;
+      vec3_t b = v[face[1]].w;
+      vec3_t c = v[face[2]].w;
+      vec3_t n = cross(b - a, c - a);
+      if(dot(n, -a) * dot(n, v[face[3]].w - a) >= 0) {
+        continue;
+      }
+      outside = true;
+
+      real_t tri_weights[3];
+      closestOnTriangle_(a, b, c, tri_weights);
+      vec3_t p = a * tri_weights[0] + b * tri_weights[1] + c * tri_weights[2];
+      real_t dist_sq = dot(p, p);
+      if(dist_sq < best_sq) {
+        best_sq = dist_sq;
+        best_weights = {{0, 0, 0, 0}};
+        for(int i = 0; i < 3; ++i) {
+          best_weights[face[i]] = tri_weights[i];
+        }
+      }
+    }
+
+    if(!outside) {
+      return false;
+    }
+    simplex->weights = best_weights;
+    return true;
+  }
+
+  struct Face_ {
+    std::array<int, 3> vertices;
+    vec3_t normal;
+    real_t dist;
+  };
+
+  struct Edge_ {
+    int from;
+    int to;
+  };
+
+  using EpaVertices_ = StaticVector<Vertex_, max_epa_vertices>;
+  using EpaFaces_ = StaticVector<Face_, max_epa_faces>;
+
+  // Faces are wound counter-clockwise seen from outside of the polytope.
+  // Returns false if the face is too thin to have a normal.
+  static bool makeFace_(EpaVertices_& vertices, int a, int b, int c,
+                        Face_* face) {
+    vec3_t normal = cross(vertices[b].w - vertices[a].w,
+                          vertices[c].w - vertices[a].w);
+    real_t len = length(normal);
+    if(len <= std::numeric_limits<real_t>::epsilon()) {
+      return false;
+    }
+
+    face->vertices = {{a, b, c}};
+    face->normal = normal / len;
+    face->dist = dot(face->normal, vertices[a].w);
+    return true;
+  }
+
+  // Grows the simplex GJK ended with into a tetrahedron. GJK stops early
+  // when the shapes touch, with the origin on a vertex, edge or face of the
+  // simplex.
+  static bool fillTetrahedron_(Support_& support, Simplex_* simplex) {
+    auto& v = simplex->vertices;
+    auto try_add = [&](vec3_t const& direction, auto const& accept) {
+      Vertex_ vertex = support(direction);
+      if(accept(vertex.w)) {
+        v[simplex->size++] = vertex;
+        return true;
+      }
+      return false;
+    };
+
+    real_t eps = std::numeric_limits<real_t>::epsilon();
+    if(simplex->size == 1) {
+      auto distinct = [&](vec3_t const& w) {
+        vec3_t d = w - v[0].w;
+        return dot(d, d) > eps;
+      };
+      static vec3_t const axes[] = {{1, 0, 0},  {-1, 0, 0}, {0, 1, 0},
+                                    {0, -1, 0}, {0, 0, 1},  {0, 0, -1}};
+      for(auto const& axis : axes) {
+        if(try_add(axis, distinct)) {
+          break;
+        }
+      }
+    }
+
+    if(simplex->size == 2) {
+      vec3_t line = normalize(v[1].w - v[0].w);
+      auto off_line = [&](vec3_t const& w) {
+        vec3_t d = cross(w - v[0].w, line);
+        return dot(d, d) > eps;
+      };
+
+      // Around the line, every 60 degrees.
+      vec3_t axis = std::abs(line[0]) < real_t(0.57) ? vec3_t{1, 0, 0}
+                                                     : vec3_t{0, 1, 0};
+      vec3_t tangent = normalize(cross(line, axis));
+      vec3_t bitangent = cross(line, tangent);
+      for(int i = 0; i < 6; ++i) {
+        real_t angle = real_t(i) * real_t(1.0471976);
+        vec3_t direction =
+            tangent * std::cos(angle) + bitangent * std::sin(angle);
+        if(try_add(direction, off_line)) {
+          break;
+        }
+      }
+    }
+
+    if(simplex->size == 3) {
+      vec3_t normal = cross(v[1].w - v[0].w, v[2].w - v[0].w);
+      vec3_t unit = normalize(normal);
+      auto off_plane = [&](vec3_t const& w) {
+        return std::abs(dot(unit, w - v[0].w)) > touchingDist_();
+      };
+      if(!try_add(normal, off_plane)) {
+        try_add(-normal, off_plane);
+      }
+    }
+
+    return simplex->size == 4;
+  }
+
+  // Adds the contact of overlapping shapes, found through EPA.
+  bool penetration_(Support_& support, Simplex_& simplex,
+                    Collision<CFG>* result) const {
+    if(!fillTetrahedron_(support, &simplex)) {
+      return false;
+    }
+
+    EpaVertices_ vertices;
+    for(int i = 0; i < 4; ++i) {
+      vertices.emplace_back(simplex.vertices[i]);
+    }
+
+    // Winds each face of the tetrahedron away from the vertex it leaves
+    // out.
+    EpaFaces_ faces;
+    static int const tetrahedron[4][4] = {
+        {0, 1, 2, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {1, 3, 2, 0}};
+    for(auto const& f : tetrahedron) {
+      Face_ face;
+      if(!makeFace_(vertices, f[0], f[1], f[2], &face)) {
+        return false;
+      }
+      if(dot(face.normal, vertices[f[3]].w) > face.dist) {
+        if(!makeFace_(vertices, f[0], f[2], f[1], &face)) {
+          return false;
+        }
+      }
+      faces.emplace_back(face);
+    }
+
+    // Expanding the polytope replaces the closest face, so it is picked
+    // again after each expansion, including the last one the iteration
+    // limit allows.
+    std::size_t best = closestFace_(faces);
+    for(int i = 0; i < max_epa_iterations; ++i) {
+      Face_ const& closest = faces[best];
+      Vertex_ vertex = support(closest.normal);
+      if(dot(vertex.w, closest.normal) - closest.dist <= epa_tolerance ||
+         vertices.full()) {
+        break;
+      }
+
+      if(!expand_(vertices, faces, vertex)) {
+        break;
+      }
+      best = closestFace_(faces);
+    }
+
+    // The origin, projected on the face, is where the shapes are the
+    // deepest into each other.
+    Face_ const& face = faces[best];
+    vec3_t on_face = face.normal * face.dist;
+    auto const& a = vertices[face.vertices[0]];
+    auto const& b = vertices[face.vertices[1]];
+    auto const& c = vertices[face.vertices[2]];
+    std::array<real_t, 3> weights =
+        barycentric_(a.w, b.w, c.w, on_face);
+    vec3_t on_b = a.b * weights[0] + b.b * weights[1] + c.b * weights[2];
+
+    // Moving the first shape against the face's normal separates them.
+    addContact(*result, -face.normal, on_b, -face.dist);
+    return true;
+  }
+
+  static std::size_t closestFace_(EpaFaces_ const& faces) {
+    std::size_t best = 0;
+    for(std::size_t f = 1; f < faces.size(); ++f) {
+      if(faces[f].dist < faces[best].dist) {
+        best = f;
+      }
+    }
+    return best;
+  }
+
+  // Replaces the faces that vertex sees by new ones joining it to their
+  // outline. Returns false, leaving the polytope as is, if there is no room
+  // for them or they would be too thin.
+  static bool expand_(EpaVertices_& vertices, EpaFaces_& faces,
+                      Vertex_ const& vertex) {
+    std::array<bool, max_epa_faces> visible;
+    StaticVector<Edge_, max_epa_faces> horizon;
+    std::size_t visible_count = 0;
+    for(std::size_t f = 0; f < faces.size(); ++f) {
+      auto const& face = faces[f];
+      visible[f] = dot(face.normal, vertex.w - vertices[face.vertices[0]].w) >
+                   0;
+      if(!visible[f]) {
+        continue;
+      }
+      ++visible_count;
+
+      // Edges shared by two visible faces are inside the area being
+      // replaced, the others outline it.
+      for(int e = 0; e < 3; ++e) {
+        Edge_ edge = {face.vertices[e], face.vertices[(e + 1) % 3]};
+        bool shared = false;
+        for(std::size_t h = 0; h < horizon.size(); ++h) {
+          if(horizon[h].from == edge.to && horizon[h].to == edge.from) {
+            horizon[h] = horizon[horizon.size() - 1];
+            horizon.pop_back();
+            shared = true;
+            break;
+          }
+        }
+        if(!shared) {
+          if(horizon.full()) {
+            return false;
+          }
+          horizon.emplace_back(edge);
+        }
+      }
+    }
+
+    if(faces.size() - visible_count + horizon.size() > max_epa_faces) {
+      return false;
+    }
+
+    int index = int(vertices.size());
+    vertices.emplace_back(vertex);
+
+    StaticVector<Face_, max_epa_faces> added;
+    for(auto const& edge : horizon) {
+      Face_ face;
+      if(!makeFace_(vertices, edge.from, edge.to, index, &face)) {
+        vertices.pop_back();
+        return false;
+      }
+      added.emplace_back(face);
+    }
+
+    std::size_t kept = 0;
+    for(std::size_t f = 0; f < faces.size(); ++f) {
+      if(!visible[f]) {
+        faces[kept++] = faces[f];
+      }
+    }
+    while(faces.size() > kept) {
+      faces.pop_back();
+    }
+    for(auto const& face : added) {
+      faces.emplace_back(face);
+    }
+    return true;
+  }
+
+  // Barycentric coordinates of p, which lies in the plane of triangle
+  // (a, b, c).
+  static std::array<real_t, 3> barycentric_(vec3_t const& a, vec3_t const& b,
+                                            vec3_t const& c, vec3_t const& p) {
+    vec3_t v0 = b - a;
+    vec3_t v1 = c - a;
+    vec3_t v2 = p - a;
+    real_t d00 = dot(v0, v0);
+    real_t d01 = dot(v0, v1);
+    real_t d11 = dot(v1, v1);
+    real_t d20 = dot(v2, v0);
+    real_t d21 = dot(v2, v1);
+    real_t denom = d00 * d11 - d01 * d01;
+
+    real_t v = (d11 * d20 - d01 * d21) / denom;
+    real_t w = (d00 * d21 - d01 * d20) / denom;
+    return {{1 - v - w, v, w}};
   }
 };
+
 }
 }
 }
@@ -0,0 +1,103 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_HULL_PLANE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_HULL_PLANE_H
+
+#include <algorithm>
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/util_types/static_vector.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class ConvexHullPlane : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = CONVEX_HULL_SHAPE,
+    rhs_type = AXIS_ALIGNED_PLANE_SHAPE,
+
+    // Bounds how much of the hull is explored around its deepest vertex.
+    max_explored_vertices = 64,
+  };
+
+  // Finds the whole touching patch at once.
+  bool oneShot() const override {
+    return true;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto hull_obj = result->objects[0];
+    auto plane_obj = result->objects[1];
+
+    // Infinite planes only work with identity transforms.
+    assert(plane_obj->transform == Transform<CFG>());
+
+    shapes::ConvexHull<CFG> const* hull_shape =
+        static_cast<shapes::ConvexHull<CFG> const*>(hull_obj->shape);
+    shapes::AxisAlignedPlane<CFG> const* plane_shape =
+        static_cast<shapes::AxisAlignedPlane<CFG> const*>(plane_obj->shape);
+
+    auto normal = plane_shape->getNormal();
+    auto plane_d = plane_shape->getDistance();
+
+    auto const& hull_trans = hull_obj->transform;
+    vec3_t local_normal = transpose(hull_trans.getRotationMatrix()) * normal;
+    real_t center_height = dot(normal, hull_trans.getTranslation()) - plane_d;
+    auto height = [&](uint32_t index) {
+      return center_height + dot(local_normal, hull_shape->getVertex(index));
+    };
+
+    // The support mapping leaves the deepest vertex's index in the hint.
+    uint32_t& deepest = result->support_hints_[0];
+    hull_shape->getSupportingVertexWithHint(-local_normal, &deepest);
+
+    real_t contact_dist = result->getContactDistance();
+    real_t deepest_dist = height(deepest);
+    if(deepest_dist >= contact_dist) {
+      result->setSeparation(deepest_dist);
+      return;
+    }
+
+    // The vertices within reach form a connected patch of the edge graph
+    // around the deepest one, such as the face the hull rests on. Adding
+    // them all at once gives a full manifold right away.
+    StaticVector<Vertex_, max_explored_vertices> patch;
+    patch.emplace_back(Vertex_{deepest, deepest_dist});
+    for(std::size_t i = 0; i < patch.size() && !patch.full(); ++i) {
+      auto current = patch[i].index;
+      for(auto n = hull_shape->neighborsBegin(current);
+          n != hull_shape->neighborsEnd(current) && !patch.full(); ++n) {
+        bool known = std::any_of(
+            patch.begin(), patch.end(),
+            [n](Vertex_ const& vertex) { return vertex.index == *n; });
+        real_t dist = height(*n);
+        if(!known && dist < contact_dist) {
+          patch.emplace_back(Vertex_{*n, dist});
+        }
+      }
+    }
+
+    // Faces can have more vertices than the collision holds. It keeps the
+    // deepest point and the most spread out ones, so the order only matters
+    // for the deepest, which goes first.
+    for(std::size_t i = 0; i < patch.size(); ++i) {
+      vec3_t vertex =
+          hull_trans.applyToVec(hull_shape->getVertex(patch[i].index));
+      addContact(*result, normal, vertex - normal * patch[i].distance,
+                 patch[i].distance);
+    }
+  }
+
+ private:
+  struct Vertex_ {
+    uint32_t index;
+    real_t distance;
+  };
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -1,5 +1,5 @@
-#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_BOX_PLANE_H
-#define PHYS_COL_NARROWPHASE_ALGORITHM_BOX_PLANE_H
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_PLANE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_PLANE_H
 
 #include "phys/collision/narrowphase/narrowphase.h"
 
@@ -37,8 +37,8 @@ class ConvexPlane : public Narrowphase<CFG> {
 
     vec3_t normal_in_object_space =
         plane_to_convex.getRotationMatrix() * -normal;
-    vec3_t convex_support =
-        convex_shape->getSupportingVertex(normal_in_object_space);
+    vec3_t convex_support = convex_shape->getSupportingVertexWithHint(
+        normal_in_object_space, &result->support_hints_[0]);
 
     vec3_t vertex_in_plane = convex_to_plane.applyToVec(convex_support);
     real_t distance = dot(normal, vertex_in_plane) - plane_d;
@@ -47,6 +47,8 @@ class ConvexPlane : public Narrowphase<CFG> {
 
     if(distance < result->getContactDistance()) {
       addContact(*result, normal, vtx_in_plane_projected, distance);
+    } else {
+      result->setSeparation(distance);
     }
   }
 };
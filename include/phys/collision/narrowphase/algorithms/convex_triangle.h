@@ -0,0 +1,275 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_TRIANGLE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_TRIANGLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/math_types/closest_points.h"
+#include "phys/util_types/static_vector.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+
+// Generates contacts between a convex, the first object of a collision, and
+// individual triangles of the second object. Triangles are expressed in the
+// second object's local space.
+//
+// This is shared by the algorithms of the triangle-based shapes, which only
+// differ in how they find candidate triangles.
+template <typename CFG>
+class ConvexTriangleContacts {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+  using mat3x3_t = typename CFG::mat3x3_t;
+
+  // Args:
+  //   result: The collision to add contacts to.
+  //   solid_below: If false, triangles are one-sided and objects whose
+  //     center ends up behind one are ignored by it. If true, they are pushed
+  //     back up along the triangle's normal.
+  ConvexTriangleContacts(Collision<CFG>* result, bool solid_below)
+      : result_(result),
+        solid_below_(solid_below),
+        convex_shape_(
+            static_cast<shapes::Convex<CFG> const*>(result->objects[0]->shape)),
+        tri_trans_(result->objects[1]->transform) {
+    auto const& convex_trans = result->objects[0]->transform;
+
+    convex_to_local_rot_ =
+        transpose(tri_trans_.getRotationMatrix()) *
+        convex_trans.getRotationMatrix();
+    local_to_convex_rot_ = transpose(convex_to_local_rot_);
+    center_ = tri_trans_.applyInverse(convex_trans.getTranslation());
+
+    contact_dist_ = result->getContactDistance();
+    tolerance_sq_ = result->getMatchToleranceSq() * real_t(0.05 * 0.05);
+
+    // Triangles outside of the expanded query are at least that far, which
+    // lets us report a useful separation when nothing is nearby.
+    separation_ = std::max(contact_dist_,
+                           convex_shape_->getBoundingRadius() * real_t(0.25));
+    convex_shape_->getAabb(&query_,
+                           Transform<CFG>(convex_to_local_rot_, center_));
+    query_.min_bound -= vec3_t{separation_, separation_, separation_};
+    query_.max_bound += vec3_t{separation_, separation_, separation_};
+  }
+
+  // Bounds of the convex in the triangles' space, expanded by a margin.
+  Aabb<CFG> const& getQuery() const {
+    return query_;
+  }
+
+  void addTriangle(vec3_t const* tri) {
+    vec3_t normal = cross(tri[1] - tri[0], tri[2] - tri[0]);
+    real_t normal_len = length(normal);
+    if(normal_len <= std::numeric_limits<real_t>::epsilon()) {
+      return;
+    }
+    normal /= normal_len;
+
+    // One-sided triangles let objects that end up behind them get pushed
+    // through instead of trapped. Solid ones push them back up, but only the
+    // triangle right above the center knows where the surface is.
+    real_t center_height = dot(normal, center_ - tri[0]);
+    bool behind = center_height < 0;
+    if(behind) {
+      separation_known_ = false;
+      if(!solid_below_ || !isAbove_(tri, center_ - normal * center_height)) {
+        return;
+      }
+    }
+
+    // Against the triangle's plane first, this resolves most resting
+    // contacts.
+    vec3_t deepest = support_(-normal);
+    real_t face_dist = dot(normal, deepest - tri[0]);
+    if(face_dist >= contact_dist_) {
+      separation_ = std::min(separation_, face_dist);
+      return;
+    }
+
+    vec3_t projected = deepest - normal * face_dist;
+    vec3_t on_tri =
+        closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2], projected);
+    vec3_t outside = on_tri - projected;
+    if(behind || dot(outside, outside) <= tolerance_sq_) {
+      addContact_(normal, projected, face_dist);
+      if(!behind) {
+        addFaceNeighbours_(tri, normal);
+      }
+      return;
+    }
+
+    // The convex hangs over one of the triangle's edges or vertices. Use the
+    // direction from the closest feature to the convex's center.
+    vec3_t closest =
+        closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2], center_);
+    vec3_t axis = center_ - closest;
+    real_t axis_len = length(axis);
+    axis = axis_len > std::numeric_limits<real_t>::epsilon() ? axis / axis_len
+                                                             : normal;
+
+    // If the face still separates them the most, the edge is not the one
+    // supporting the convex, as happens for triangles it only partially
+    // covers on flat ground. The triangle under its deepest point takes care
+    // of it, but other vertices of the convex may lie on this one.
+    real_t dist = dot(axis, support_(-axis) - closest);
+    if(face_dist >= dist) {
+      separation_known_ = false;
+      addFaceNeighbours_(tri, normal);
+    } else if(dist < contact_dist_) {
+      addContact_(axis, closest, dist);
+    } else {
+      separation_ = std::min(separation_, dist);
+    }
+  }
+
+  // Submits the contacts, or reports the separation to the collision if
+  // none was found.
+  void finish() {
+    // Closest first, and no more than the collision can hold, so that the
+    // furthest ones do not get to replace them.
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](Candidate_ const& lhs, Candidate_ const& rhs) {
+                return lhs.dist < rhs.dist;
+              });
+
+    real_t margin = result_->getRestingMargin();
+    std::size_t count = std::min<std::size_t>(
+        candidates_.size(), CFG::max_contact_points_per_collision);
+    for(std::size_t i = 0; i < count; ++i) {
+      auto const& candidate = candidates_[i];
+      if(candidate.dist <= closest_ + margin) {
+        addContact(*result_, tri_trans_.getRotationMatrix() * candidate.normal,
+                   tri_trans_.applyToVec(candidate.on_triangle),
+                   candidate.dist);
+      }
+    }
+
+    if(!touching_ && separation_known_) {
+      result_->setSeparation(separation_);
+    }
+  }
+
+ private:
+  Collision<CFG>* result_;
+  bool solid_below_;
+  shapes::Convex<CFG> const* convex_shape_;
+  Transform<CFG> const& tri_trans_;
+
+  mat3x3_t convex_to_local_rot_;
+  mat3x3_t local_to_convex_rot_;
+  vec3_t center_;
+
+  real_t contact_dist_;
+
+  // How far outside of a triangle a point can be and still count as over it.
+  real_t tolerance_sq_;
+  Aabb<CFG> query_;
+
+  real_t separation_;
+  bool separation_known_ = true;
+  bool touching_ = false;
+
+  bool isAbove_(vec3_t const* tri, vec3_t const& on_plane) const {
+    vec3_t d = closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2], on_plane) -
+               on_plane;
+    return dot(d, d) <= tolerance_sq_;
+  }
+
+  vec3_t support_(vec3_t const& direction) {
+    vec3_t local = convex_shape_->getSupportingVertexWithHint(
+        local_to_convex_rot_ * direction, &result_->support_hints_[0]);
+    return convex_to_local_rot_ * local + center_;
+  }
+
+  // A single point per triangle lets a convex landing flat on it pivot
+  // around that point, which is too late to fix once fast bodies are only
+  // caught by speculative contacts. Tilting the support direction a bit
+  // finds the other vertices of the face lying on the triangle. Those that
+  // end up too far are dropped in finish().
+  void addFaceNeighbours_(vec3_t const* tri, vec3_t const& normal) {
+    // The directions are kept off the triangle's edges and diagonals, which
+    // boxes laid out on a grid tend to line up with.
+    vec3_t tangent = normalize(tri[1] - tri[0]) * real_t(0.1);
+    vec3_t bitangent = cross(normal, tangent);
+    vec3_t const offsets[] = {
+        tangent * real_t(0.866) + bitangent * real_t(0.5),
+        bitangent * real_t(0.866) - tangent * real_t(0.5),
+        -tangent * real_t(0.866) - bitangent * real_t(0.5),
+        tangent * real_t(0.5) - bitangent * real_t(0.866),
+    };
+    for(auto const& offset : offsets) {
+      vec3_t vertex = support_(offset - normal);
+      real_t dist = dot(normal, vertex - tri[0]);
+      if(dist >= contact_dist_) {
+        continue;
+      }
+
+      vec3_t projected = vertex - normal * dist;
+      vec3_t outside =
+          closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2], projected) -
+          projected;
+      if(dot(outside, outside) <= tolerance_sq_) {
+        addContact_(normal, projected, dist);
+      }
+    }
+  }
+
+  // Contacts are only submitted once every triangle has been looked at.
+  // Speculative contacts reach far, and all the triangles around the convex
+  // would otherwise report one. They tend to share the same point on the
+  // convex, and would replace each other in the collision regardless of
+  // which one is the closest.
+  struct Candidate_ {
+    vec3_t normal;
+    vec3_t on_triangle;
+    real_t dist;
+  };
+
+  StaticVector<Candidate_, CFG::max_contact_points_per_collision * 2>
+      candidates_;
+  real_t closest_ = std::numeric_limits<real_t>::max();
+
+  void addContact_(vec3_t const& normal, vec3_t const& on_triangle,
+                   real_t dist) {
+    touching_ = true;
+    closest_ = std::min(closest_, dist);
+
+    // Neighbouring triangles and tilted supports often land on the same
+    // point of the convex.
+    vec3_t on_convex = on_triangle + normal * dist;
+    for(auto& candidate : candidates_) {
+      vec3_t d = candidate.on_triangle + candidate.normal * candidate.dist -
+                 on_convex;
+      if(dot(d, d) < result_->getMatchToleranceSq()) {
+        if(dist < candidate.dist) {
+          candidate = Candidate_{normal, on_triangle, dist};
+        }
+        return;
+      }
+    }
+
+    if(!candidates_.full()) {
+      candidates_.emplace_back(Candidate_{normal, on_triangle, dist});
+      return;
+    }
+
+    auto furthest = std::max_element(
+        candidates_.begin(), candidates_.end(),
+        [](Candidate_ const& lhs, Candidate_ const& rhs) {
+          return lhs.dist < rhs.dist;
+        });
+    if(dist < furthest->dist) {
+      *furthest = Candidate_{normal, on_triangle, dist};
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
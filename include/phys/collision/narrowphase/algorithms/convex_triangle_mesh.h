@@ -0,0 +1,36 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_TRIANGLE_MESH_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_CONVEX_TRIANGLE_MESH_H
+
+#include "phys/collision/narrowphase/algorithms/convex_triangle.h"
+#include "phys/collision/narrowphase/narrowphase.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class ConvexTriangleMesh : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    lhs_type = CONVEX_SHAPE,
+    rhs_type = TRIANGLE_MESH_SHAPE,
+  };
+
+  void process(Collision<CFG>* result) override {
+    shapes::TriangleMesh<CFG> const* mesh_shape =
+        static_cast<shapes::TriangleMesh<CFG> const*>(
+            result->objects[1]->shape);
+
+    ConvexTriangleContacts<CFG> contacts(result, false);
+    mesh_shape->visitTriangles(
+        contacts.getQuery(),
+        [&](uint32_t, vec3_t const* tri) { contacts.addTriangle(tri); });
+    contacts.finish();
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
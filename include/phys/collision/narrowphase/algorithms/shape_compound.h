@@ -0,0 +1,242 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_SHAPE_COMPOUND_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_SHAPE_COMPOUND_H
+
+#include <algorithm>
+#include <unordered_map>
+#include "phys/collision/narrowphase/narrowphase.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+
+// Handles compounds against any shape, including other compounds. Every pair
+// of children whose bounds overlap gets its own collision and algorithm,
+// which persist across frames for as long as the children stay close, and
+// their contacts are merged into the pair's collision.
+//
+// The children's algorithms come from the factory. Since process() may run
+// on any thread, they are looked up without modifying it, and pairs of
+// children it has no algorithm for are skipped.
+template <typename CFG>
+class ShapeCompound : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = UNKNOWN_SHAPE,
+    rhs_type = COMPOUND_SHAPE,
+  };
+
+  explicit ShapeCompound(NarrowphaseFactory<CFG>* factory)
+      : factory_(factory) {}
+
+  bool statefull() const override {
+    return true;
+  }
+
+  std::unique_ptr<Narrowphase<CFG>> clone() const override {
+    return std::make_unique<ShapeCompound>(factory_);
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto obj_a = result->objects[0];
+    auto obj_b = result->objects[1];
+
+    shapes::Compound<CFG> const* compound_b =
+        static_cast<shapes::Compound<CFG> const*>(obj_b->shape);
+    shapes::Compound<CFG> const* compound_a = nullptr;
+    if(obj_a->shape->getShapeType() == COMPOUND_SHAPE) {
+      compound_a = static_cast<shapes::Compound<CFG> const*>(obj_a->shape);
+    }
+
+    ++frame_;
+
+    // Children pairs outside of the expanded queries are at least that far.
+    // Unbounded shapes, such as planes, would expand them without limit, so
+    // the compound's own size caps the margin.
+    real_t radius = std::min(obj_a->shape->getBoundingRadius(),
+                             compound_b->getBoundingRadius());
+    real_t margin =
+        std::max(result->getContactDistance(), radius * real_t(0.25));
+    separation_ = margin;
+    separation_known_ = true;
+
+    // Queries are clipped to the compound's own bounds first, so that
+    // unbounded shapes such as planes still end up with a finite query.
+    Aabb<CFG> b_bounds;
+    obj_b->getAabb(&b_bounds);
+
+    auto query = [&](uint32_t child_a, Shape<CFG> const* shape,
+                     Transform<CFG> const& transform) {
+      Aabb<CFG> bounds;
+      shape->getAabb(&bounds, transform);
+      bounds.min_bound =
+          max(bounds.min_bound - vec3_t{margin, margin, margin},
+              b_bounds.min_bound);
+      bounds.max_bound =
+          min(bounds.max_bound + vec3_t{margin, margin, margin},
+              b_bounds.max_bound);
+      for(int i = 0; i < 3; ++i) {
+        if(bounds.min_bound[i] > bounds.max_bound[i]) {
+          return;
+        }
+      }
+
+      compound_b->visitChildren(
+          toLocal_(bounds, obj_b->transform), [&](uint32_t child_b) {
+            processChildPair_(result, compound_a, child_a, compound_b,
+                              child_b);
+          });
+    };
+
+    if(compound_a) {
+      for(uint32_t i = 0; i < compound_a->getChildCount(); ++i) {
+        auto const& child = compound_a->getChild(i);
+        query(i, child.shape, obj_a->transform * child.transform);
+      }
+    } else {
+      query(0, obj_a->shape, obj_a->transform);
+    }
+
+    // Forget about children that moved apart.
+    for(auto pair = pairs_.begin(); pair != pairs_.end();) {
+      if(pair->second.frame != frame_) {
+        pair = pairs_.erase(pair);
+      } else {
+        ++pair;
+      }
+    }
+
+    if(result->points.size() == 0 && separation_known_) {
+      result->setSeparation(separation_);
+    }
+  }
+
+ private:
+  struct ChildPair_ {
+    // Stand-ins for the children, with their shape and world transform.
+    // proxies[0] belongs to the first object of the parent collision.
+    std::array<Object<CFG>, 2> proxies;
+
+    // Ordered by shape type, like any other collision.
+    Collision<CFG> collision;
+    bool flipped;
+
+    NarrowPhasePtr<CFG> narrowphase;
+    uint32_t frame;
+  };
+
+  // Bounds, in a transform's local space, of a world space aabb.
+  static Aabb<CFG> toLocal_(Aabb<CFG> const& world,
+                            Transform<CFG> const& transform) {
+    return Aabb<CFG>((world.min_bound + world.max_bound) * real_t(0.5),
+                     (world.max_bound - world.min_bound) * real_t(0.5),
+                     transform.inverse());
+  }
+
+  void processChildPair_(Collision<CFG>* result,
+                         shapes::Compound<CFG> const* compound_a,
+                         uint32_t child_a,
+                         shapes::Compound<CFG> const* compound_b,
+                         uint32_t child_b) {
+    auto obj_a = result->objects[0];
+    auto obj_b = result->objects[1];
+
+    uint64_t key = uint64_t(child_a) | (uint64_t(child_b) << 32);
+    auto found = pairs_.find(key);
+    if(found == pairs_.end()) {
+      found = pairs_.emplace(std::piecewise_construct, std::make_tuple(key),
+                             std::make_tuple())
+                  .first;
+      ChildPair_& created = found->second;
+
+      created.proxies[0].shape =
+          compound_a ? compound_a->getChild(child_a).shape : obj_a->shape;
+      created.proxies[1].shape = compound_b->getChild(child_b).shape;
+
+      created.flipped = created.proxies[0].shape->getShapeType() >
+                        created.proxies[1].shape->getShapeType();
+      int first = created.flipped ? 1 : 0;
+      created.collision.objects = {&created.proxies[first],
+                                   &created.proxies[1 - first]};
+
+      // This is the only place that dispatches on the children's types.
+      created.narrowphase =
+          factory_->findNarrowphase(created.collision.objects[0]->shape,
+                                    created.collision.objects[1]->shape);
+      if(created.narrowphase) {
+        created.collision.points.setCapacity(
+            created.narrowphase->contactCapacity(), &contact_pool_);
+      }
+    }
+
+    ChildPair_& pair = found->second;
+    pair.frame = frame_;
+
+    // Kept around all the same, so that the lookup is not repeated. Nothing
+    // is known about how far apart such children are.
+    if(!pair.narrowphase) {
+      separation_known_ = false;
+      return;
+    }
+
+    pair.proxies[0].transform =
+        compound_a ? obj_a->transform * compound_a->getChild(child_a).transform
+                   : obj_a->transform;
+    pair.proxies[1].transform =
+        obj_b->transform * compound_b->getChild(child_b).transform;
+
+    // Children move exactly as their parent does, so they take its sweep for
+    // their speculative contacts to reach as far, and its transform version
+    // to be refreshed whenever it moves.
+    for(int i = 0; i < 2; ++i) {
+      pair.proxies[i].sweep_ = result->objects[i]->sweep_;
+      pair.proxies[i].sweep_rotation_ = result->objects[i]->sweep_rotation_;
+      pair.proxies[i].transform_version_ =
+          result->objects[i]->transform_version_;
+    }
+
+    if(pair.collision.needsRefresh()) {
+      pair.collision.refresh();
+    }
+    pair.collision.setSeparation(0);
+    pair.narrowphase->process(&pair.collision);
+
+    if(pair.collision.points.size() == 0 &&
+       pair.collision.separation_ > 0) {
+      separation_ = std::min(separation_, pair.collision.separation_);
+    } else {
+      separation_known_ = false;
+    }
+
+    // Merging goes through addContact(), so the usual reduction keeps the
+    // most valuable points.
+    for(auto const& point : pair.collision.points) {
+      if(pair.flipped) {
+        addContact(*result, -point.ws_normal, point.ws_position[0],
+                   point.distance);
+      } else {
+        addContact(*result, point.ws_normal, point.ws_position[1],
+                   point.distance);
+      }
+    }
+  }
+
+  NarrowphaseFactory<CFG>* factory_;
+
+  // Holds the points of the children's collisions, it must outlive pairs_.
+  // The compound only runs on one thread at a time, and so does its pool.
+  ContactPool<CFG> contact_pool_;
+  std::unordered_map<uint64_t, ChildPair_> pairs_;
+  uint32_t frame_ = 0;
+
+  // Scratch for the current process() call.
+  real_t separation_;
+  bool separation_known_;
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_CAPSULE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_CAPSULE_H
+
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/math_types/closest_points.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class SphereCapsule : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = SPHERE_SHAPE,
+    rhs_type = CAPSULE_SHAPE,
+  };
+
+  std::size_t contactCapacity() const override {
+    return 1;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto sphere_obj = result->objects[0];
+    auto capsule_obj = result->objects[1];
+
+    shapes::Sphere<CFG> const* sphere_shape =
+        static_cast<shapes::Sphere<CFG> const*>(sphere_obj->shape);
+    shapes::Capsule<CFG> const* capsule_shape =
+        static_cast<shapes::Capsule<CFG> const*>(capsule_obj->shape);
+
+    vec3_t seg_0, seg_1;
+    capsule_shape->getSegment(capsule_obj->transform, &seg_0, &seg_1);
+
+    auto const& center = sphere_obj->transform.getTranslation();
+    real_t t = closestPointOnSegment<CFG>(seg_0, seg_1, center);
+    vec3_t on_segment = seg_0 + (seg_1 - seg_0) * t;
+
+    // If the sphere's center lies on the segment, push it out sideways.
+    vec3_t fallback = capsule_obj->transform.getRotationMatrix()[0];
+
+    real_t dist =
+        addSphereContact(*result, center, sphere_shape->getRadius(), on_segment,
+                         capsule_shape->getRadius(), fallback);
+    if(dist >= result->getContactDistance()) {
+      result->setSeparation(dist);
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_CONVEX_HULL_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_CONVEX_HULL_H
+
+#include <cmath>
+#include <limits>
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/math_types/closest_points.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class SphereConvexHull : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = SPHERE_SHAPE,
+    rhs_type = CONVEX_HULL_SHAPE,
+  };
+
+  std::size_t contactCapacity() const override {
+    return 1;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto sphere_obj = result->objects[0];
+    auto hull_obj = result->objects[1];
+
+    shapes::Sphere<CFG> const* sphere_shape =
+        static_cast<shapes::Sphere<CFG> const*>(sphere_obj->shape);
+    shapes::ConvexHull<CFG> const* hull_shape =
+        static_cast<shapes::ConvexHull<CFG> const*>(hull_obj->shape);
+
+    auto const& hull_trans = hull_obj->transform;
+    auto radius = sphere_shape->getRadius();
+
+    // Everything happens in the hull's space.
+    vec3_t center =
+        hull_trans.applyInverse(sphere_obj->transform.getTranslation());
+
+    vec3_t on_hull;
+    vec3_t normal;
+    real_t height = 0;
+    if(hull_shape->getFaceCount() > 0) {
+      // Walk the faces from the ones around the vertex furthest along the
+      // center's direction, it is next to the center's side of the hull.
+      vec3_t direction = center;
+      if(dot(direction, direction) <= std::numeric_limits<real_t>::epsilon()) {
+        direction = {0, 1, 0};
+      }
+      uint32_t& start = result->support_hints_[1];
+      hull_shape->getSupportingVertexWithHint(direction, &start);
+
+      // The center's height above the face it is the furthest in front of
+      // is a lower bound of its distance to the hull, and its depth when it
+      // is inside. Climbing to the highest face nearby finds it when outside.
+      // Inside, it finds the nearest face plane around where the center went
+      // in, which is the one that matters for shallow penetrations.
+      auto face_height = [&](uint32_t index) {
+        auto const& face = hull_shape->getFace(index);
+        return dot(face.normal, center) - face.distance;
+      };
+      uint32_t best_face = hull_shape->getVertexFace(start);
+      height = face_height(best_face);
+      climb_(hull_shape, &best_face, [&](uint32_t index, real_t* value) {
+        *value = face_height(index);
+        return true;
+      }, &height);
+
+      if(height - radius >= result->getContactDistance()) {
+        result->setSeparation(height - radius);
+        return;
+      }
+
+      if(height <= 0) {
+        normal = hull_shape->getFace(best_face).normal;
+        on_hull = center - normal * height;
+      } else {
+        // Outside, the closest point is on one of the faces the center is
+        // in front of, and these are connected to the highest one.
+        auto closest_on = [&](uint32_t index) {
+          auto const& face = hull_shape->getFace(index);
+          return closestPointOnTriangle<CFG>(
+              hull_shape->getVertex(face.vertices[0]),
+              hull_shape->getVertex(face.vertices[1]),
+              hull_shape->getVertex(face.vertices[2]), center);
+        };
+        on_hull = closest_on(best_face);
+        vec3_t delta = center - on_hull;
+        real_t neg_dist_sq = -dot(delta, delta);
+        climb_(hull_shape, &best_face, [&](uint32_t index, real_t* value) {
+          if(face_height(index) <= 0) {
+            return false;
+          }
+          vec3_t closest = closest_on(index);
+          vec3_t d = center - closest;
+          *value = -dot(d, d);
+          if(*value > neg_dist_sq) {
+            on_hull = closest;
+          }
+          return true;
+        }, &neg_dist_sq);
+      }
+    } else {
+      on_hull = closestOnDegenerate_(hull_shape, center);
+    }
+
+    if(hull_shape->getFaceCount() == 0 || height > 0) {
+      vec3_t delta = center - on_hull;
+      height = length(delta);
+      if(height <= std::numeric_limits<real_t>::epsilon()) {
+        // Touching a flat hull right at its surface, any direction will do.
+        normal = {0, 1, 0};
+      } else {
+        normal = delta / height;
+      }
+    }
+
+    real_t dist = height - radius;
+    if(dist >= result->getContactDistance()) {
+      result->setSeparation(dist);
+      return;
+    }
+
+    addContact(*result, hull_trans.getRotationMatrix() * normal,
+               hull_trans.applyToVec(on_hull), dist);
+  }
+
+ private:
+  // Moves *face to any face sharing a vertex with it that has a higher
+  // value, until none has. evaluate(index, &value) returns false for faces
+  // that must be left alone.
+  template <typename EVALUATE>
+  static void climb_(shapes::ConvexHull<CFG> const* hull, uint32_t* face,
+                     EVALUATE evaluate, real_t* best) {
+    bool moved = true;
+    while(moved) {
+      moved = false;
+      uint32_t current = *face;
+      auto const& current_face = hull->getFace(current);
+      for(auto vertex : current_face.vertices) {
+        // Turn around the vertex, crossing the edge that leads into it.
+        uint32_t index = current;
+        do {
+          auto const& around = hull->getFace(index);
+          int i = around.vertices[0] == vertex ? 0
+                  : around.vertices[1] == vertex ? 1 : 2;
+          index = around.neighbors[(i + 2) % 3];
+
+          real_t value;
+          if(index != current && evaluate(index, &value) && value > *best) {
+            *best = value;
+            *face = index;
+            moved = true;
+          }
+        } while(index != current);
+      }
+    }
+  }
+
+  // Flat, linear or single point hulls keep all of their points. Any point of
+  // their hull lies in a triangle made of the first vertex and two others, or
+  // on a segment between two vertices if they are all aligned. These hulls
+  // are small, so trying them all is fine.
+  static vec3_t closestOnDegenerate_(shapes::ConvexHull<CFG> const* hull,
+                                     vec3_t const& p) {
+    uint32_t count = uint32_t(hull->getVertexCount());
+    vec3_t origin = hull->getVertex(0);
+    vec3_t best = origin;
+    vec3_t delta = p - origin;
+    real_t best_dist_sq = dot(delta, delta);
+
+    auto consider = [&](vec3_t const& closest) {
+      vec3_t d = p - closest;
+      real_t dist_sq = dot(d, d);
+      if(dist_sq < best_dist_sq) {
+        best_dist_sq = dist_sq;
+        best = closest;
+      }
+    };
+
+    for(uint32_t i = 0; i < count; ++i) {
+      vec3_t a = hull->getVertex(i);
+      for(uint32_t j = i + 1; j < count; ++j) {
+        vec3_t b = hull->getVertex(j);
+        consider(a + (b - a) * closestPointOnSegment<CFG>(a, b, p));
+
+        vec3_t normal = cross(a - origin, b - origin);
+        if(i > 0 &&
+           dot(normal, normal) > std::numeric_limits<real_t>::epsilon()) {
+          consider(closestPointOnTriangle<CFG>(origin, a, b, p));
+        }
+      }
+    }
+    return best;
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_HEIGHTFIELD_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_HEIGHTFIELD_H
+
+#include <algorithm>
+#include "phys/collision/narrowphase/narrowphase.h"
+#include "phys/math_types/closest_points.h"
+#include "phys/util_types/static_vector.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class SphereHeightfield : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = SPHERE_SHAPE,
+    rhs_type = HEIGHTFIELD_SHAPE,
+  };
+
+  void process(Collision<CFG>* result) override {
+    auto sphere_obj = result->objects[0];
+    auto field_obj = result->objects[1];
+
+    shapes::Sphere<CFG> const* sphere_shape =
+        static_cast<shapes::Sphere<CFG> const*>(sphere_obj->shape);
+    shapes::Heightfield<CFG> const* field_shape =
+        static_cast<shapes::Heightfield<CFG> const*>(field_obj->shape);
+
+    auto const& field_trans = field_obj->transform;
+    auto const& field_rot = field_trans.getRotationMatrix();
+
+    vec3_t center =
+        field_trans.applyInverse(sphere_obj->transform.getTranslation());
+    real_t radius = sphere_shape->getRadius();
+    real_t contact_dist = result->getContactDistance();
+
+    // Cells outside of the expanded query are at least that far.
+    real_t margin = std::max(contact_dist, radius * real_t(0.25));
+    real_t reach = radius + margin;
+    Aabb<CFG> query;
+    query.min_bound = center - vec3_t{reach, reach, reach};
+    query.max_bound = center + vec3_t{reach, reach, reach};
+
+    real_t separation = margin;
+    bool separation_known = true;
+    bool touching = false;
+
+    // How far a point can be from a triangle and still count as on it.
+    real_t tolerance_sq = result->getMatchToleranceSq() * real_t(0.05 * 0.05);
+    StaticVector<EdgeContact_, CFG::max_contact_points_per_collision * 2>
+        edge_contacts;
+
+    field_shape->visitTriangles(query, [&](uint32_t, vec3_t const* tri) {
+      vec3_t normal = cross(tri[1] - tri[0], tri[2] - tri[0]);
+      real_t normal_len = length(normal);
+      if(normal_len <= std::numeric_limits<real_t>::epsilon()) {
+        return;
+      }
+      normal /= normal_len;
+      vec3_t tri_normal = normal;
+
+      vec3_t closest =
+          closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2], center);
+      real_t center_height = dot(normal, center - tri[0]);
+
+      real_t dist;
+      if(center_height < 0) {
+        // Sunk under the surface, only the triangle right above the center
+        // may push it back up.
+        separation_known = false;
+        vec3_t d = center - normal * center_height - closest;
+        if(dot(d, d) > tolerance_sq) {
+          return;
+        }
+        dist = center_height - radius;
+      } else {
+        vec3_t delta = center - closest;
+        real_t len = length(delta);
+        dist = len - radius;
+        if(dist >= contact_dist) {
+          separation = std::min(separation, dist);
+          return;
+        }
+
+        if(len > std::numeric_limits<real_t>::epsilon()) {
+          normal = delta / len;
+        }
+
+        vec3_t off_face = center - tri_normal * center_height - closest;
+        if(dot(off_face, off_face) > tolerance_sq && !edge_contacts.full()) {
+          edge_contacts.emplace_back(EdgeContact_{normal, closest, len, false});
+          touching = true;
+          return;
+        }
+      }
+
+      addContact(*result, field_rot * normal, field_trans.applyToVec(closest),
+                 dist);
+      touching = true;
+    });
+
+    // The closest point of a triangle can land on an edge it shares with
+    // another, such as the diagonal of a flat cell. If the other one has a
+    // closer point, the surface goes on past the edge, and a contact there
+    // would push the sphere sideways. On a ridge, both triangles find the
+    // same point, and it stays.
+    if(edge_contacts.size() > 0) {
+      real_t tolerance = std::sqrt(tolerance_sq);
+      field_shape->visitTriangles(query, [&](uint32_t, vec3_t const* tri) {
+        for(auto& edge : edge_contacts) {
+          vec3_t on_tri = closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2],
+                                                      edge.closest);
+          vec3_t d = on_tri - edge.closest;
+          if(dot(d, d) > tolerance_sq) {
+            continue;
+          }
+
+          vec3_t closest =
+              closestPointOnTriangle<CFG>(tri[0], tri[1], tri[2], center);
+          if(length(center - closest) < edge.len - tolerance) {
+            edge.hidden = true;
+          }
+        }
+      });
+
+      for(auto const& edge : edge_contacts) {
+        if(!edge.hidden) {
+          addContact(*result, field_rot * edge.normal,
+                     field_trans.applyToVec(edge.closest), edge.len - radius);
+        }
+      }
+    }
+
+    if(!touching && separation_known) {
+      result->setSeparation(separation);
+    }
+  }
+
+ private:
+  // A contact with a triangle's edge or vertex, in the heightfield's space.
+  struct EdgeContact_ {
+    vec3_t normal;
+    vec3_t closest;
+
+    // From the sphere's center.
+    real_t len;
+    bool hidden;
+  };
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_PLANE_H
+#define PHYS_COL_NARROWPHASE_ALGORITHM_SPHERE_PLANE_H
+
+#include "phys/collision/narrowphase/narrowphase.h"
+
+namespace phys {
+namespace col {
+namespace narrow {
+template <typename CFG>
+class SpherePlane : public Narrowphase<CFG> {
+ public:
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  enum {
+    lhs_type = SPHERE_SHAPE,
+    rhs_type = AXIS_ALIGNED_PLANE_SHAPE,
+  };
+
+  std::size_t contactCapacity() const override {
+    return 1;
+  }
+
+  void process(Collision<CFG>* result) override {
+    auto sphere_obj = result->objects[0];
+    auto plane_obj = result->objects[1];
+
+    // Infinite planes only work with identity transforms.
+    assert(plane_obj->transform == Transform<CFG>());
+
+    shapes::Sphere<CFG> const* sphere_shape =
+        static_cast<shapes::Sphere<CFG> const*>(sphere_obj->shape);
+    shapes::AxisAlignedPlane<CFG> const* plane_shape =
+        static_cast<shapes::AxisAlignedPlane<CFG> const*>(plane_obj->shape);
+
+    auto normal = plane_shape->getNormal();
+    vec3_t center = sphere_obj->transform.getTranslation();
+    real_t height = dot(normal, center) - plane_shape->getDistance();
+    real_t dist = height - sphere_shape->getRadius();
+
+    if(dist < result->getContactDistance()) {
+      addContact(*result, normal, center - normal * height, dist);
+    } else {
+      result->setSeparation(dist);
+    }
+  }
+};
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -14,6 +14,10 @@ class SphereSphere : public Narrowphase<CFG> {
     rhs_type = SPHERE_SHAPE,
   };
 
+  std::size_t contactCapacity() const override {
+    return 1;
+  }
+
   void process(Collision<CFG>* result) override {
     auto sphere_a = result->objects[0];
     auto sphere_b = result->objects[1];
@@ -24,7 +28,7 @@ class SphereSphere : public Narrowphase<CFG> {
         static_cast<shapes::Sphere<CFG> const*>(sphere_b->shape);
 
     auto contact_dst =
-        sphere_a_shape->getRadius() + sphere_a_shape->getRadius();
+        sphere_a_shape->getRadius() + sphere_b_shape->getRadius();
 
     auto delta_p = sphere_a->transform.getTranslation() -
                    sphere_b->transform.getTranslation();
@@ -39,8 +43,10 @@ class SphereSphere : public Narrowphase<CFG> {
       }
 
       auto col_point_on_b = sphere_b->transform.getTranslation() +
-                            normal * sphere_a_shape->getRadius();
+                            normal * sphere_b_shape->getRadius();
       addContact(*result, normal, col_point_on_b, dist);
+    } else {
+      result->setSeparation(dist);
     }
   }
 };
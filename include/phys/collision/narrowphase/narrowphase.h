@@ -5,6 +5,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <type_traits>
 #include "phys/collision/collision_object.h"
 #include "phys/collision/shape.h"
 
@@ -21,6 +22,11 @@ Contact<CFG>* leastValuablePoint(Collision<CFG>& collision,
 
   auto& points = collision.points;
 
+  // With a single point, the newest one wins.
+  if(points.size() == 1) {
+    return &points[0];
+  }
+
   // Make sure we do not get rid of the point with deepest penetration.
   point_ite max_depth_point = points.end();
   real_t max_depth = dist;
@@ -31,7 +37,7 @@ Contact<CFG>* leastValuablePoint(Collision<CFG>& collision,
     }
   }
 
-  point_ite candidate;
+  point_ite candidate = points.begin();
   real_t candidate_value = std::numeric_limits<real_t>::max();
   for(auto point = points.begin(); point != points.end(); ++point) {
     if(point == max_depth_point) {
@@ -81,8 +87,11 @@ Contact<CFG>* getPoint(Collision<CFG>& collision,
     return &collision.points.emplace_back();
   }
 
-  // recycle something.
-  return leastValuablePoint(collision, local_a, dist);
+  // recycle something. It is a different point from now on, so whatever
+  // was applied through it does not carry over.
+  auto recycled = leastValuablePoint(collision, local_a, dist);
+  recycled->applied_impulse = 0;
+  return recycled;
 }
 
 template <typename CFG>
@@ -98,7 +107,7 @@ void addContact(Collision<CFG>& collision, typename CFG::vec3_t const& normal,
   vec3_t local_a = a->transform.applyInverse(point_on_a);
 
   auto dst =
-      getPoint(collision, local_a, distance, collision.getContactDistanceSq());
+      getPoint(collision, local_a, distance, collision.getMatchToleranceSq());
 
   dst->ws_position[0] = point_on_a;
   dst->ws_position[1] = point_on_b;
@@ -109,6 +118,38 @@ void addContact(Collision<CFG>& collision, typename CFG::vec3_t const& normal,
   dst->distance = distance;
 }
 
+// Adds a contact between two spheres, or between the closest points of two
+// swept spheres' cores, such as capsules. fallback_normal is used if the
+// centers coincide.
+// Returns the distance between the two surfaces, whether or not a contact was
+// added.
+template <typename CFG>
+typename CFG::real_t addSphereContact(
+    Collision<CFG>& collision, typename CFG::vec3_t const& center_a,
+    typename CFG::real_t radius_a, typename CFG::vec3_t const& center_b,
+    typename CFG::real_t radius_b,
+    typename CFG::vec3_t const& fallback_normal) {
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  vec3_t delta = center_a - center_b;
+  real_t len_sq = dot(delta, delta);
+  real_t limit = radius_a + radius_b + collision.getContactDistance();
+  if(len_sq >= limit * limit) {
+    return sqrt(len_sq) - radius_a - radius_b;
+  }
+
+  real_t len = sqrt(len_sq);
+  real_t dist = len - radius_a - radius_b;
+
+  vec3_t normal = len > std::numeric_limits<real_t>::epsilon()
+                      ? delta / len
+                      : fallback_normal;
+
+  addContact(collision, normal, center_b + normal * radius_b, dist);
+  return dist;
+}
+
 // By default, narrowphase instances are shared, so it cannot have per-contact
 // member variables. Do not attempt to go around this by using a pair->value map
 // variable. Use StatefullNarrowphase instead.
@@ -128,6 +169,20 @@ class Narrowphase {
   virtual std::unique_ptr<Narrowphase<CFG>> clone() const {
     return nullptr;
   }
+
+  // How many points this algorithm can produce for a single collision.
+  // Collisions only reserve room for that many.
+  virtual std::size_t contactCapacity() const {
+    return CFG::max_contact_points_per_collision;
+  }
+
+  // Whether a single process() call finds every point of the manifold, as
+  // opposed to adding one per call and filling it over several steps. Only
+  // then is a manifold with room left complete enough to be reused, see
+  // Collision::canReuseManifold().
+  virtual bool oneShot() const {
+    return false;
+  }
 };
 
 // If a narrowphase needs more statefull data than what is held in a
@@ -193,21 +248,31 @@ class NarrowphaseFactory {
   using InternalNarrowphasePtr = std::unique_ptr<Narrowphase<CFG>>;
 
  public:
-  NarrowPhasePtr<CFG> getNarrowphase(Shape<CFG>* a, Shape<CFG>* b) {
+  NarrowPhasePtr<CFG> getNarrowphase(Shape<CFG>* a, Shape<CFG>* b) const {
+    auto result = findNarrowphase(a, b);
+
+    // Did prepopulate get called?
+    assert(result);
+    return result;
+  }
+
+  // Same as getNarrowphase(), but returns an empty pointer when there is no
+  // algorithm for the pair. Neither modifies the factory, so both can be
+  // called from several threads at once, once it is prepopulated.
+  NarrowPhasePtr<CFG> findNarrowphase(Shape<CFG>* a, Shape<CFG>* b) const {
     int shape_type_a = a->getShapeType();
     int shape_type_b = b->getShapeType();
 
     if(shape_type_a > shape_type_b) {
-      std::swap(a, b);
       std::swap(shape_type_a, shape_type_b);
     }
 
-    auto algo_type = std::make_pair(shape_type_a, shape_type_b);
-    auto& algo = narrowphases_[algo_type];
-
-    // Did prepopulate get called?
-    assert(algo);
+    auto found = narrowphases_.find(std::make_pair(shape_type_a, shape_type_b));
+    if(found == narrowphases_.end() || !found->second) {
+      return NarrowPhasePtr<CFG>();
+    }
 
+    auto& algo = found->second;
     if(algo->statefull()) {
       return NarrowPhasePtr<CFG>(algo->clone());
     }
@@ -233,7 +298,7 @@ class NarrowphaseFactory {
     auto& dst = factories_[std::make_pair(lhs_type, rhs_type)];
 
     dst.priority = priority;
-    dst.function = std::make_unique<T>;
+    dst.function = [this]() { return create_<T>(this); };
   }
 
   void registerDefaultShapesAndAlgorithms();
@@ -265,6 +330,22 @@ class NarrowphaseFactory {
   std::map<std::pair<int, int>, Entry> factories_;
   std::map<std::pair<int, int>, InternalNarrowphasePtr> narrowphases_;
 
+  // Algorithms that dispatch to other algorithms, such as the compound one,
+  // take the factory as constructor argument.
+  template <typename T>
+  static std::enable_if_t<std::is_constructible<T, NarrowphaseFactory*>::value,
+                          InternalNarrowphasePtr>
+  create_(NarrowphaseFactory* factory) {
+    return std::make_unique<T>(factory);
+  }
+
+  template <typename T>
+  static std::enable_if_t<!std::is_constructible<T, NarrowphaseFactory*>::value,
+                          InternalNarrowphasePtr>
+  create_(NarrowphaseFactory*) {
+    return std::make_unique<T>();
+  }
+
   Entry* lookupNarrowphaseFactory_(int a, int b) {
     Entry* result = nullptr;
     int b_orig = b;
@@ -302,12 +383,30 @@ class NarrowphaseFactory {
 
 #include "phys/collision/shapes/axis_aligned_plane.h"
 #include "phys/collision/shapes/box.h"
+#include "phys/collision/shapes/capsule.h"
+#include "phys/collision/shapes/compound.h"
 #include "phys/collision/shapes/convex.h"
+#include "phys/collision/shapes/convex_hull.h"
+#include "phys/collision/shapes/cylinder.h"
+#include "phys/collision/shapes/heightfield.h"
 #include "phys/collision/shapes/sphere.h"
+#include "phys/collision/shapes/triangle_mesh.h"
 
-#include "phys/collision/narrowphase/algorithms/box_box.h"
+#include "phys/collision/narrowphase/algorithms/box_capsule.h"
+#include "phys/collision/narrowphase/algorithms/box_plane.h"
+#include "phys/collision/narrowphase/algorithms/box_sphere.h"
+#include "phys/collision/narrowphase/algorithms/capsule_capsule.h"
+#include "phys/collision/narrowphase/algorithms/capsule_plane.h"
 #include "phys/collision/narrowphase/algorithms/convex_convex.h"
+#include "phys/collision/narrowphase/algorithms/convex_heightfield.h"
+#include "phys/collision/narrowphase/algorithms/convex_hull_plane.h"
 #include "phys/collision/narrowphase/algorithms/convex_plane.h"
+#include "phys/collision/narrowphase/algorithms/convex_triangle_mesh.h"
+#include "phys/collision/narrowphase/algorithms/shape_compound.h"
+#include "phys/collision/narrowphase/algorithms/sphere_capsule.h"
+#include "phys/collision/narrowphase/algorithms/sphere_convex_hull.h"
+#include "phys/collision/narrowphase/algorithms/sphere_heightfield.h"
+#include "phys/collision/narrowphase/algorithms/sphere_plane.h"
 #include "phys/collision/narrowphase/algorithms/sphere_sphere.h"
 
 namespace phys {
@@ -317,13 +416,35 @@ void NarrowphaseFactory<CFG>::registerDefaultShapesAndAlgorithms() {
   registerShapeType<shapes::Convex<CFG>>();
   registerShapeType<shapes::Box<CFG>>();
   registerShapeType<shapes::Sphere<CFG>>();
+  registerShapeType<shapes::Capsule<CFG>>();
+  registerShapeType<shapes::Cylinder<CFG>>();
+  registerShapeType<shapes::ConvexHull<CFG>>();
   registerShapeType<shapes::AxisAlignedPlane<CFG>>();
+  registerShapeType<shapes::TriangleMesh<CFG>>();
+  registerShapeType<shapes::Heightfield<CFG>>();
+  registerShapeType<shapes::Compound<CFG>>();
 
   registerAlgorithm<narrow::ConvexConvex<CFG>>(0);
   registerAlgorithm<narrow::ConvexPlane<CFG>>(0);
+  registerAlgorithm<narrow::ConvexTriangleMesh<CFG>>(0);
+  registerAlgorithm<narrow::ConvexHeightfield<CFG>>(0);
+  registerAlgorithm<narrow::ShapeCompound<CFG>>(0);
 
-  registerAlgorithm<narrow::BoxBox<CFG>>(1);
+  registerAlgorithm<narrow::BoxPlane<CFG>>(1);
+  registerAlgorithm<narrow::ConvexHullPlane<CFG>>(1);
   registerAlgorithm<narrow::SphereSphere<CFG>>(1);
+  registerAlgorithm<narrow::SphereHeightfield<CFG>>(1);
+
+  // Spheres are common enough to deserve closed-form tests against the other
+  // simple shapes.
+  registerAlgorithm<narrow::BoxSphere<CFG>>(1);
+  registerAlgorithm<narrow::SpherePlane<CFG>>(1);
+  registerAlgorithm<narrow::SphereConvexHull<CFG>>(1);
+
+  registerAlgorithm<narrow::CapsuleCapsule<CFG>>(1);
+  registerAlgorithm<narrow::SphereCapsule<CFG>>(1);
+  registerAlgorithm<narrow::CapsulePlane<CFG>>(1);
+  registerAlgorithm<narrow::BoxCapsule<CFG>>(1);
 }
 }
 }
@@ -12,7 +12,18 @@ enum ShapeType {
 
   BOX_SHAPE,
   SPHERE_SHAPE,
+  CAPSULE_SHAPE,
+  CYLINDER_SHAPE,
+  CONVEX_HULL_SHAPE,
+
+  // Collision pairs are ordered by shape type before their algorithm is
+  // looked up, and the algorithms against non-convex shapes are registered
+  // with CONVEX_SHAPE on the left. Non-convex shapes must therefore come
+  // after all convex ones.
   AXIS_ALIGNED_PLANE_SHAPE,
+  TRIANGLE_MESH_SHAPE,
+  HEIGHTFIELD_SHAPE,
+  COMPOUND_SHAPE,
 };
 
 #define PHYS_SHAPE_DEF(type, parent_class)                                  \
@@ -34,6 +45,10 @@ class Shape {
   virtual int getShapeType() const = 0;
 
   virtual void getInertia(real_t mass, vec3_t& dst) const = 0;
+
+  // Distance from the shape's origin to its furthest point. This bounds how
+  // far any point of the shape can travel under rotation.
+  virtual real_t getBoundingRadius() const = 0;
 };
 }
 
@@ -67,6 +67,10 @@ class AxisAlignedPlane : public Shape<CFG> {
     assert(false);
   }
 
+  real_t getBoundingRadius() const override {
+    return std::numeric_limits<real_t>::max();
+  }
+
  private:
   int axis_;
   real_t d_;
@@ -38,6 +38,10 @@ class Box : public Convex<CFG> {
     dst[2] = mass / real_t(12) * (size_sq[0] + size_sq[1]);
   }
 
+  real_t getBoundingRadius() const override {
+    return length(half_extent_);
+  }
+
   vec3_t getHalfExtent() const {
     return half_extent_;
   }
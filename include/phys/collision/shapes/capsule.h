@@ -0,0 +1,86 @@
+#ifndef PHYS_COLLISION_SHAPES_CAPSULE_H
+#define PHYS_COLLISION_SHAPES_CAPSULE_H
+
+#include "phys/collision/shapes/convex.h"
+
+namespace phys {
+namespace shapes {
+
+// A capsule is a sphere swept along a segment. The segment is aligned with
+// the Y axis and centered on the origin.
+template <typename CFG>
+class Capsule : public Convex<CFG> {
+ public:
+  PHYS_SHAPE_DEF(CAPSULE_SHAPE, Convex<CFG>);
+
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  // Args:
+  //   radius: radius of the swept sphere.
+  //   half_height: half the length of the inner segment, excluding the caps.
+  Capsule(real_t radius, real_t half_height)
+      : radius_(radius), half_height_(half_height) {}
+
+  void getAabb(Aabb<CFG>* dst, Transform<CFG> const& transform) const override {
+    auto const& trans = transform.getTranslation();
+    vec3_t axis = transform.getRotationMatrix()[1] * half_height_;
+    vec3_t extent = abs(axis) + vec3_t{radius_, radius_, radius_};
+
+    dst->min_bound = trans - extent;
+    dst->max_bound = trans + extent;
+  }
+
+  vec3_t getSupportingVertex(vec3_t const& direction) const override {
+    real_t y = direction[1] >= 0 ? half_height_ : -half_height_;
+    return vec3_t{0, y, 0} + direction * radius_;
+  }
+
+  void getInertia(real_t mass, vec3_t& dst) const override {
+    real_t r_sq = radius_ * radius_;
+    real_t height = half_height_ * real_t(2);
+
+    // Split the mass between the cylinder and the two hemispherical caps
+    // according to their volume (both divided by pi * r^2).
+    real_t cyl_volume = height;
+    real_t caps_volume = radius_ * real_t(4.0 / 3.0);
+    real_t cyl_mass = mass * cyl_volume / (cyl_volume + caps_volume);
+    real_t caps_mass = mass - cyl_mass;
+
+    real_t axial =
+        cyl_mass * r_sq * real_t(0.5) + caps_mass * r_sq * real_t(0.4);
+    real_t lateral =
+        cyl_mass * (height * height / real_t(12) + r_sq * real_t(0.25)) +
+        caps_mass * (r_sq * real_t(0.4) + height * height * real_t(0.25) +
+                     height * radius_ * real_t(0.375));
+
+    dst = {lateral, axial, lateral};
+  }
+
+  real_t getBoundingRadius() const override {
+    return half_height_ + radius_;
+  }
+
+  real_t getRadius() const {
+    return radius_;
+  }
+
+  real_t getHalfHeight() const {
+    return half_height_;
+  }
+
+  // Endpoints of the inner segment, in world space.
+  void getSegment(Transform<CFG> const& transform, vec3_t* p0,
+                  vec3_t* p1) const {
+    *p0 = transform.applyToVec(vec3_t{0, -half_height_, 0});
+    *p1 = transform.applyToVec(vec3_t{0, half_height_, 0});
+  }
+
+ private:
+  real_t radius_;
+  real_t half_height_;
+};
+}
+}
+
+#endif
\ No newline at end of file
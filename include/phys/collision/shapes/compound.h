@@ -0,0 +1,79 @@
+#ifndef PHYS_COLLISION_SHAPES_COMPOUND_H
+#define PHYS_COLLISION_SHAPES_COMPOUND_H
+
+#include <cstdint>
+#include <vector>
+#include "phys/collision/shape.h"
+
+namespace phys {
+namespace shapes {
+
+// A rigid assembly of child shapes, each placed by a transform relative to
+// the compound's origin. Children are referenced, not owned, and must outlive
+// the compound.
+//
+// The compound's origin is used as the body's center of mass, so children
+// should be laid out around it.
+//
+// Children collide through the same algorithms as standalone shapes. Pairs
+// of children without one, such as two heightfields, do not collide at all.
+template <typename CFG>
+class Compound : public Shape<CFG> {
+ public:
+  PHYS_SHAPE_DEF(COMPOUND_SHAPE, Shape<CFG>);
+
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    max_tree_depth = 64,
+  };
+
+  struct Child {
+    Shape<CFG>* shape;
+    Transform<CFG> transform;
+  };
+
+  // Builds the compound, and a bounding volume hierarchy over its children.
+  Compound(Child const* children, uint32_t child_count);
+
+  void getAabb(Aabb<CFG>* dst, Transform<CFG> const& transform) const override;
+
+  // The mass is distributed between children in proportion to the volume of
+  // their bounds.
+  void getInertia(real_t mass, vec3_t& dst) const override;
+
+  real_t getBoundingRadius() const override;
+
+  uint32_t getChildCount() const;
+  Child const& getChild(uint32_t index) const;
+
+  // Invokes visit(child_index) for every child whose bounds overlap an aabb
+  // expressed in the compound's local space.
+  template <typename VISIT_T>
+  void visitChildren(Aabb<CFG> const& local_aabb, VISIT_T visit) const;
+
+ private:
+  // Nodes are stored depth-first, so an internal node's left child
+  // immediately follows it.
+  struct Node_ {
+    Aabb<CFG> bounds;
+
+    // The child's index for leaves, the right node's index otherwise.
+    uint32_t data;
+    bool is_leaf;
+  };
+
+  uint32_t buildNode_(std::vector<uint32_t>& order,
+                      std::vector<Aabb<CFG>> const& child_bounds,
+                      uint32_t begin, uint32_t end, uint32_t depth);
+
+  std::vector<Child> children_;
+  std::vector<Node_> nodes_;
+};
+}
+}
+
+#include "phys/collision/shapes/impl/compound_impl.h"
+
+#endif
\ No newline at end of file
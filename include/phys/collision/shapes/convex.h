@@ -13,6 +13,14 @@ class Convex : public Shape<CFG> {
   using vec3_t = typename CFG::vec3_t;
 
   virtual vec3_t getSupportingVertex(vec3_t const& direction) const = 0;
+
+  // Same as above, but shapes may use and update a caller-owned hint to
+  // exploit temporal coherence between successive queries. Hints must be
+  // initialized to 0.
+  virtual vec3_t getSupportingVertexWithHint(vec3_t const& direction,
+                                             uint32_t* /*hint*/) const {
+    return getSupportingVertex(direction);
+  }
 };
 }
 }
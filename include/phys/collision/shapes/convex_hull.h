@@ -0,0 +1,107 @@
+#ifndef PHYS_COLLISION_SHAPES_CONVEX_HULL_H
+#define PHYS_COLLISION_SHAPES_CONVEX_HULL_H
+
+#include <array>
+#include <vector>
+#include "phys/collision/shapes/convex.h"
+
+namespace phys {
+namespace shapes {
+
+// The convex hull of a point cloud.
+//
+// Vertices are stored as a structure of arrays along with the hull's edge
+// graph. Small hulls are queried with a linear scan, larger ones by
+// hill-climbing the edge graph, which only visits a handful of vertices when
+// starting from the previous query's result.
+template <typename CFG>
+class ConvexHull : public Convex<CFG> {
+ public:
+  PHYS_SHAPE_DEF(CONVEX_HULL_SHAPE, Convex<CFG>);
+
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    // Hulls with up to this many vertices do not bother hill-climbing.
+    linear_scan_max_vertices = 32,
+
+    // The vertex arrays are padded to a multiple of this, so that the linear
+    // scan can process vertices in fixed-size blocks.
+    scan_block_size = 4,
+  };
+
+  // Builds the hull of a point cloud. Points that are not on the hull are
+  // discarded.
+  ConvexHull(vec3_t const* points, std::size_t count);
+
+  void getAabb(Aabb<CFG>* dst, Transform<CFG> const& transform) const override;
+
+  vec3_t getSupportingVertex(vec3_t const& direction) const override;
+
+  vec3_t getSupportingVertexWithHint(vec3_t const& direction,
+                                     uint32_t* hint) const override;
+
+  // Approximated using the hull's bounding box.
+  void getInertia(real_t mass, vec3_t& dst) const override;
+
+  real_t getBoundingRadius() const override;
+
+  std::size_t getVertexCount() const;
+  vec3_t getVertex(uint32_t index) const;
+
+  // A triangle of the hull's surface, along with its outward facing plane.
+  struct Face {
+    std::array<uint32_t, 3> vertices;
+    vec3_t normal;
+    real_t distance;
+
+    // Faces across each edge, neighbors[e] shares the edge from vertices[e]
+    // to vertices[(e + 1) % 3].
+    std::array<uint32_t, 3> neighbors;
+  };
+
+  // Hulls of flat or degenerate point clouds have no faces.
+  std::size_t getFaceCount() const;
+  Face const& getFace(uint32_t index) const;
+
+  // One of the faces around a vertex, a place to start walking the faces
+  // from. Only valid for hulls that have faces.
+  uint32_t getVertexFace(uint32_t vertex) const;
+
+  // Vertices connected to a given one by an edge of the hull.
+  uint32_t const* neighborsBegin(uint32_t index) const;
+  uint32_t const* neighborsEnd(uint32_t index) const;
+
+ private:
+  uint32_t findSupportLinear_(vec3_t const& direction) const;
+  uint32_t findSupportClimbing_(vec3_t const& direction, uint32_t start) const;
+
+  void build_(vec3_t const* points, std::size_t count);
+  void buildDegenerate_(vec3_t const* points, std::size_t count);
+
+  std::size_t vertex_count_ = 0;
+
+  // Padded to a multiple of scan_block_size by repeating the last vertex.
+  std::vector<real_t> xs_;
+  std::vector<real_t> ys_;
+  std::vector<real_t> zs_;
+
+  // Edge graph, in compressed sparse row form: the neighbors of vertex i are
+  // adjacency_[adjacency_offsets_[i]] to adjacency_[adjacency_offsets_[i+1]].
+  std::vector<uint32_t> adjacency_offsets_;
+  std::vector<uint32_t> adjacency_;
+
+  std::vector<Face> faces_;
+  std::vector<uint32_t> vertex_faces_;
+
+  vec3_t local_min_;
+  vec3_t local_max_;
+  real_t bounding_radius_ = 0;
+};
+}
+}
+
+#include "phys/collision/shapes/impl/convex_hull_impl.h"
+
+#endif
\ No newline at end of file
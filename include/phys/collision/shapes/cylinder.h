@@ -0,0 +1,80 @@
+#ifndef PHYS_COLLISION_SHAPES_CYLINDER_H
+#define PHYS_COLLISION_SHAPES_CYLINDER_H
+
+#include <cmath>
+#include "phys/collision/shapes/convex.h"
+
+namespace phys {
+namespace shapes {
+
+// A cylinder aligned with the Y axis and centered on the origin.
+template <typename CFG>
+class Cylinder : public Convex<CFG> {
+ public:
+  PHYS_SHAPE_DEF(CYLINDER_SHAPE, Convex<CFG>);
+
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  Cylinder(real_t radius, real_t half_height)
+      : radius_(radius), half_height_(half_height) {}
+
+  void getAabb(Aabb<CFG>* dst, Transform<CFG> const& transform) const override {
+    auto const& trans = transform.getTranslation();
+    vec3_t axis = transform.getRotationMatrix()[1];
+
+    // The caps are disks, their extent along a world axis shrinks as the
+    // cylinder's axis aligns with it.
+    vec3_t extent;
+    for(int i = 0; i < 3; ++i) {
+      real_t disk =
+          std::sqrt(std::max(real_t(1) - axis[i] * axis[i], real_t(0)));
+      extent[i] = std::abs(axis[i]) * half_height_ + disk * radius_;
+    }
+
+    dst->min_bound = trans - extent;
+    dst->max_bound = trans + extent;
+  }
+
+  vec3_t getSupportingVertex(vec3_t const& direction) const override {
+    real_t y = direction[1] >= 0 ? half_height_ : -half_height_;
+    real_t radial_len = std::sqrt(direction[0] * direction[0] +
+                                  direction[2] * direction[2]);
+    if(radial_len <= std::numeric_limits<real_t>::epsilon()) {
+      return {0, y, 0};
+    }
+
+    real_t s = radius_ / radial_len;
+    return {direction[0] * s, y, direction[2] * s};
+  }
+
+  void getInertia(real_t mass, vec3_t& dst) const override {
+    real_t r_sq = radius_ * radius_;
+    real_t height = half_height_ * real_t(2);
+
+    real_t axial = mass * r_sq * real_t(0.5);
+    real_t lateral = mass * (real_t(3) * r_sq + height * height) / real_t(12);
+
+    dst = {lateral, axial, lateral};
+  }
+
+  real_t getBoundingRadius() const override {
+    return std::sqrt(radius_ * radius_ + half_height_ * half_height_);
+  }
+
+  real_t getRadius() const {
+    return radius_;
+  }
+
+  real_t getHalfHeight() const {
+    return half_height_;
+  }
+
+ private:
+  real_t radius_;
+  real_t half_height_;
+};
+}
+}
+
+#endif
\ No newline at end of file
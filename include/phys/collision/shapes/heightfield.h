@@ -0,0 +1,97 @@
+#ifndef PHYS_COLLISION_SHAPES_HEIGHTFIELD_H
+#define PHYS_COLLISION_SHAPES_HEIGHTFIELD_H
+
+#include <cstdint>
+#include <vector>
+#include "phys/collision/shape.h"
+
+namespace phys {
+namespace shapes {
+
+// A static terrain, sampled on a regular grid of the local XZ plane. Sample
+// (column, row) sits at (column * cell_size, height, row * cell_size), and
+// every cell is split into two triangles.
+//
+// Heights are stored as 16 bits integers, mapped to:
+//   height_offset + sample * height_scale
+// so a 4096 x 4096 terrain takes 32MB. A min/max pyramid over square tiles of
+// cells lets queries reject empty regions without touching the samples.
+//
+// The terrain is solid below its surface: objects that sink under it get
+// pushed back up.
+template <typename CFG>
+class Heightfield : public Shape<CFG> {
+ public:
+  PHYS_SHAPE_DEF(HEIGHTFIELD_SHAPE, Shape<CFG>);
+
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    // Cells per side of the pyramid's finest tiles.
+    tile_size = 16,
+  };
+
+  // Args:
+  //   columns, rows: Number of samples along X and Z, at least 2 each.
+  //   samples: columns * rows heights, row after row.
+  Heightfield(uint32_t columns, uint32_t rows, uint16_t const* samples,
+              real_t cell_size, real_t height_scale, real_t height_offset);
+
+  void getAabb(Aabb<CFG>* dst, Transform<CFG> const& transform) const override;
+
+  void getInertia(real_t mass, vec3_t& dst) const override;
+
+  real_t getBoundingRadius() const override;
+
+  uint32_t getColumnCount() const;
+  uint32_t getRowCount() const;
+  real_t getCellSize() const;
+
+  real_t getHeight(uint32_t column, uint32_t row) const;
+
+  // Invokes visit(triangle_index, vertices) for the triangles of every cell
+  // under the footprint of an aabb expressed in the heightfield's local space,
+  // skipping the ones entirely below it.
+  template <typename VISIT_T>
+  void visitTriangles(Aabb<CFG> const& local_aabb, VISIT_T visit) const;
+
+ private:
+  struct Range_ {
+    uint16_t min;
+    uint16_t max;
+  };
+
+  struct Level_ {
+    uint32_t columns;
+    uint32_t rows;
+    std::vector<Range_> tiles;
+  };
+
+  void buildPyramid_();
+
+  // Highest sample under tiles [x0, x1] x [z0, z1] of the finest level, read
+  // from the coarsest level that covers them with at most 2 x 2 tiles.
+  uint16_t maxSample_(uint32_t x0, uint32_t z0, uint32_t x1,
+                      uint32_t z1) const;
+
+  // Lowest sample value that could stand above a height.
+  uint16_t quantizeDown_(real_t height) const;
+
+  uint32_t columns_;
+  uint32_t rows_;
+  real_t cell_size_;
+  real_t height_scale_;
+  real_t height_offset_;
+
+  std::vector<uint16_t> samples_;
+
+  // Finest level first, ends with a single tile.
+  std::vector<Level_> levels_;
+};
+}
+}
+
+#include "phys/collision/shapes/impl/heightfield_impl.h"
+
+#endif
\ No newline at end of file
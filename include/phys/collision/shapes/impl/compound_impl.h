@@ -0,0 +1,186 @@
+#ifndef PHYS_COLLISION_SHAPES_COMPOUND_IMPL_H
+#define PHYS_COLLISION_SHAPES_COMPOUND_IMPL_H
+
+#include <algorithm>
+#include <cassert>
+
+namespace phys {
+namespace shapes {
+
+template <typename CFG>
+Compound<CFG>::Compound(Child const* children, uint32_t child_count)
+    : children_(children, children + child_count) {
+  assert(child_count > 0);
+
+  std::vector<Aabb<CFG>> child_bounds(child_count);
+  std::vector<uint32_t> order(child_count);
+  for(uint32_t i = 0; i < child_count; ++i) {
+    children_[i].shape->getAabb(&child_bounds[i], children_[i].transform);
+    order[i] = i;
+  }
+
+  nodes_.reserve(child_count * 2 - 1);
+  buildNode_(order, child_bounds, 0, child_count, 0);
+}
+
+template <typename CFG>
+uint32_t Compound<CFG>::buildNode_(std::vector<uint32_t>& order,
+                                   std::vector<Aabb<CFG>> const& child_bounds,
+                                   uint32_t begin, uint32_t end,
+                                   uint32_t depth) {
+  // Median splits keep the tree balanced, this cannot realistically fire.
+  assert(depth < max_tree_depth);
+
+  uint32_t node_index = uint32_t(nodes_.size());
+  nodes_.emplace_back();
+
+  Aabb<CFG> bounds = child_bounds[order[begin]];
+  for(uint32_t i = begin + 1; i < end; ++i) {
+    bounds.min_bound = min(bounds.min_bound, child_bounds[order[i]].min_bound);
+    bounds.max_bound = max(bounds.max_bound, child_bounds[order[i]].max_bound);
+  }
+  nodes_[node_index].bounds = bounds;
+
+  if(end - begin == 1) {
+    nodes_[node_index].data = order[begin];
+    nodes_[node_index].is_leaf = true;
+    return node_index;
+  }
+
+  // Split along the longest axis of the bounds.
+  vec3_t extent = bounds.max_bound - bounds.min_bound;
+  int axis = 0;
+  if(extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if(extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  uint32_t mid = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + mid,
+                   order.begin() + end, [&](uint32_t lhs, uint32_t rhs) {
+                     return child_bounds[lhs].min_bound[axis] +
+                                child_bounds[lhs].max_bound[axis] <
+                            child_bounds[rhs].min_bound[axis] +
+                                child_bounds[rhs].max_bound[axis];
+                   });
+
+  buildNode_(order, child_bounds, begin, mid, depth + 1);
+  uint32_t right = buildNode_(order, child_bounds, mid, end, depth + 1);
+
+  nodes_[node_index].data = right;
+  nodes_[node_index].is_leaf = false;
+  return node_index;
+}
+
+template <typename CFG>
+void Compound<CFG>::getAabb(Aabb<CFG>* dst,
+                            Transform<CFG> const& transform) const {
+  Aabb<CFG> const& local = nodes_[0].bounds;
+  vec3_t local_center = (local.min_bound + local.max_bound) * real_t(0.5);
+  vec3_t half_extent = (local.max_bound - local.min_bound) * real_t(0.5);
+
+  *dst = Aabb<CFG>(local_center, half_extent, transform);
+}
+
+template <typename CFG>
+void Compound<CFG>::getInertia(real_t mass, vec3_t& dst) const {
+  std::vector<real_t> volumes(children_.size());
+  real_t total_volume = 0;
+  for(std::size_t i = 0; i < children_.size(); ++i) {
+    Aabb<CFG> bounds;
+    children_[i].shape->getAabb(&bounds, Transform<CFG>());
+    vec3_t extent = bounds.max_bound - bounds.min_bound;
+    volumes[i] = extent[0] * extent[1] * extent[2];
+    total_volume += volumes[i];
+  }
+
+  // Accumulate the full tensor, and only keep its diagonal at the end.
+  real_t tensor[3][3] = {};
+  for(std::size_t i = 0; i < children_.size(); ++i) {
+    real_t child_mass =
+        total_volume > real_t(0) ? mass * volumes[i] / total_volume
+                                 : mass / real_t(children_.size());
+
+    vec3_t local;
+    children_[i].shape->getInertia(child_mass, local);
+
+    auto const& rot = children_[i].transform.getRotationMatrix();
+    vec3_t const& offset = children_[i].transform.getTranslation();
+    real_t offset_sq = dot(offset, offset);
+
+    for(int r = 0; r < 3; ++r) {
+      for(int c = 0; c < 3; ++c) {
+        // rot * diag(local) * transpose(rot)
+        real_t rotated = rot[0][r] * local[0] * rot[0][c] +
+                         rot[1][r] * local[1] * rot[1][c] +
+                         rot[2][r] * local[2] * rot[2][c];
+
+        // Parallel axis theorem.
+        real_t shifted = child_mass * ((r == c ? offset_sq : real_t(0)) -
+                                       offset[r] * offset[c]);
+        tensor[r][c] += rotated + shifted;
+      }
+    }
+  }
+
+  dst = vec3_t{tensor[0][0], tensor[1][1], tensor[2][2]};
+}
+
+template <typename CFG>
+typename CFG::real_t Compound<CFG>::getBoundingRadius() const {
+  real_t result = 0;
+  for(auto const& child : children_) {
+    result = std::max(result, length(child.transform.getTranslation()) +
+                                  child.shape->getBoundingRadius());
+  }
+  return result;
+}
+
+template <typename CFG>
+uint32_t Compound<CFG>::getChildCount() const {
+  return uint32_t(children_.size());
+}
+
+template <typename CFG>
+typename Compound<CFG>::Child const& Compound<CFG>::getChild(
+    uint32_t index) const {
+  return children_[index];
+}
+
+template <typename CFG>
+template <typename VISIT_T>
+void Compound<CFG>::visitChildren(Aabb<CFG> const& local_aabb,
+                                  VISIT_T visit) const {
+  uint32_t stack[max_tree_depth];
+  uint32_t stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while(stack_size > 0) {
+    uint32_t node_index = stack[--stack_size];
+    Node_ const& node = nodes_[node_index];
+
+    bool overlap = true;
+    for(int i = 0; i < 3; ++i) {
+      overlap = overlap &&
+                node.bounds.max_bound[i] >= local_aabb.min_bound[i] &&
+                node.bounds.min_bound[i] <= local_aabb.max_bound[i];
+    }
+    if(!overlap) {
+      continue;
+    }
+
+    if(node.is_leaf) {
+      visit(node.data);
+    } else {
+      assert(stack_size + 2 <= max_tree_depth);
+      stack[stack_size++] = node.data;
+      stack[stack_size++] = node_index + 1;
+    }
+  }
+}
+}
+}
+
+#endif
\ No newline at end of file
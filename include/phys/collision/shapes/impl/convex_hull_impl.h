@@ -0,0 +1,417 @@
+#ifndef PHYS_COLLISION_SHAPES_CONVEX_HULL_IMPL_H
+#define PHYS_COLLISION_SHAPES_CONVEX_HULL_IMPL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <utility>
+
+namespace phys {
+namespace shapes {
+
+template <typename CFG>
+ConvexHull<CFG>::ConvexHull(vec3_t const* points, std::size_t count) {
+  assert(count > 0);
+  build_(points, count);
+
+  local_min_ = local_max_ = getVertex(0);
+  for(uint32_t i = 0; i < vertex_count_; ++i) {
+    auto v = getVertex(i);
+    local_min_ = min(local_min_, v);
+    local_max_ = max(local_max_, v);
+    bounding_radius_ = std::max(bounding_radius_, length(v));
+  }
+}
+
+template <typename CFG>
+void ConvexHull<CFG>::getAabb(Aabb<CFG>* dst,
+                              Transform<CFG> const& transform) const {
+  vec3_t local_center = (local_min_ + local_max_) * real_t(0.5);
+  vec3_t half_extent = (local_max_ - local_min_) * real_t(0.5);
+
+  *dst = Aabb<CFG>(local_center, half_extent, transform);
+}
+
+template <typename CFG>
+typename CFG::vec3_t ConvexHull<CFG>::getSupportingVertex(
+    vec3_t const& direction) const {
+  uint32_t hint = 0;
+  return getSupportingVertexWithHint(direction, &hint);
+}
+
+template <typename CFG>
+typename CFG::vec3_t ConvexHull<CFG>::getSupportingVertexWithHint(
+    vec3_t const& direction, uint32_t* hint) const {
+  uint32_t found;
+  if(vertex_count_ <= linear_scan_max_vertices) {
+    found = findSupportLinear_(direction);
+  } else {
+    found = findSupportClimbing_(direction,
+                                 *hint < vertex_count_ ? *hint : uint32_t(0));
+  }
+
+  *hint = found;
+  return getVertex(found);
+}
+
+template <typename CFG>
+void ConvexHull<CFG>::getInertia(real_t mass, vec3_t& dst) const {
+  auto size = local_max_ - local_min_;
+  auto size_sq = size * size;
+
+  dst[0] = mass / real_t(12) * (size_sq[1] + size_sq[2]);
+  dst[1] = mass / real_t(12) * (size_sq[0] + size_sq[2]);
+  dst[2] = mass / real_t(12) * (size_sq[0] + size_sq[1]);
+}
+
+template <typename CFG>
+typename CFG::real_t ConvexHull<CFG>::getBoundingRadius() const {
+  return bounding_radius_;
+}
+
+template <typename CFG>
+std::size_t ConvexHull<CFG>::getVertexCount() const {
+  return vertex_count_;
+}
+
+template <typename CFG>
+typename CFG::vec3_t ConvexHull<CFG>::getVertex(uint32_t index) const {
+  return {xs_[index], ys_[index], zs_[index]};
+}
+
+template <typename CFG>
+std::size_t ConvexHull<CFG>::getFaceCount() const {
+  return faces_.size();
+}
+
+template <typename CFG>
+typename ConvexHull<CFG>::Face const& ConvexHull<CFG>::getFace(
+    uint32_t index) const {
+  return faces_[index];
+}
+
+template <typename CFG>
+uint32_t ConvexHull<CFG>::getVertexFace(uint32_t vertex) const {
+  return vertex_faces_[vertex];
+}
+
+template <typename CFG>
+uint32_t const* ConvexHull<CFG>::neighborsBegin(uint32_t index) const {
+  return adjacency_.data() + adjacency_offsets_[index];
+}
+
+template <typename CFG>
+uint32_t const* ConvexHull<CFG>::neighborsEnd(uint32_t index) const {
+  return adjacency_.data() + adjacency_offsets_[index + 1];
+}
+
+template <typename CFG>
+uint32_t ConvexHull<CFG>::findSupportLinear_(vec3_t const& direction) const {
+  real_t dx = direction[0];
+  real_t dy = direction[1];
+  real_t dz = direction[2];
+
+  real_t const* xs = xs_.data();
+  real_t const* ys = ys_.data();
+  real_t const* zs = zs_.data();
+
+  // Each lane tracks its own best candidate, which keeps the inner loop free
+  // of dependencies between lanes so that it can be vectorized.
+  real_t best[scan_block_size];
+  uint32_t best_index[scan_block_size];
+  for(uint32_t lane = 0; lane < scan_block_size; ++lane) {
+    best[lane] = std::numeric_limits<real_t>::lowest();
+    best_index[lane] = 0;
+  }
+
+  uint32_t padded_count = uint32_t(xs_.size());
+  for(uint32_t i = 0; i < padded_count; i += scan_block_size) {
+    for(uint32_t lane = 0; lane < scan_block_size; ++lane) {
+      real_t d = dx * xs[i + lane] + dy * ys[i + lane] + dz * zs[i + lane];
+      bool better = d > best[lane];
+      best[lane] = better ? d : best[lane];
+      best_index[lane] = better ? i + lane : best_index[lane];
+    }
+  }
+
+  uint32_t result = best_index[0];
+  real_t result_value = best[0];
+  for(uint32_t lane = 1; lane < scan_block_size; ++lane) {
+    if(best[lane] > result_value) {
+      result_value = best[lane];
+      result = best_index[lane];
+    }
+  }
+
+  // Padding repeats the last vertex.
+  return std::min(result, uint32_t(vertex_count_ - 1));
+}
+
+template <typename CFG>
+uint32_t ConvexHull<CFG>::findSupportClimbing_(vec3_t const& direction,
+                                               uint32_t start) const {
+  // On a convex polytope, a vertex that has no better neighbor is a global
+  // maximum, so the greedy walk cannot get stuck.
+  uint32_t current = start;
+  real_t current_value = dot(direction, getVertex(current));
+
+  for(;;) {
+    uint32_t next = current;
+    for(auto n = neighborsBegin(current); n != neighborsEnd(current); ++n) {
+      real_t value = dot(direction, getVertex(*n));
+      if(value > current_value) {
+        current_value = value;
+        next = *n;
+      }
+    }
+
+    if(next == current) {
+      return current;
+    }
+    current = next;
+  }
+}
+
+template <typename CFG>
+void ConvexHull<CFG>::build_(vec3_t const* points, std::size_t count) {
+  struct Face {
+    std::array<uint32_t, 3> v;
+    vec3_t normal;
+    real_t d;
+    bool alive;
+  };
+
+  if(count < 4) {
+    buildDegenerate_(points, count);
+    return;
+  }
+
+  vec3_t bb_min = points[0];
+  vec3_t bb_max = points[0];
+  for(std::size_t i = 1; i < count; ++i) {
+    bb_min = min(bb_min, points[i]);
+    bb_max = max(bb_max, points[i]);
+  }
+  real_t eps = length(bb_max - bb_min) *
+               std::numeric_limits<real_t>::epsilon() * real_t(100);
+
+  // Initial tetrahedron, from a few mutually distant points.
+  uint32_t i0 = 0;
+  for(uint32_t i = 1; i < count; ++i) {
+    if(points[i][0] < points[i0][0]) {
+      i0 = i;
+    }
+  }
+
+  auto farthest = [&](auto metric) {
+    uint32_t best = 0;
+    real_t best_value = metric(points[0]);
+    for(uint32_t i = 1; i < count; ++i) {
+      real_t value = metric(points[i]);
+      if(value > best_value) {
+        best_value = value;
+        best = i;
+      }
+    }
+    return std::make_pair(best, best_value);
+  };
+
+  auto p0 = points[i0];
+  auto found_1 =
+      farthest([&](vec3_t const& p) { return length(p - p0); });
+  auto p1 = points[found_1.first];
+
+  auto found_2 = farthest([&](vec3_t const& p) {
+    return length(cross(p - p0, p1 - p0));
+  });
+  auto p2 = points[found_2.first];
+
+  vec3_t base_normal = cross(p1 - p0, p2 - p0);
+  auto found_3 = farthest([&](vec3_t const& p) {
+    return std::abs(dot(p - p0, base_normal));
+  });
+
+  real_t base_len = length(base_normal);
+  if(found_1.second <= eps || found_2.second <= eps * found_1.second ||
+     found_3.second <= eps * base_len) {
+    // Flat or degenerate cloud.
+    buildDegenerate_(points, count);
+    return;
+  }
+
+  uint32_t tetra[4] = {i0, found_1.first, found_2.first, found_3.first};
+  vec3_t centroid = (points[tetra[0]] + points[tetra[1]] + points[tetra[2]] +
+                     points[tetra[3]]) *
+                    real_t(0.25);
+
+  std::vector<Face> faces;
+  auto add_face = [&](uint32_t a, uint32_t b, uint32_t c) {
+    vec3_t normal =
+        normalize(cross(points[b] - points[a], points[c] - points[a]));
+    real_t d = dot(normal, points[a]);
+
+    // The centroid of the initial tetrahedron stays inside the hull.
+    if(dot(normal, centroid) - d > 0) {
+      std::swap(b, c);
+      normal = -normal;
+      d = -d;
+    }
+    faces.push_back(Face{{{a, b, c}}, normal, d, true});
+  };
+
+  add_face(tetra[0], tetra[1], tetra[2]);
+  add_face(tetra[0], tetra[1], tetra[3]);
+  add_face(tetra[0], tetra[2], tetra[3]);
+  add_face(tetra[1], tetra[2], tetra[3]);
+
+  std::set<std::pair<uint32_t, uint32_t>> visible_edges;
+  std::vector<std::pair<uint32_t, uint32_t>> horizon;
+
+  for(uint32_t i = 0; i < count; ++i) {
+    auto const& p = points[i];
+
+    visible_edges.clear();
+    for(auto& face : faces) {
+      if(face.alive && dot(face.normal, p) - face.d > eps) {
+        face.alive = false;
+        for(int e = 0; e < 3; ++e) {
+          visible_edges.emplace(face.v[e], face.v[(e + 1) % 3]);
+        }
+      }
+    }
+
+    if(visible_edges.empty()) {
+      continue;
+    }
+
+    // The horizon is made of the visible edges whose twin belongs to a face
+    // that remains.
+    horizon.clear();
+    for(auto const& edge : visible_edges) {
+      if(visible_edges.count(std::make_pair(edge.second, edge.first)) == 0) {
+        horizon.push_back(edge);
+      }
+    }
+
+    for(auto const& edge : horizon) {
+      add_face(edge.first, edge.second, i);
+    }
+
+    faces.erase(std::remove_if(faces.begin(), faces.end(),
+                               [](Face const& f) { return !f.alive; }),
+                faces.end());
+  }
+
+  // Compact the vertices that made it onto the hull.
+  std::vector<uint32_t> remap(count, std::numeric_limits<uint32_t>::max());
+  std::vector<uint32_t> hull_points;
+  for(auto const& face : faces) {
+    for(auto v : face.v) {
+      if(remap[v] == std::numeric_limits<uint32_t>::max()) {
+        remap[v] = uint32_t(hull_points.size());
+        hull_points.push_back(v);
+      }
+    }
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  faces_.resize(0);
+  for(auto const& face : faces) {
+    for(int e = 0; e < 3; ++e) {
+      uint32_t a = remap[face.v[e]];
+      uint32_t b = remap[face.v[(e + 1) % 3]];
+      edges.emplace_back(a, b);
+      edges.emplace_back(b, a);
+    }
+    faces_.push_back(
+        {{{remap[face.v[0]], remap[face.v[1]], remap[face.v[2]]}},
+         face.normal,
+         face.d});
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // Every edge of a closed hull is walked once in each direction, by the two
+  // faces it joins.
+  std::vector<std::pair<std::pair<uint32_t, uint32_t>, uint32_t>> face_edges;
+  vertex_faces_.resize(hull_points.size());
+  for(uint32_t f = 0; f < faces_.size(); ++f) {
+    for(int e = 0; e < 3; ++e) {
+      uint32_t a = faces_[f].vertices[e];
+      uint32_t b = faces_[f].vertices[(e + 1) % 3];
+      face_edges.push_back({{a, b}, f});
+      vertex_faces_[a] = f;
+    }
+  }
+  std::sort(face_edges.begin(), face_edges.end());
+  for(auto& face : faces_) {
+    for(int e = 0; e < 3; ++e) {
+      std::pair<uint32_t, uint32_t> twin = {face.vertices[(e + 1) % 3],
+                                            face.vertices[e]};
+      auto found = std::lower_bound(
+          face_edges.begin(), face_edges.end(), std::make_pair(twin, 0u));
+      assert(found != face_edges.end() && found->first == twin);
+      face.neighbors[e] = found->second;
+    }
+  }
+
+  vertex_count_ = hull_points.size();
+  std::size_t padded_count =
+      (vertex_count_ + scan_block_size - 1) / scan_block_size * scan_block_size;
+  xs_.resize(padded_count);
+  ys_.resize(padded_count);
+  zs_.resize(padded_count);
+  for(std::size_t i = 0; i < padded_count; ++i) {
+    auto const& p = points[hull_points[std::min(i, vertex_count_ - 1)]];
+    xs_[i] = p[0];
+    ys_[i] = p[1];
+    zs_[i] = p[2];
+  }
+
+  adjacency_offsets_.assign(vertex_count_ + 1, 0);
+  adjacency_.resize(edges.size());
+  for(std::size_t i = 0; i < edges.size(); ++i) {
+    adjacency_offsets_[edges[i].first + 1]++;
+    adjacency_[i] = edges[i].second;
+  }
+  for(std::size_t i = 0; i < vertex_count_; ++i) {
+    adjacency_offsets_[i + 1] += adjacency_offsets_[i];
+  }
+}
+
+template <typename CFG>
+void ConvexHull<CFG>::buildDegenerate_(vec3_t const* points,
+                                       std::size_t count) {
+  // Without a proper hull, keep every point and connect them all together.
+  // This keeps hill-climbing correct, if not efficient.
+  vertex_count_ = count;
+  std::size_t padded_count =
+      (count + scan_block_size - 1) / scan_block_size * scan_block_size;
+  xs_.resize(padded_count);
+  ys_.resize(padded_count);
+  zs_.resize(padded_count);
+  for(std::size_t i = 0; i < padded_count; ++i) {
+    auto const& p = points[std::min(i, count - 1)];
+    xs_[i] = p[0];
+    ys_[i] = p[1];
+    zs_[i] = p[2];
+  }
+
+  adjacency_offsets_.resize(count + 1);
+  adjacency_.resize(0);
+  for(uint32_t i = 0; i < count; ++i) {
+    adjacency_offsets_[i] = uint32_t(adjacency_.size());
+    for(uint32_t j = 0; j < count; ++j) {
+      if(i != j) {
+        adjacency_.push_back(j);
+      }
+    }
+  }
+  adjacency_offsets_[count] = uint32_t(adjacency_.size());
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,252 @@
+#ifndef PHYS_COLLISION_SHAPES_HEIGHTFIELD_IMPL_H
+#define PHYS_COLLISION_SHAPES_HEIGHTFIELD_IMPL_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace phys {
+namespace shapes {
+
+template <typename CFG>
+Heightfield<CFG>::Heightfield(uint32_t columns, uint32_t rows,
+                              uint16_t const* samples, real_t cell_size,
+                              real_t height_scale, real_t height_offset)
+    : columns_(columns),
+      rows_(rows),
+      cell_size_(cell_size),
+      height_scale_(height_scale),
+      height_offset_(height_offset),
+      samples_(samples, samples + std::size_t(columns) * rows) {
+  assert(columns >= 2 && rows >= 2);
+  assert(cell_size > real_t(0) && height_scale > real_t(0));
+
+  buildPyramid_();
+}
+
+template <typename CFG>
+void Heightfield<CFG>::buildPyramid_() {
+  Level_ finest;
+  finest.columns = (columns_ - 2) / tile_size + 1;
+  finest.rows = (rows_ - 2) / tile_size + 1;
+  finest.tiles.resize(std::size_t(finest.columns) * finest.rows);
+
+  // Neighbouring tiles share their border samples, since those belong to
+  // cells on both sides.
+  for(uint32_t tz = 0; tz < finest.rows; ++tz) {
+    for(uint32_t tx = 0; tx < finest.columns; ++tx) {
+      uint32_t x_end = std::min((tx + 1) * tile_size, columns_ - 1);
+      uint32_t z_end = std::min((tz + 1) * tile_size, rows_ - 1);
+
+      Range_ range = {0xFFFF, 0};
+      for(uint32_t z = tz * tile_size; z <= z_end; ++z) {
+        uint16_t const* row = &samples_[std::size_t(z) * columns_];
+        for(uint32_t x = tx * tile_size; x <= x_end; ++x) {
+          range.min = std::min(range.min, row[x]);
+          range.max = std::max(range.max, row[x]);
+        }
+      }
+      finest.tiles[tz * finest.columns + tx] = range;
+    }
+  }
+  levels_.push_back(std::move(finest));
+
+  while(levels_.back().columns > 1 || levels_.back().rows > 1) {
+    Level_ const& src = levels_.back();
+
+    Level_ dst;
+    dst.columns = (src.columns + 1) / 2;
+    dst.rows = (src.rows + 1) / 2;
+    dst.tiles.resize(std::size_t(dst.columns) * dst.rows);
+
+    for(uint32_t tz = 0; tz < dst.rows; ++tz) {
+      for(uint32_t tx = 0; tx < dst.columns; ++tx) {
+        Range_ range = {0xFFFF, 0};
+        for(uint32_t z = tz * 2; z < std::min(tz * 2 + 2, src.rows); ++z) {
+          for(uint32_t x = tx * 2; x < std::min(tx * 2 + 2, src.columns);
+              ++x) {
+            Range_ const& child = src.tiles[z * src.columns + x];
+            range.min = std::min(range.min, child.min);
+            range.max = std::max(range.max, child.max);
+          }
+        }
+        dst.tiles[tz * dst.columns + tx] = range;
+      }
+    }
+    levels_.push_back(std::move(dst));
+  }
+}
+
+template <typename CFG>
+void Heightfield<CFG>::getAabb(Aabb<CFG>* dst,
+                               Transform<CFG> const& transform) const {
+  // Flat terrains would have empty bounds, which the broadphase cannot keep
+  // track of. Pad them like planes do.
+  Range_ const& all = levels_.back().tiles[0];
+  vec3_t local_min{real_t(0),
+                   height_offset_ + all.min * height_scale_ - real_t(0.1),
+                   real_t(0)};
+  vec3_t local_max{(columns_ - 1) * cell_size_,
+                   height_offset_ + all.max * height_scale_ + real_t(0.1),
+                   (rows_ - 1) * cell_size_};
+
+  vec3_t local_center = (local_min + local_max) * real_t(0.5);
+  vec3_t half_extent = (local_max - local_min) * real_t(0.5);
+
+  *dst = Aabb<CFG>(local_center, half_extent, transform);
+}
+
+template <typename CFG>
+void Heightfield<CFG>::getInertia(real_t, vec3_t&) const {
+  // Heightfields are meant for static geometry.
+  assert(false);
+}
+
+template <typename CFG>
+typename CFG::real_t Heightfield<CFG>::getBoundingRadius() const {
+  Range_ const& all = levels_.back().tiles[0];
+  real_t highest = std::max(std::abs(height_offset_ + all.min * height_scale_),
+                            std::abs(height_offset_ + all.max * height_scale_));
+  vec3_t furthest{(columns_ - 1) * cell_size_, highest,
+                  (rows_ - 1) * cell_size_};
+  return length(furthest);
+}
+
+template <typename CFG>
+uint32_t Heightfield<CFG>::getColumnCount() const {
+  return columns_;
+}
+
+template <typename CFG>
+uint32_t Heightfield<CFG>::getRowCount() const {
+  return rows_;
+}
+
+template <typename CFG>
+typename CFG::real_t Heightfield<CFG>::getCellSize() const {
+  return cell_size_;
+}
+
+template <typename CFG>
+typename CFG::real_t Heightfield<CFG>::getHeight(uint32_t column,
+                                                 uint32_t row) const {
+  return height_offset_ +
+         samples_[std::size_t(row) * columns_ + column] * height_scale_;
+}
+
+template <typename CFG>
+uint16_t Heightfield<CFG>::maxSample_(uint32_t x0, uint32_t z0, uint32_t x1,
+                                      uint32_t z1) const {
+  std::size_t level = 0;
+  while(x1 - x0 > 1 || z1 - z0 > 1) {
+    x0 >>= 1;
+    z0 >>= 1;
+    x1 >>= 1;
+    z1 >>= 1;
+    ++level;
+  }
+  assert(level < levels_.size());
+
+  Level_ const& src = levels_[level];
+  uint16_t result = 0;
+  for(uint32_t z = z0; z <= z1; ++z) {
+    for(uint32_t x = x0; x <= x1; ++x) {
+      result = std::max(result, src.tiles[z * src.columns + x].max);
+    }
+  }
+  return result;
+}
+
+template <typename CFG>
+uint16_t Heightfield<CFG>::quantizeDown_(real_t height) const {
+  real_t q = std::floor((height - height_offset_) / height_scale_);
+  return uint16_t(std::min(std::max(q, real_t(0)), real_t(0xFFFF)));
+}
+
+template <typename CFG>
+template <typename VISIT_T>
+void Heightfield<CFG>::visitTriangles(Aabb<CFG> const& local_aabb,
+                                      VISIT_T visit) const {
+  real_t width = (columns_ - 1) * cell_size_;
+  real_t depth = (rows_ - 1) * cell_size_;
+  if(local_aabb.max_bound[0] < real_t(0) || local_aabb.min_bound[0] > width ||
+     local_aabb.max_bound[2] < real_t(0) || local_aabb.min_bound[2] > depth) {
+    return;
+  }
+
+  // Samples strictly below this cannot reach the aabb.
+  real_t query_bottom = local_aabb.min_bound[1];
+  if(query_bottom > height_offset_ + real_t(0xFFFF) * height_scale_) {
+    return;
+  }
+  uint16_t q_bottom = quantizeDown_(query_bottom);
+
+  auto to_cell = [&](real_t coord, uint32_t cell_count) {
+    real_t cell = std::floor(coord / cell_size_);
+    return uint32_t(std::min(std::max(cell, real_t(0)),
+                             real_t(cell_count - 1)));
+  };
+
+  uint32_t x0 = to_cell(local_aabb.min_bound[0], columns_ - 1);
+  uint32_t x1 = to_cell(local_aabb.max_bound[0], columns_ - 1);
+  uint32_t z0 = to_cell(local_aabb.min_bound[2], rows_ - 1);
+  uint32_t z1 = to_cell(local_aabb.max_bound[2], rows_ - 1);
+
+  if(maxSample_(x0 / tile_size, z0 / tile_size, x1 / tile_size,
+                z1 / tile_size) < q_bottom) {
+    return;
+  }
+
+  Level_ const& tiles = levels_[0];
+  vec3_t triangle[3];
+  for(uint32_t tz = z0 / tile_size; tz <= z1 / tile_size; ++tz) {
+    for(uint32_t tx = x0 / tile_size; tx <= x1 / tile_size; ++tx) {
+      if(tiles.tiles[tz * tiles.columns + tx].max < q_bottom) {
+        continue;
+      }
+
+      uint32_t cz_end = std::min(z1, tz * tile_size + tile_size - 1);
+      uint32_t cx_end = std::min(x1, tx * tile_size + tile_size - 1);
+      for(uint32_t z = std::max(z0, tz * tile_size); z <= cz_end; ++z) {
+        uint16_t const* near_row = &samples_[std::size_t(z) * columns_];
+        uint16_t const* far_row = near_row + columns_;
+
+        for(uint32_t x = std::max(x0, tx * tile_size); x <= cx_end; ++x) {
+          uint16_t s00 = near_row[x];
+          uint16_t s10 = near_row[x + 1];
+          uint16_t s01 = far_row[x];
+          uint16_t s11 = far_row[x + 1];
+          if(std::max(std::max(s00, s10), std::max(s01, s11)) < q_bottom) {
+            continue;
+          }
+
+          real_t x_near = x * cell_size_;
+          real_t x_far = x_near + cell_size_;
+          real_t z_near = z * cell_size_;
+          real_t z_far = z_near + cell_size_;
+
+          vec3_t p00{x_near, height_offset_ + s00 * height_scale_, z_near};
+          vec3_t p10{x_far, height_offset_ + s10 * height_scale_, z_near};
+          vec3_t p01{x_near, height_offset_ + s01 * height_scale_, z_far};
+          vec3_t p11{x_far, height_offset_ + s11 * height_scale_, z_far};
+
+          // Both triangles face up.
+          uint32_t cell_index = z * (columns_ - 1) + x;
+          triangle[0] = p00;
+          triangle[1] = p01;
+          triangle[2] = p10;
+          visit(cell_index * 2, static_cast<vec3_t const*>(triangle));
+
+          triangle[0] = p10;
+          triangle[1] = p01;
+          triangle[2] = p11;
+          visit(cell_index * 2 + 1, static_cast<vec3_t const*>(triangle));
+        }
+      }
+    }
+  }
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,371 @@
+#ifndef PHYS_COLLISION_SHAPES_TRIANGLE_MESH_IMPL_H
+#define PHYS_COLLISION_SHAPES_TRIANGLE_MESH_IMPL_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace phys {
+namespace shapes {
+
+template <typename CFG>
+struct TriangleMesh<CFG>::BuildState_ {
+  std::vector<vec3_t> tri_min;
+  std::vector<vec3_t> tri_max;
+  std::vector<vec3_t> centroids;
+
+  // Triangles, in the order the leaves reference them.
+  std::vector<uint32_t> order;
+
+  std::vector<Node> nodes;
+};
+
+template <typename CFG>
+TriangleMesh<CFG>::TriangleMesh(vec3_t const* vertices, uint32_t vertex_count,
+                                uint32_t const* indices,
+                                uint32_t triangle_count) {
+  assert(vertex_count > 0 && triangle_count > 0);
+  assert(triangle_count < (1u << (31 - Node::leaf_count_bits)));
+
+  vec3_t mesh_min = vertices[0];
+  vec3_t mesh_max = vertices[0];
+  for(uint32_t i = 1; i < vertex_count; ++i) {
+    mesh_min = min(mesh_min, vertices[i]);
+    mesh_max = max(mesh_max, vertices[i]);
+  }
+
+  bounds_min_ = mesh_min;
+  bounds_max_ = mesh_max;
+  for(int i = 0; i < 3; ++i) {
+    real_t extent = mesh_max[i] - mesh_min[i];
+    quantization_scale_[i] =
+        extent > real_t(0) ? real_t(65535) / extent : real_t(0);
+  }
+
+  BuildState_ state;
+  state.tri_min.resize(triangle_count);
+  state.tri_max.resize(triangle_count);
+  state.centroids.resize(triangle_count);
+  state.order.resize(triangle_count);
+  for(uint32_t i = 0; i < triangle_count; ++i) {
+    auto const& v0 = vertices[indices[i * 3]];
+    auto const& v1 = vertices[indices[i * 3 + 1]];
+    auto const& v2 = vertices[indices[i * 3 + 2]];
+
+    state.tri_min[i] = min(min(v0, v1), v2);
+    state.tri_max[i] = max(max(v0, v1), v2);
+    state.centroids[i] = (v0 + v1 + v2) / real_t(3);
+    state.order[i] = i;
+  }
+
+  state.nodes.reserve(triangle_count / max_triangles_per_leaf * 2 + 1);
+  buildNode_(state, 0, triangle_count, 0);
+
+  // Lay everything out in the baked format.
+  uint32_t node_count = uint32_t(state.nodes.size());
+  uint32_t vertices_offset = Header::align(uint32_t(sizeof(Header)));
+  uint32_t triangles_offset =
+      Header::align(vertices_offset + vertex_count * 3 * sizeof(float));
+  uint32_t nodes_offset = Header::align(
+      triangles_offset + triangle_count * 3 * sizeof(uint32_t));
+  uint32_t total_size = nodes_offset + node_count * uint32_t(sizeof(Node));
+
+  owned_data_.assign(total_size, 0);
+  uint8_t* data = owned_data_.data();
+
+  Header header;
+  header.magic = Header::magic_value;
+  header.version = Header::current_version;
+  header.total_size = total_size;
+  header.vertex_count = vertex_count;
+  header.triangle_count = triangle_count;
+  header.node_count = node_count;
+  header.vertices_offset = vertices_offset;
+  header.triangles_offset = triangles_offset;
+  header.nodes_offset = nodes_offset;
+  for(int i = 0; i < 3; ++i) {
+    header.bounds_min[i] = float(bounds_min_[i]);
+    header.bounds_max[i] = float(bounds_max_[i]);
+    header.quantization_scale[i] = float(quantization_scale_[i]);
+  }
+  std::memcpy(data, &header, sizeof(Header));
+
+  float* dst_vertices = reinterpret_cast<float*>(data + vertices_offset);
+  for(uint32_t i = 0; i < vertex_count; ++i) {
+    for(int axis = 0; axis < 3; ++axis) {
+      dst_vertices[i * 3 + axis] = float(vertices[i][axis]);
+    }
+  }
+
+  uint32_t* dst_triangles =
+      reinterpret_cast<uint32_t*>(data + triangles_offset);
+  for(uint32_t i = 0; i < triangle_count; ++i) {
+    auto src = state.order[i];
+    for(int v = 0; v < 3; ++v) {
+      dst_triangles[i * 3 + v] = indices[src * 3 + v];
+    }
+  }
+
+  std::memcpy(data + nodes_offset, state.nodes.data(),
+              node_count * sizeof(Node));
+
+  bind_(data);
+}
+
+template <typename CFG>
+TriangleMesh<CFG>::TriangleMesh(void const* baked_data, std::size_t size) {
+  assert(isValidBakedData(baked_data, size));
+  bind_(baked_data);
+}
+
+template <typename CFG>
+bool TriangleMesh<CFG>::isValidBakedData(void const* baked_data,
+                                         std::size_t size) {
+  if(!baked_data || size < sizeof(Header) ||
+     (reinterpret_cast<std::uintptr_t>(baked_data) & 15) != 0) {
+    return false;
+  }
+
+  auto header = static_cast<Header const*>(baked_data);
+  if(header->magic != Header::magic_value ||
+     header->version != Header::current_version || header->total_size > size ||
+     header->triangle_count == 0 || header->node_count == 0) {
+    return false;
+  }
+
+  // 64 bits math, so that crafted counts cannot overflow.
+  auto fits = [&](uint64_t offset, uint64_t bytes) {
+    return (offset & 15) == 0 && offset + bytes <= header->total_size;
+  };
+
+  if(!fits(header->vertices_offset,
+          uint64_t(header->vertex_count) * 3 * sizeof(float)) ||
+     !fits(header->triangles_offset,
+          uint64_t(header->triangle_count) * 3 * sizeof(uint32_t)) ||
+     !fits(header->nodes_offset,
+          uint64_t(header->node_count) * sizeof(Node))) {
+    return false;
+  }
+
+  auto data = static_cast<uint8_t const*>(baked_data);
+  auto triangles =
+      reinterpret_cast<uint32_t const*>(data + header->triangles_offset);
+  for(uint64_t i = 0; i < uint64_t(header->triangle_count) * 3; ++i) {
+    if(triangles[i] >= header->vertex_count) {
+      return false;
+    }
+  }
+
+  // Children must come after their parent, which keeps the midphase from
+  // looping, and leave it room on its stack for both of them.
+  auto nodes = reinterpret_cast<Node const*>(data + header->nodes_offset);
+  std::vector<uint32_t> depths(header->node_count, 0);
+  for(uint32_t i = 0; i < header->node_count; ++i) {
+    auto const& node = nodes[i];
+    if(node.isLeaf()) {
+      if(uint64_t(node.firstTriangle()) + node.triangleCount() >
+         header->triangle_count) {
+        return false;
+      }
+      continue;
+    }
+
+    uint32_t right = node.data;
+    if(right <= i + 1 || right >= header->node_count ||
+       depths[i] + 2 > max_tree_depth) {
+      return false;
+    }
+    depths[i + 1] = std::max(depths[i + 1], depths[i] + 1);
+    depths[right] = std::max(depths[right], depths[i] + 1);
+  }
+  return true;
+}
+
+template <typename CFG>
+void const* TriangleMesh<CFG>::getBakedData() const {
+  return header_;
+}
+
+template <typename CFG>
+std::size_t TriangleMesh<CFG>::getBakedSize() const {
+  return header_->total_size;
+}
+
+template <typename CFG>
+void TriangleMesh<CFG>::getAabb(Aabb<CFG>* dst,
+                                Transform<CFG> const& transform) const {
+  // Flat meshes would have empty bounds, which the broadphase cannot keep
+  // track of. Pad them like planes do.
+  vec3_t local_center = (bounds_min_ + bounds_max_) * real_t(0.5);
+  vec3_t half_extent = (bounds_max_ - bounds_min_) * real_t(0.5) +
+                       vec3_t{real_t(0.1), real_t(0.1), real_t(0.1)};
+
+  *dst = Aabb<CFG>(local_center, half_extent, transform);
+}
+
+template <typename CFG>
+void TriangleMesh<CFG>::getInertia(real_t, vec3_t&) const {
+  // Triangle meshes are meant for static geometry.
+  assert(false);
+}
+
+template <typename CFG>
+typename CFG::real_t TriangleMesh<CFG>::getBoundingRadius() const {
+  vec3_t furthest = max(abs(bounds_min_), abs(bounds_max_));
+  return length(furthest);
+}
+
+template <typename CFG>
+uint32_t TriangleMesh<CFG>::getTriangleCount() const {
+  return header_->triangle_count;
+}
+
+template <typename CFG>
+void TriangleMesh<CFG>::getTriangle(uint32_t index, vec3_t* dst) const {
+  for(int v = 0; v < 3; ++v) {
+    float const* src = vertices_ + triangles_[index * 3 + v] * 3;
+    dst[v] = vec3_t{src[0], src[1], src[2]};
+  }
+}
+
+template <typename CFG>
+template <typename VISIT_T>
+void TriangleMesh<CFG>::visitTriangles(Aabb<CFG> const& local_aabb,
+                                       VISIT_T visit) const {
+  for(int i = 0; i < 3; ++i) {
+    if(local_aabb.max_bound[i] < bounds_min_[i] ||
+       local_aabb.min_bound[i] > bounds_max_[i]) {
+      return;
+    }
+  }
+
+  uint16_t q_min[3];
+  uint16_t q_max[3];
+  quantize_(local_aabb.min_bound, local_aabb.max_bound, q_min, q_max);
+
+  uint32_t stack[max_tree_depth];
+  uint32_t stack_size = 0;
+  stack[stack_size++] = 0;
+
+  vec3_t triangle[3];
+  while(stack_size > 0) {
+    uint32_t node_index = stack[--stack_size];
+    Node const& node = nodes_[node_index];
+
+    if(node.quantized_max[0] < q_min[0] || node.quantized_min[0] > q_max[0] ||
+       node.quantized_max[1] < q_min[1] || node.quantized_min[1] > q_max[1] ||
+       node.quantized_max[2] < q_min[2] || node.quantized_min[2] > q_max[2]) {
+      continue;
+    }
+
+    if(node.isLeaf()) {
+      uint32_t first = node.firstTriangle();
+      uint32_t count = node.triangleCount();
+
+      for(uint32_t tri = first; tri < first + count; ++tri) {
+        getTriangle(tri, triangle);
+        visit(tri, static_cast<vec3_t const*>(triangle));
+      }
+    } else {
+      assert(stack_size + 2 <= max_tree_depth);
+      stack[stack_size++] = node.data;
+      stack[stack_size++] = node_index + 1;
+    }
+  }
+}
+
+template <typename CFG>
+uint32_t TriangleMesh<CFG>::buildNode_(BuildState_& state, uint32_t begin,
+                                       uint32_t end, uint32_t depth) const {
+  // Median splits keep the tree balanced, this cannot realistically fire.
+  assert(depth < max_tree_depth);
+
+  uint32_t node_index = uint32_t(state.nodes.size());
+  state.nodes.emplace_back();
+
+  vec3_t node_min = state.tri_min[state.order[begin]];
+  vec3_t node_max = state.tri_max[state.order[begin]];
+  vec3_t centroid_min = state.centroids[state.order[begin]];
+  vec3_t centroid_max = centroid_min;
+  for(uint32_t i = begin + 1; i < end; ++i) {
+    auto tri = state.order[i];
+    node_min = min(node_min, state.tri_min[tri]);
+    node_max = max(node_max, state.tri_max[tri]);
+    centroid_min = min(centroid_min, state.centroids[tri]);
+    centroid_max = max(centroid_max, state.centroids[tri]);
+  }
+
+  {
+    Node& node = state.nodes[node_index];
+    quantize_(node_min, node_max, node.quantized_min, node.quantized_max);
+  }
+
+  if(end - begin <= max_triangles_per_leaf) {
+    state.nodes[node_index].data = Node::leaf_flag |
+                                   (begin << Node::leaf_count_bits) |
+                                   (end - begin - 1);
+    return node_index;
+  }
+
+  // Split at the median along the centroids' largest axis.
+  vec3_t centroid_extent = centroid_max - centroid_min;
+  int axis = 0;
+  if(centroid_extent[1] > centroid_extent[axis]) {
+    axis = 1;
+  }
+  if(centroid_extent[2] > centroid_extent[axis]) {
+    axis = 2;
+  }
+
+  uint32_t mid = begin + (end - begin) / 2;
+  std::nth_element(state.order.begin() + begin, state.order.begin() + mid,
+                   state.order.begin() + end, [&](uint32_t a, uint32_t b) {
+                     return state.centroids[a][axis] < state.centroids[b][axis];
+                   });
+
+  buildNode_(state, begin, mid, depth + 1);
+  uint32_t right = buildNode_(state, mid, end, depth + 1);
+
+  // nodes may have been reallocated.
+  state.nodes[node_index].data = right;
+  return node_index;
+}
+
+template <typename CFG>
+void TriangleMesh<CFG>::bind_(void const* baked_data) {
+  auto data = static_cast<uint8_t const*>(baked_data);
+
+  header_ = static_cast<Header const*>(baked_data);
+  vertices_ = reinterpret_cast<float const*>(data + header_->vertices_offset);
+  triangles_ =
+      reinterpret_cast<uint32_t const*>(data + header_->triangles_offset);
+  nodes_ = reinterpret_cast<Node const*>(data + header_->nodes_offset);
+
+  for(int i = 0; i < 3; ++i) {
+    bounds_min_[i] = header_->bounds_min[i];
+    bounds_max_[i] = header_->bounds_max[i];
+    quantization_scale_[i] = header_->quantization_scale[i];
+  }
+}
+
+template <typename CFG>
+void TriangleMesh<CFG>::quantize_(vec3_t const& min_bound,
+                                  vec3_t const& max_bound, uint16_t* q_min,
+                                  uint16_t* q_max) const {
+  auto to_range = [](real_t v) {
+    return uint16_t(std::min(std::max(v, real_t(0)), real_t(65535)));
+  };
+
+  for(int i = 0; i < 3; ++i) {
+    q_min[i] = to_range(
+        std::floor((min_bound[i] - bounds_min_[i]) * quantization_scale_[i]));
+    q_max[i] = to_range(
+        std::ceil((max_bound[i] - bounds_min_[i]) * quantization_scale_[i]));
+  }
+}
+}
+}
+
+#endif
\ No newline at end of file
@@ -32,6 +32,10 @@ class Sphere : public Convex<CFG> {
     return direction * radius_;
   }
 
+  real_t getBoundingRadius() const override {
+    return radius_;
+  }
+
   real_t getRadius() const {
     return radius_;
   }
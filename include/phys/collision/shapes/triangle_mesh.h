@@ -0,0 +1,170 @@
+#ifndef PHYS_COLLISION_SHAPES_TRIANGLE_MESH_H
+#define PHYS_COLLISION_SHAPES_TRIANGLE_MESH_H
+
+#include <cstdint>
+#include <vector>
+#include "phys/collision/shape.h"
+
+namespace phys {
+namespace shapes {
+
+// Header of a baked triangle mesh. Every offset is in bytes from the start of
+// the header, so the whole blob is position-independent and can be used
+// straight out of a memory-mapped file.
+//
+// N.B. The baked format uses 32 bits floats and the host's byte order,
+// regardless of the configuration's real_t.
+struct BakedTriangleMeshHeader {
+  enum : uint32_t {
+    magic_value = 0x4D544850,  // "PHTM"
+    current_version = 1,
+  };
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t total_size;
+
+  uint32_t vertex_count;
+  uint32_t triangle_count;
+  uint32_t node_count;
+
+  uint32_t vertices_offset;   // vertex_count * float[3]
+  uint32_t triangles_offset;  // triangle_count * uint32_t[3]
+  uint32_t nodes_offset;      // node_count * BakedTriangleMeshNode
+
+  float bounds_min[3];
+  float bounds_max[3];
+
+  // Maps local coordinates to the 16 bits node bounds.
+  float quantization_scale[3];
+
+  // Every array starts on a 16 bytes boundary.
+  static uint32_t align(uint32_t offset) {
+    return (offset + 15) & ~uint32_t(15);
+  }
+};
+
+// A node of the mesh's bounding volume hierarchy. Bounds are quantized
+// relative to the mesh's bounds, and rounded outwards.
+struct BakedTriangleMeshNode {
+  enum : uint32_t {
+    leaf_flag = 0x80000000,
+    leaf_count_bits = 3,
+  };
+
+  uint16_t quantized_min[3];
+  uint16_t quantized_max[3];
+
+  // Nodes are stored depth-first, so an internal node's left child
+  // immediately follows it, and this holds the index of its right child.
+  //
+  // For leaves, this is:
+  //   leaf_flag | first_triangle << leaf_count_bits | (triangle_count - 1)
+  uint32_t data;
+
+  bool isLeaf() const {
+    return (data & leaf_flag) != 0;
+  }
+
+  // Only for leaves.
+  uint32_t firstTriangle() const {
+    return (data & ~uint32_t(leaf_flag)) >> leaf_count_bits;
+  }
+
+  uint32_t triangleCount() const {
+    return (data & ((1u << leaf_count_bits) - 1)) + 1;
+  }
+};
+
+static_assert(sizeof(BakedTriangleMeshNode) == 16,
+              "Mesh nodes are expected to be tightly packed");
+
+// A static mesh made of one-sided triangles, front faces are wound
+// counter-clockwise.
+//
+// The mesh is either built from indexed triangles at runtime, or used in
+// place from previously baked data, in which case no processing happens at
+// load time.
+template <typename CFG>
+class TriangleMesh : public Shape<CFG> {
+ public:
+  PHYS_SHAPE_DEF(TRIANGLE_MESH_SHAPE, Shape<CFG>);
+
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    max_triangles_per_leaf = 4,
+    max_tree_depth = 64,
+  };
+
+  static_assert(max_triangles_per_leaf <=
+                    (1 << BakedTriangleMeshNode::leaf_count_bits),
+                "Leaves cannot encode that many triangles");
+
+  // Builds the mesh, and its bounding volume hierarchy.
+  TriangleMesh(vec3_t const* vertices, uint32_t vertex_count,
+               uint32_t const* indices, uint32_t triangle_count);
+
+  // Uses baked data in place. The data must be 16 bytes aligned and outlive
+  // the mesh.
+  TriangleMesh(void const* baked_data, std::size_t size);
+
+  // The mesh may point into its own storage.
+  TriangleMesh(TriangleMesh const&) = delete;
+  TriangleMesh& operator=(TriangleMesh const&) = delete;
+
+  // Checks that a blob is a baked mesh, before handing it to the
+  // constructor. Every index in it must stay within the arrays it refers to,
+  // and the hierarchy must not be deeper than the midphase can walk.
+  static bool isValidBakedData(void const* baked_data, std::size_t size);
+
+  // The baked representation of this mesh, suitable to be written to disk.
+  void const* getBakedData() const;
+  std::size_t getBakedSize() const;
+
+  void getAabb(Aabb<CFG>* dst, Transform<CFG> const& transform) const override;
+
+  void getInertia(real_t mass, vec3_t& dst) const override;
+
+  real_t getBoundingRadius() const override;
+
+  uint32_t getTriangleCount() const;
+  void getTriangle(uint32_t index, vec3_t* dst) const;
+
+  // Midphase: invokes visit(triangle_index, vertices) for every triangle that
+  // may overlap an aabb expressed in the mesh's local space.
+  template <typename VISIT_T>
+  void visitTriangles(Aabb<CFG> const& local_aabb, VISIT_T visit) const;
+
+ private:
+  using Header = BakedTriangleMeshHeader;
+  using Node = BakedTriangleMeshNode;
+
+  struct BuildState_;
+  uint32_t buildNode_(BuildState_& state, uint32_t begin, uint32_t end,
+                      uint32_t depth) const;
+
+  void bind_(void const* baked_data);
+
+  void quantize_(vec3_t const& min_bound, vec3_t const& max_bound,
+                 uint16_t* q_min, uint16_t* q_max) const;
+
+  // Set when the mesh was built at runtime, empty when using external data.
+  std::vector<uint8_t> owned_data_;
+
+  Header const* header_ = nullptr;
+  float const* vertices_ = nullptr;
+  uint32_t const* triangles_ = nullptr;
+  Node const* nodes_ = nullptr;
+
+  vec3_t bounds_min_;
+  vec3_t bounds_max_;
+  vec3_t quantization_scale_;
+};
+}
+}
+
+#include "phys/collision/shapes/impl/triangle_mesh_impl.h"
+
+#endif
\ No newline at end of file
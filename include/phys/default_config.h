@@ -25,6 +25,7 @@ struct DefaultConfig {
 
 #include "phys/collision/broadphase/axis_sweep.h"
 #include "phys/dynamics/solver/sequential_impulse/solver.h"
+#include "phys/dynamics/solver/substepping/solver.h"
 
 namespace phys {
 template <typename CFG>
@@ -32,6 +33,14 @@ struct DefaultAlgos {
   using Solver = phys::seqi_solver::Solver<CFG>;
   using Broadphase = phys::col::AxisSweepBroadphase<CFG>;
 };
+
+// Same as DefaultAlgos, with the substepping solver, which does not support
+// joints yet: World::createJoint() does not compile with it.
+template <typename CFG>
+struct SubsteppingAlgos {
+  using Solver = phys::substep_solver::Solver<CFG>;
+  using Broadphase = phys::col::AxisSweepBroadphase<CFG>;
+};
 }
 
 #endif
\ No newline at end of file
@@ -17,11 +17,16 @@ struct Body {
     Config(Shape<CFG>* shp) : shape(shp) {}
     Shape<CFG>* shape = nullptr;
     Transform<CFG> initial_transform;
+
+    // See col::Object::friction.
+    typename CFG::real_t friction = typename CFG::real_t(0.5);
   };
 
   Body(Config const& config) {
     collision_info_.shape = config.shape;
     collision_info_.transform = config.initial_transform;
+    collision_info_.friction = config.friction;
+    collision_info_.motion_reference_ = config.initial_transform;
     collision_info_.owner_ = this;
   }
 
@@ -2,6 +2,7 @@
 #define PHYS_LIB_DYNAMICS_WORLD_H
 
 #include "phys/dynamics/dynamic_body.h"
+#include "phys/dynamics/joint.h"
 #include "phys/dynamics/simulation_island_manager.h"
 #include "phys/dynamics/static_body.h"
 
@@ -19,9 +20,15 @@ struct World {
   using Body = Body<CFG, ALGO>;
   using StaticBody = StaticBody<CFG, ALGO>;
   using DynamicBody = DynamicBody<CFG, ALGO>;
+  using Joint = phys::Joint<CFG, ALGO>;
 
+  // Args:
+  //   object_count_hint: number of objects we are expecting to handle.
+  //   np_factory: prepopulated narrowphase factory, may be shared.
+  //   thread_pool: optional, work will be spread across it when provided.
   World(unsigned int object_count_hint,
-        col::NarrowphaseFactory<CFG>* np_factory);
+        col::NarrowphaseFactory<CFG>* np_factory,
+        ThreadPool* thread_pool = nullptr);
   void step(real_t);
 
   StaticBody* createBody(typename StaticBody::Config const&);
@@ -32,18 +39,42 @@ struct World {
 
   std::vector<DynamicBody*>& dynamicBodies();
 
+  // Joints must be deleted before either of their bodies. Only available
+  // when the solver supports them.
+  Joint* createJoint(typename Joint::Config const&);
+  void deleteJoint(Joint*);
+
+  std::vector<Joint*>& joints();
+
+  // Lets resting contacts skip the narrowphase, see
+  // CollisionWorld::ManifoldReuse.
+  using ManifoldReuse = typename CollisionWorld<CFG>::ManifoldReuse;
+  ManifoldReuse& manifoldReuse();
+
+  // Islands solved on other threads use copies of its configuration.
+  Solver& solver();
+
+  // Calls visit(stats) for each island the last step solved, whichever
+  // thread solved it, see Solver::IslandStats.
+  template <typename VISIT_T>
+  void visitIslandStats(VISIT_T visit) const;
+
  private:
   std::vector<DynamicBody*> dynamic_bodies_;
+  std::vector<Joint*> joints_;
 
   BP_CollisionWorld<CFG, Broadphase> collision_world_;
   SimulationIslandManager<CFG> island_manager;
 
-  void detectCollisions_();
+  void detectCollisions_(real_t dt);
 
   void bodyCreated_(Body*);
   void bodyDestroyed_(Body*);
 
   Solver solver_;
+
+  // Solvers of the thread pool's other threads.
+  std::vector<Solver> thread_solvers_;
 };
 }
 
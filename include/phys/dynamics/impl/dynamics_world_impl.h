@@ -5,21 +5,46 @@ namespace phys {
 
 template <typename CFG, typename ALGO>
 World<CFG, ALGO>::World(unsigned int object_count_hint,
-                        col::NarrowphaseFactory<CFG>* np_factory)
-    : collision_world_(object_count_hint, np_factory) {}
+                        col::NarrowphaseFactory<CFG>* np_factory,
+                        ThreadPool* thread_pool)
+    : collision_world_(object_count_hint, np_factory, thread_pool) {}
 
 template <typename CFG, typename ALGO>
 void World<CFG, ALGO>::step(real_t dt) {
   // Find intersections
-  detectCollisions_();
+  detectCollisions_(dt);
+
+  // Islands are independent from each other, each thread solves them with
+  // its own solver, set up like the main one. Islands that are large enough
+  // to be split by the solver get the main one, and the whole pool.
+  auto thread_pool = collision_world_.thread_pool_;
+  std::size_t thread_count = thread_pool ? thread_pool->threadCount() : 1;
+  thread_solvers_.resize(thread_count - 1);
+  solver_.clearIslandStats();
+  for(auto& solver : thread_solvers_) {
+    solver.config() = solver_.config();
+    solver.clearIslandStats();
+  }
 
   island_manager.buildAndVisitIslands(
-      collision_world_.collisions(), dynamic_bodies_,
-      [dt, this](auto objects, auto collisions) {
-
-        solver_.solve(objects, collisions, dt);
+      collision_world_.collisions(), dynamic_bodies_, joints_, thread_pool,
+      [this](std::size_t contact_count, std::size_t joint_count) {
+        return solver_.splitsIsland(contact_count, joint_count);
+      },
+      [dt, this](auto objects, auto collisions, auto joints,
+                 std::size_t thread, ThreadPool* island_pool) {
+        Solver& solver = thread == 0 ? solver_ : thread_solvers_[thread - 1];
+        solver.solve(objects, collisions, joints, dt, island_pool);
       });
 
+  // Substepping solvers move the bodies themselves.
+  if(Solver::integrates_transforms) {
+    for(auto b : dynamic_bodies_) {
+      b->clearForces();
+    }
+    return;
+  }
+
   // Integrate transforms.
   for(auto b : dynamic_bodies_) {
     Transform<CFG> new_trans;
@@ -33,15 +58,26 @@ void World<CFG, ALGO>::step(real_t dt) {
 }
 
 template <typename CFG, typename ALGO>
-void World<CFG, ALGO>::detectCollisions_() {
+void World<CFG, ALGO>::detectCollisions_(real_t dt) {
   // Update the broadphase AABB pf all bodies that may have moved.
   for(auto b : dynamic_bodies_) {
+    // Forces get applied before the solver runs, so account for them in the
+    // predicted motion. The sweep has the broadphase and narrowphase look
+    // that far ahead for speculative contacts, which is what keeps fast
+    // bodies from tunnelling: there is no time of impact pass.
+    vec3_t predicted_vel =
+        b->getLinearVelocity() +
+        b->dynamics_data_.net_force_ * (b->getInvMass() * dt);
+    b->collision_info_.setSweep(predicted_vel, b->getAngularVelocity(), dt);
+
     if(b->collision_info_.isActive()) {
       Aabb<CFG> aabb;
       b->getAabb(&aabb);
 
       collision_world_.update(&b->collision_info_);
     }
+
+    b->collision_info_.updateMotion();
   }
 
   collision_world_.updateNarrowphase();
@@ -89,6 +125,28 @@ void World<CFG, ALGO>::deleteBody(DynamicBody* body) {
   delete body;
 }
 
+template <typename CFG, typename ALGO>
+typename World<CFG, ALGO>::Joint* World<CFG, ALGO>::createJoint(
+    typename World<CFG, ALGO>::Joint::Config const& cfg) {
+  static_assert(Solver::supports_joints,
+                "The world's solver does not support joints");
+  auto result = new Joint(cfg);
+
+  result->world_index_ = joints_.size();
+  joints_.emplace_back(result);
+  return result;
+}
+
+template <typename CFG, typename ALGO>
+void World<CFG, ALGO>::deleteJoint(Joint* joint) {
+  auto index = joint->world_index_;
+  assert(joints_[index] == joint);
+  joints_[index] = joints_.back();
+  joints_[index]->world_index_ = index;
+  joints_.pop_back();
+  delete joint;
+}
+
 template <typename CFG, typename ALGO>
 void World<CFG, ALGO>::bodyCreated_(Body* body) {
   Aabb<CFG> aabb;
@@ -107,6 +165,34 @@ std::vector<typename World<CFG, ALGO>::DynamicBody*>&
 World<CFG, ALGO>::dynamicBodies() {
   return dynamic_bodies_;
 }
+
+template <typename CFG, typename ALGO>
+std::vector<typename World<CFG, ALGO>::Joint*>& World<CFG, ALGO>::joints() {
+  return joints_;
+}
+
+template <typename CFG, typename ALGO>
+typename World<CFG, ALGO>::ManifoldReuse& World<CFG, ALGO>::manifoldReuse() {
+  return collision_world_.manifold_reuse;
+}
+
+template <typename CFG, typename ALGO>
+typename World<CFG, ALGO>::Solver& World<CFG, ALGO>::solver() {
+  return solver_;
+}
+
+template <typename CFG, typename ALGO>
+template <typename VISIT_T>
+void World<CFG, ALGO>::visitIslandStats(VISIT_T visit) const {
+  for(auto const& stats : solver_.islandStats()) {
+    visit(stats);
+  }
+  for(auto const& solver : thread_solvers_) {
+    for(auto const& stats : solver.islandStats()) {
+      visit(stats);
+    }
+  }
+}
 }
 
 #endif
\ No newline at end of file
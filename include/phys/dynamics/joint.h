@@ -0,0 +1,123 @@
+#ifndef PHYS_LIB_DYNAMICS_JOINT_H
+#define PHYS_LIB_DYNAMICS_JOINT_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include "phys/dynamics/dynamic_body.h"
+#include "phys/math_types/transform.h"
+
+namespace phys {
+
+// Ties two dynamic bodies together, or one to the world. Joints are created
+// through World::createJoint(), and must be deleted before their bodies.
+//
+// The bodies of a joint end up in the same island, and the solver keeps them
+// where they were relative to each other when the joint was created, save
+// for the motions the joint's type allows.
+template <typename CFG, typename ALGO>
+class Joint {
+ public:
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+  using mat3x3_t = typename CFG::mat3x3_t;
+
+  enum Type {
+    // Keeps the anchors together, the bodies rotating freely around them.
+    BALL_SOCKET,
+
+    // Same, and keeps the bodies' axes aligned, so that they only rotate
+    // around it.
+    HINGE,
+
+    // Keeps the bodies from rotating, and their anchors on a line along the
+    // axis, so that they only slide along it.
+    SLIDER,
+
+    // Keeps the bodies from moving relative to each other at all.
+    FIXED,
+  };
+
+  struct Config {
+    Config(Type type, DynamicBody<CFG, ALGO>* body_0,
+           DynamicBody<CFG, ALGO>* body_1 = nullptr)
+        : type(type), bodies({{body_0, body_1}}) {}
+
+    Type type;
+
+    // The second body may be null, in which case the first one is joined to
+    // the world.
+    std::array<DynamicBody<CFG, ALGO>*, 2> bodies;
+
+    // Where the bodies are joined, and the axis of hinges and sliders, in
+    // world space, as the bodies are when the joint is created.
+    vec3_t anchor = {0, 0, 0};
+    vec3_t axis = {0, 1, 0};
+  };
+
+  Joint(Config const& cfg) : type_(cfg.type), bodies_(cfg.bodies) {
+    assert(bodies_[0]);
+
+    vec3_t axis = normalize(cfg.axis);
+    std::array<Transform<CFG>, 2> transforms;
+    for(int side = 0; side < 2; ++side) {
+      if(bodies_[side]) {
+        transforms[side] = bodies_[side]->getTransform();
+      }
+
+      auto const& rot = transforms[side].getRotationMatrix();
+      os_anchors_[side] = transforms[side].applyInverse(cfg.anchor);
+      os_axes_[side] = transpose(rot) * axis;
+    }
+
+    relative_rotation_ = transpose(transforms[0].getRotationMatrix()) *
+                         transforms[1].getRotationMatrix();
+  }
+
+  Type getType() const {
+    return type_;
+  }
+
+  // Null on the world's side.
+  DynamicBody<CFG, ALGO>* getBody(int side) const {
+    return bodies_[side];
+  }
+
+  // Number of relative motions the joint prevents.
+  int getRowCount() const {
+    switch(type_) {
+      case BALL_SOCKET:
+        return 3;
+      case HINGE:
+      case SLIDER:
+        return 5;
+      case FIXED:
+        return 6;
+    }
+    return 0;
+  }
+
+  Type type_;
+  std::array<DynamicBody<CFG, ALGO>*, 2> bodies_;
+
+  // Anchor and axis in each body's space, the world's space for a null
+  // body.
+  std::array<vec3_t, 2> os_anchors_;
+  std::array<vec3_t, 2> os_axes_;
+
+  // Rotation of the second body in the first one's space, at creation.
+  mat3x3_t relative_rotation_;
+
+  // Impulses of each row at the end of the last step, for warm starting.
+  std::array<real_t, 6> applied_impulses_ = {};
+
+  // Island of its first body, as of the last step.
+  uint32_t island_id_ = 0;
+
+  // Index in the dynamic world table
+  std::size_t world_index_ = 0;
+};
+}
+
+#endif
\ No newline at end of file
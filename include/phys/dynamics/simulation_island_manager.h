@@ -3,6 +3,7 @@
 
 #include "phys/collision/collision_world.h"
 #include "phys/util_types/array_view.h"
+#include "phys/util_types/thread_pool.h"
 
 #include <algorithm>
 
@@ -16,19 +17,168 @@ struct IslandMapping {
 template <typename CFG>
 class SimulationIslandManager {
  public:
+  enum {
+    // Below this estimated cost, solving the islands is not worth
+    // dispatching to the thread pool.
+    min_parallel_island_cost = 256,
+
+    // Consecutive islands are visited together as long as their combined
+    // cost stays below this, so that small ones do not each pay for a full
+    // solver run.
+    max_merged_island_cost = 64,
+  };
+
   // Building and visiting must be a single function
   // because adding or removing objects to the world between
   // these two steps is undefined.
-  template <typename COLLISIONS, typename BODY_T, typename VISIT_T>
+  //
+  // Small islands are merged, see max_merged_island_cost, so a single visit
+  // may cover several of them, their collisions and joints sorted by
+  // island_id_.
+  template <typename COLLISIONS, typename BODY_T, typename JOINT_T,
+            typename VISIT_T>
   void buildAndVisitIslands(COLLISIONS& collisions_set,
-                            std::vector<BODY_T*>& bodies, VISIT_T visitor) {
+                            std::vector<BODY_T*>& bodies,
+                            std::vector<JOINT_T*>& joints, VISIT_T visitor) {
+    if(!collectIslands_(collisions_set, bodies, joints)) {
+      return;
+    }
+
+    for(auto const& island : islands_) {
+      visitor(getObjects_(bodies, island), getCollisions_(island),
+              getJoints_(joints, island));
+    }
+  }
+
+  // Same as above, but spreads the islands across a thread pool.
+  // visitor(objects, collisions, joints, thread_index, island_pool) may be
+  // called concurrently for different islands, thread_index being the pool's.
+  // island_pool is the thread pool when the visit has it all to itself, and
+  // can split the island's work further, and null otherwise.
+  //
+  // Islands are handed out from the most expensive one to the least, so that
+  // the big ones do not end up starting last, while the small ones fill in
+  // the gaps. Islands for which split(contact_count, joint_count) is true
+  // are visited first, one at a time, with the whole pool. contact_count
+  // counts the collisions' points. Merged islands are never split.
+  template <typename COLLISIONS, typename BODY_T, typename JOINT_T,
+            typename SPLIT_T, typename VISIT_T>
+  void buildAndVisitIslands(COLLISIONS& collisions_set,
+                            std::vector<BODY_T*>& bodies,
+                            std::vector<JOINT_T*>& joints,
+                            ThreadPool* thread_pool, SPLIT_T split,
+                            VISIT_T visitor) {
+    if(!collectIslands_(collisions_set, bodies, joints)) {
+      return;
+    }
+
+    std::size_t total_cost = 0;
+    for(auto const& island : islands_) {
+      total_cost += island.cost;
+    }
+
+    if(!thread_pool || thread_pool->threadCount() == 1 ||
+       islands_.size() == 1 || total_cost < min_parallel_island_cost) {
+      for(auto const& island : islands_) {
+        visitor(getObjects_(bodies, island), getCollisions_(island),
+                getJoints_(joints, island), 0, thread_pool);
+      }
+      return;
+    }
+
+    island_order_.resize(islands_.size());
+    for(uint32_t i = 0; i < islands_.size(); ++i) {
+      island_order_[i] = i;
+    }
+    std::sort(island_order_.begin(), island_order_.end(),
+              [this](uint32_t lhs, uint32_t rhs) {
+                return islands_[lhs].cost > islands_[rhs].cost;
+              });
+
+    auto split_end = std::stable_partition(
+        island_order_.begin(), island_order_.end(), [&](uint32_t index) {
+          auto const& island = islands_[index];
+          return island.single &&
+                 split(island.contact_count, island.joint_count);
+        });
+    std::size_t split_count = split_end - island_order_.begin();
+    for(std::size_t i = 0; i < split_count; ++i) {
+      auto const& island = islands_[island_order_[i]];
+      visitor(getObjects_(bodies, island), getCollisions_(island),
+              getJoints_(joints, island), 0, thread_pool);
+    }
+
+    thread_pool->parallelFor(
+        island_order_.size() - split_count,
+        [&](std::size_t task, std::size_t thread) {
+          auto const& island = islands_[island_order_[split_count + task]];
+          visitor(getObjects_(bodies, island), getCollisions_(island),
+                  getJoints_(joints, island), thread,
+                  static_cast<ThreadPool*>(nullptr));
+        });
+  }
+
+  template <typename VISITOR_T>
+  void visitIslands(VISITOR_T visit) {
+    int island_start = 0;
+    while(island_start < island_mapping.size()) {
+      int island_id = island_mapping[island_start].island_id;
+      int island_end = island_start + 1;
+      while(island_end < island_mapping.size() &&
+            island_mapping[island_start].island_id == island_id) {
+        ++island_end;
+      }
+
+      int island_size = island_start - island_end;
+
+      ArrayView<>
+
+          island_start = island_end;
+    }
+  }
+
+ private:
+  // Ranges of an island's bodies, collisions and joints, once sorted. After
+  // mergeSmallIslands_(), it may span several islands.
+  struct Island_ {
+    uint32_t bodies_begin;
+    uint32_t bodies_end;
+    uint32_t collisions_begin;
+    uint32_t collisions_end;
+    uint32_t joints_begin;
+    uint32_t joints_end;
+
+    // Rough relative cost of solving the island.
+    std::size_t cost;
+
+    // Summed over the merged islands, see single.
+    std::size_t contact_count;
+    std::size_t joint_count;
+
+    // Whether it covers a single island.
+    bool single;
+  };
+
+  std::vector<IslandMapping> island_mapping;
+  std::vector<Collision<CFG>*> sorted_collisions_;
+  std::vector<Island_> islands_;
+  std::vector<uint32_t> island_order_;
+
+  // Sorts the bodies, collisions and joints by island, and fills islands_.
+  // Returns false if there is nothing to visit.
+  template <typename COLLISIONS, typename BODY_T, typename JOINT_T>
+  bool collectIslands_(COLLISIONS& collisions_set,
+                       std::vector<BODY_T*>& bodies,
+                       std::vector<JOINT_T*>& joints) {
+    islands_.resize(0);
+
     auto obj_count = bodies.size();
     // we assume obj_count > 0 when we disptach islands
     if(obj_count == 0) {
-      return;
+      return false;
     }
 
-    buildIslands_(collisions_set, bodies);
+    buildIslands_(collisions_set, bodies, joints);
 
     // Sort objects in the collision world by island.
     std::sort(bodies.begin(), bodies.end(), [](auto* lhs, auto* rhs) {
@@ -41,7 +191,6 @@ class SimulationIslandManager {
     for(auto& collision : collisions_set) {
       auto* col = &collision.second.collision;
 
-      uint32_t island_id = 0xFFFFFFFF;
       auto dyn_obj = BODY_T::fromCollisionObject(col->objects[0]);
 
       if(!dyn_obj) {
@@ -60,78 +209,108 @@ class SimulationIslandManager {
     std::sort(sorted_collisions_.begin(), sorted_collisions_.end(),
               [](auto* a, auto* b) { return a->island_id_ < b->island_id_; });
 
-    // Bootstrap using the first object.
-    auto island_start = bodies.begin();
-    (*island_start)->world_index_ = 0;
+    // Joints always have a dynamic body first.
+    for(auto* joint : joints) {
+      joint->island_id_ = joint->bodies_[0]->island_id_;
+    }
+    std::sort(joints.begin(), joints.end(), [](auto* lhs, auto* rhs) {
+      return lhs->island_id_ < rhs->island_id_;
+    });
 
-    auto col_start = sorted_collisions_.begin();
+    uint32_t col_index = 0;
+    uint32_t joint_index = 0;
+    uint32_t island_start = 0;
+    while(island_start < obj_count) {
+      auto island_id = bodies[island_start]->island_id_;
 
-    unsigned int current_island = (*island_start)->island_id_;
-    unsigned int i = 1;
-    auto obj = island_start + 1;
-    for(; obj != bodies.end(); ++obj) {
       // Since we sorted that list, we must update the reverse index.
-      (*obj)->world_index_ = i++;
-
-      auto island = (*obj)->island_id_;
-      if(island != current_island) {
-        // Visit the island.
-        auto col_end = col_start;
-        while(col_end != sorted_collisions_.end() &&
-              (*col_end)->island_id_ == current_island) {
-          ++col_end;
-        }
-
-        ArrayView<BODY_T*> objects(island_start, obj);
-        ArrayView<Collision<CFG>*> collisions(col_start, col_end);
-
-        visitor(objects, collisions);
-
-        // reset the process
-        island_start = obj;
-        col_start = col_end;
-        current_island = island;
+      uint32_t island_end = island_start;
+      while(island_end < obj_count &&
+            bodies[island_end]->island_id_ == island_id) {
+        bodies[island_end]->world_index_ = island_end;
+        ++island_end;
       }
-    }
 
-    // Visit the final island.
-    auto col_end = col_start;
-    while(col_end != sorted_collisions_.end() &&
-          (*col_end)->island_id_ == current_island) {
-      ++col_end;
-    }
+      Island_ island;
+      island.bodies_begin = island_start;
+      island.bodies_end = island_end;
+      island.collisions_begin = col_index;
+      island.contact_count = 0;
+      while(col_index < sorted_collisions_.size() &&
+            sorted_collisions_[col_index]->island_id_ == island_id) {
+        island.contact_count += sorted_collisions_[col_index]->points.size();
+        ++col_index;
+      }
+      island.collisions_end = col_index;
+      island.cost = island_end - island_start + island.contact_count;
+
+      island.joints_begin = joint_index;
+      while(joint_index < joints.size() &&
+            joints[joint_index]->island_id_ == island_id) {
+        joints[joint_index]->world_index_ = joint_index;
+        island.cost += joints[joint_index]->getRowCount();
+        ++joint_index;
+      }
+      island.joints_end = joint_index;
+      island.joint_count = joint_index - island.joints_begin;
+      island.single = true;
+      islands_.push_back(island);
 
-    ArrayView<BODY_T*> objs(island_start, obj);
-    ArrayView<Collision<CFG>*> collisions(col_start, col_end);
+      island_start = island_end;
+    }
 
-    visitor(objs, collisions);
+    mergeSmallIslands_();
+    return true;
   }
 
-  template <typename VISITOR_T>
-  void visitIslands(VISITOR_T visit) {
-    int island_start = 0;
-    while(island_start < island_mapping.size()) {
-      int island_id = island_mapping[island_start].island_id;
-      int island_end = island_start + 1;
-      while(island_end < island_mapping.size() &&
-            island_mapping[island_start].island_id == island_id) {
-        ++island_end;
+  // The bodies, collisions and joints of consecutive islands are next to
+  // each other, so merging them only takes extending the ranges. Visitors
+  // can still tell them apart by the collisions' and joints' island_id_.
+  void mergeSmallIslands_() {
+    std::size_t merged_count = 0;
+    for(std::size_t i = 0; i < islands_.size(); ++i) {
+      auto const& island = islands_[i];
+      if(merged_count > 0 &&
+         islands_[merged_count - 1].cost + island.cost <=
+             max_merged_island_cost) {
+        auto& merged = islands_[merged_count - 1];
+        merged.bodies_end = island.bodies_end;
+        merged.collisions_end = island.collisions_end;
+        merged.joints_end = island.joints_end;
+        merged.cost += island.cost;
+        merged.contact_count += island.contact_count;
+        merged.joint_count += island.joint_count;
+        merged.single = false;
+      } else {
+        islands_[merged_count++] = island;
       }
+    }
+    islands_.resize(merged_count);
+  }
 
-      int island_size = island_start - island_end;
-
-      ArrayView<>
+  template <typename BODY_T>
+  static ArrayView<BODY_T*> getObjects_(std::vector<BODY_T*>& bodies,
+                                        Island_ const& island) {
+    return ArrayView<BODY_T*>(bodies.data() + island.bodies_begin,
+                              island.bodies_end - island.bodies_begin);
+  }
 
-          island_start = island_end;
-    }
+  ArrayView<Collision<CFG>*> getCollisions_(Island_ const& island) {
+    return ArrayView<Collision<CFG>*>(
+        sorted_collisions_.data() + island.collisions_begin,
+        island.collisions_end - island.collisions_begin);
   }
 
- private:
-  std::vector<IslandMapping> island_mapping;
-  std::vector<Collision<CFG>*> sorted_collisions_;
+  template <typename JOINT_T>
+  static ArrayView<JOINT_T*> getJoints_(std::vector<JOINT_T*>& joints,
+                                        Island_ const& island) {
+    return ArrayView<JOINT_T*>(joints.data() + island.joints_begin,
+                               island.joints_end - island.joints_begin);
+  }
 
-  template <typename COLLISIONS, typename BODY_T>
-  void buildIslands_(COLLISIONS& collisions, std::vector<BODY_T*>& bodies) {
+  template <typename COLLISIONS, typename BODY_T, typename JOINT_T>
+  void buildIslands_(COLLISIONS& collisions, std::vector<BODY_T*>& bodies,
+                     std::vector<JOINT_T*> const& joints) {
     uint32_t obj_count = uint32_t(bodies.size());
 
     island_mapping.resize(obj_count);
@@ -157,6 +336,15 @@ class SimulationIslandManager {
       }
     }
 
+    // And joints, the ones to the world being like collisions with static
+    // objects.
+    for(auto* joint : joints) {
+      if(joint->bodies_[1]) {
+        joinIslands_(joint->bodies_[0]->island_id_,
+                     joint->bodies_[1]->island_id_);
+      }
+    }
+
     // Assign final island ids to objects.
     for(uint32_t i = 0; i < obj_count; ++i) {
       bodies[i]->island_id_ = findIsland_(i);
@@ -189,4 +377,4 @@ class SimulationIslandManager {
 };
 }
 
-#endif
+#endif
\ No newline at end of file
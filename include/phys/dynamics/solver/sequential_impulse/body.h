@@ -1,17 +1,46 @@
 #ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_BODY_H
 #define PHYS_SEQUENTIAL_INPUT_SOLVER_BODY_H
 
+#include <vector>
 #include "phys/dynamics/dynamic_body.h"
 #include "phys/math_types/transform.h"
+#include "phys/util_types/aligned_allocator.h"
 
 namespace phys {
 namespace seqi_solver {
 
+// Velocities the iterations add to a body, which is all they read and write
+// about it. The solver keeps them apart from the rest of Body, in arrays
+// indexed like its bodies, so that each iteration only goes through
+// sizeof(BodyDelta) bytes per body. With float, that is 32 bytes, and the
+// alignment keeps them from straddling cache lines, see BodyDeltas.
+template <typename CFG>
+struct alignas(32) BodyDelta {
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+
+  vec3_t linear = {0, 0, 0};
+  vec3_t angular = {0, 0, 0};
+
+  void applyImpulse(vec3_t const& lin, vec3_t const& ang, real_t mag) {
+    linear += lin * mag;
+    angular += ang * mag;
+  }
+};
+
+// std::vector only honors BodyDelta's alignment from C++17 onwards.
+template <typename CFG>
+using BodyDeltas =
+    std::vector<BodyDelta<CFG>, AlignedAllocator<BodyDelta<CFG>>>;
+
+// What the solver needs about a body to set up its constraints, and to write
+// the results back.
 template <typename CFG>
 struct Body {
   using vec3_t = typename CFG::vec3_t;
   using real_t = typename CFG::real_t;
 
+  // Static objects share a default constructed body.
   Body() {}
   Body(DynamicBodyData<CFG>* tgt, real_t dt) {
     target = tgt;
@@ -38,40 +67,27 @@ struct Body {
   vec3_t applied_force_impulse = {0, 0, 0};
   vec3_t applied_torque_impulse = {0, 0, 0};
 
-  vec3_t delta_v = {0, 0, 0};
-  vec3_t delta_w = {0, 0, 0};
-
-  // Contact penetration related.
-  vec3_t push_vel = {0, 0, 0};
-  vec3_t turn_vel = {0, 0, 0};
+  // Whether contacts pushed the body out of a penetration, in which case it
+  // is moved by its push velocities.
   bool push_applied = false;
 
-  void applyPushImpulse(vec3_t const& lin, vec3_t const& ang, real_t mag) {
-    push_vel += lin * mag;
-    turn_vel += ang * mag;
-    push_applied = true;
-  }
-
-  void applyImpulse(vec3_t const& lin, vec3_t const& ang, real_t mag) {
-    delta_v += lin * mag;
-    delta_w += ang * mag;
-  }
-
   vec3_t getRelativeVelocity(vec3_t const& p) const {
     return linear_velocity + applied_force_impulse +
            cross(angular_velocity + applied_torque_impulse, p);
   }
 
-  void finish(real_t dt, real_t turn_erp) {
-    linear_velocity += delta_v;
-    angular_velocity += delta_w;
+  // delta and push are the body's velocity deltas and push velocities.
+  void finish(real_t dt, real_t turn_erp, BodyDelta<CFG> const& delta,
+              BodyDelta<CFG> const& push) {
+    linear_velocity += delta.linear;
+    angular_velocity += delta.angular;
 
     target->linear_velocity_ = linear_velocity + applied_force_impulse;
     target->angular_velocity_ = angular_velocity + applied_torque_impulse;
 
     if(push_applied) {
-      integrateTransform(world_transform, push_vel, turn_vel * turn_erp, dt,
-                         target->transform);
+      integrateTransform(world_transform, push.linear, push.angular * turn_erp,
+                         dt, target->transform);
     }
   }
 };
@@ -1,25 +1,65 @@
 #ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_CONFIG_H
 #define PHYS_SEQUENTIAL_INPUT_SOLVER_CONFIG_H
 
+#include <cstddef>
+
 namespace phys {
 namespace seqi_solver {
 template <typename CFG>
 struct Config {
   using real_t = typename CFG::real_t;
 
-  // Number of iterations to perform.
+  // Most iterations to perform on each island.
   int iterations = 10;
 
-  // Number of iterations to perform for penetration resolving
+  // Most iterations to perform on each island for penetration resolving.
   int penetration_iterations = 10;
 
-  real_t residual_threshold = 0.0f;
+  // Each island stops iterating once an iteration changes its impulses by
+  // less than this fraction of the impulses themselves, see
+  // Solver::IslandStats. Islands that are at rest, or that warm starting
+  // already got close, then only spend a couple of iterations out of their
+  // budget. Around 1e-2 works well. The default, 0, always runs all of the
+  // iterations.
+  real_t residual_threshold = real_t(0);
 
   real_t erp = real_t(0.2);
   real_t cfm = real_t(0.0);
 
   real_t split_impulse_penetration_threshold = real_t(-0.04);
   real_t split_impulse_turn_erp = real_t(0.1);
+
+  // Contacts start from this fraction of the impulse they ended the previous
+  // step with, which saves most of the iterations resting contacts would
+  // otherwise spend building it back up. 0 disables it.
+  real_t warm_start_factor = real_t(0.85);
+
+  // Solves the normal impulses of each collision's contacts together, see
+  // ContactBlock. Manifolds then settle in a few iterations instead of
+  // slowly converging on how to share the load, so fewer iterations are
+  // needed. Batched islands ignore it.
+  bool block_contacts = false;
+
+  // Solves contacts from the ground up, and ends with one more pass where
+  // the lower body of each contact is treated as infinitely heavy. Tall
+  // stacks then hold with a few iterations, instead of waiting for impulses
+  // to travel all the way up. Batched islands ignore it.
+  bool shock_propagation = false;
+
+  // Solves contacts in groups of independent ones, see ContactBatches. It
+  // only pays off on islands with enough contacts to fill the groups.
+  bool batch_contacts = false;
+  std::size_t min_batched_contacts = 32;
+
+  // Islands with at least this many contacts are batched whatever
+  // batch_contacts says, and have each color's groups spread across the
+  // thread pool, when one is given to Solver::solve(). The results do not
+  // depend on the number of threads. 0 disables it.
+  //
+  // The batches know nothing about joints, so islands with any joint are
+  // never split, however many contacts they have. They are solved on a
+  // single thread, like the islands below the threshold.
+  std::size_t min_parallel_contacts = 2048;
 };
 }
 }
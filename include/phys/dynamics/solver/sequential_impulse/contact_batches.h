@@ -0,0 +1,700 @@
+#ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_CONTACT_BATCHES_H
+#define PHYS_SEQUENTIAL_INPUT_SOLVER_CONTACT_BATCHES_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "phys/dynamics/solver/sequential_impulse/body.h"
+#include "phys/dynamics/solver/sequential_impulse/contact_constraint.h"
+#include "phys/dynamics/solver/sequential_impulse/friction_constraint.h"
+#include "phys/util_types/thread_pool.h"
+
+namespace phys {
+namespace seqi_solver {
+
+// Solves contact constraints several at a time.
+//
+// Contacts are colored so that no body appears twice within a color, and each
+// color is split in groups of a fixed number of lanes. Since the contacts of
+// a group are independent from each other, solving them side by side gives
+// the same result as solving them one after the other. Each group's data is
+// laid out one component per array, and its bodies' velocities are gathered
+// from compact rows in the same way, so that the solving itself is made of
+// straight loops over the lanes that compilers vectorize.
+//
+// Friction constraints are colored and grouped the same way, with each of
+// their rows laid out one component per array as well.
+template <typename CFG>
+class ContactBatches {
+ public:
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    // Lanes per group. 8 floats fill an AVX register.
+    width = 8,
+
+    // Colors are tracked with a 64 bit mask per body. Contacts that do not
+    // fit in any of them get a group of their own.
+    max_colors = 64,
+
+    // Groups of a color solved by a single task when spread across threads.
+    groups_per_task = 16,
+  };
+
+  // Sorts the contacts in groups, and takes over the bodies' velocity deltas
+  // and push velocities until store() is called. None of them must be moved
+  // until then. The last entry of deltas and push_deltas is the static
+  // body's, it never moves, so it can appear any number of times within a
+  // group. frictions is optional, and must refer to contacts by their index
+  // in contacts.
+  void build(std::vector<ContactConstraint<CFG>>& contacts,
+             BodyDeltas<CFG>& deltas, BodyDeltas<CFG>& push_deltas,
+             std::vector<FrictionConstraint<CFG>>* frictions = nullptr) {
+    deltas_ = &deltas;
+    push_deltas_ = &push_deltas;
+    static_index_ = uint32_t(deltas.size() - 1);
+
+    velocities_.resize(deltas.size());
+    push_velocities_.resize(deltas.size());
+    for(std::size_t i = 0; i < deltas.size(); ++i) {
+      storeRow_(&velocities_[i], deltas[i].linear, deltas[i].angular);
+      storeRow_(&push_velocities_[i], push_deltas[i].linear,
+                push_deltas[i].angular);
+    }
+
+    contact_lanes_.resize(contacts.size());
+    layOut_(contacts, &groups_, &color_begins_,
+            [this](Group_* group, int l, ContactConstraint<CFG>* contact,
+                   std::size_t i, std::size_t lane) {
+              load_(group, l, contact);
+              contact_lanes_[i] = uint32_t(lane);
+            });
+
+    if(frictions) {
+      layOut_(*frictions, &friction_groups_, &friction_color_begins_,
+              [](FrictionGroup_* group, int l,
+                 FrictionConstraint<CFG>* friction, std::size_t,
+                 std::size_t) { loadFriction_(group, l, friction); });
+    } else {
+      friction_groups_.resize(0);
+      friction_color_begins_.fill(0);
+    }
+  }
+
+  // Same as Solver::solvePenetration_(), on all groups. Returns the sum of
+  // the squared changes of the impulses.
+  //
+  // With a thread pool, the groups of each color are spread across its
+  // threads. The groups are always cut in the same tasks, and their residuals
+  // added up in the same order, so the results do not depend on the number
+  // of threads.
+  real_t solvePenetrations(ThreadPool* thread_pool = nullptr) {
+    return solveColors_(color_begins_, groups_per_task, thread_pool,
+                        [this](std::size_t i, Lanes_* residual) {
+                          solvePenetrations_(groups_[i], residual);
+                        });
+  }
+
+  // Same as Solver::solveContact_(), on all groups. Returns the sum of the
+  // squared changes of the impulses.
+  real_t solveContacts(ThreadPool* thread_pool = nullptr) {
+    return solveColors_(color_begins_, groups_per_task, thread_pool,
+                        [this](std::size_t i, Lanes_* residual) {
+                          solveContacts_(groups_[i], residual);
+                        });
+  }
+
+  // Same as Solver::solveFriction_(), on all frictions given to build().
+  // Returns the sum of the squared changes of the impulses.
+  real_t solveFrictions(ThreadPool* thread_pool = nullptr) {
+    return solveColors_(friction_color_begins_, groups_per_task, thread_pool,
+                        [this](std::size_t i, Lanes_* residual) {
+                          solveFrictions_(friction_groups_[i], residual);
+                        });
+  }
+
+  // Sums of the squares of the contacts' current impulses, of their current
+  // push impulses, and of the frictions' rows' current impulses.
+  real_t squaredImpulses() const {
+    Lanes_ sum = {};
+    for(auto const& group : groups_) {
+      for(int l = 0; l < width; ++l) {
+        sum[l] += group.applied_impulse[l] * group.applied_impulse[l];
+      }
+    }
+    return sum_(sum);
+  }
+
+  real_t squaredPushImpulses() const {
+    Lanes_ sum = {};
+    for(auto const& group : groups_) {
+      for(int l = 0; l < width; ++l) {
+        real_t impulse = group.applied_push_impulse[l];
+        sum[l] += impulse * impulse;
+      }
+    }
+    return sum_(sum);
+  }
+
+  real_t squaredFrictionImpulses() const {
+    Lanes_ sum = {};
+    for(auto const& group : friction_groups_) {
+      for(auto const& row : group.rows) {
+        for(int l = 0; l < width; ++l) {
+          sum[l] += row.applied_impulse[l] * row.applied_impulse[l];
+        }
+      }
+    }
+    return sum_(sum);
+  }
+
+  // Writes the applied impulses back to the contacts and frictions, and the
+  // velocities back to the bodies' deltas.
+  void store() {
+    for(auto& group : groups_) {
+      for(int l = 0; l < width; ++l) {
+        auto contact = group.contacts[l];
+        if(!contact) {
+          continue;
+        }
+
+        contact->applied_impulse = group.applied_impulse[l];
+        contact->applied_push_impulse = group.applied_push_impulse[l];
+      }
+    }
+
+    for(auto& group : friction_groups_) {
+      for(int l = 0; l < width; ++l) {
+        auto friction = group.frictions[l];
+        if(!friction) {
+          continue;
+        }
+
+        for(int r = 0; r < row_count_; ++r) {
+          friction->rows[r].applied_impulse = group.rows[r].applied_impulse[l];
+        }
+      }
+    }
+
+    for(uint32_t i = 0; i < static_index_; ++i) {
+      loadRow_(velocities_[i], &(*deltas_)[i].linear, &(*deltas_)[i].angular);
+      loadRow_(push_velocities_[i], &(*push_deltas_)[i].linear,
+               &(*push_deltas_)[i].angular);
+    }
+  }
+
+ private:
+  using Lanes_ = std::array<real_t, width>;
+
+  // A body's linear and angular velocities, padded to 8 values.
+  using Row_ = std::array<real_t, 8>;
+
+  // Rows of the bodies' velocities.
+  using Bodies_ = std::array<std::array<uint32_t, width>, 2>;
+
+  struct Group_ {
+    // Null in padding lanes.
+    std::array<ContactConstraint<CFG>*, width> contacts;
+
+    Bodies_ bodies;
+
+    // Per body, see ContactConstraint.
+    std::array<std::array<Lanes_, 3>, 2> normal;
+    std::array<std::array<Lanes_, 3>, 2> angular_component;
+    std::array<std::array<Lanes_, 3>, 2> relpos_cross_normal;
+    std::array<Lanes_, 2> inv_mass;
+
+    Lanes_ jac_diag_ab_inv;
+    Lanes_ cfm;
+    Lanes_ impulse;
+    Lanes_ applied_impulse;
+    Lanes_ penetration_impulse;
+    Lanes_ applied_push_impulse;
+  };
+
+  enum { row_count_ = FrictionConstraint<CFG>::row_count };
+
+  // Per body, see FrictionConstraint::Row.
+  struct FrictionRow_ {
+    std::array<std::array<Lanes_, 3>, 2> linear;
+    std::array<std::array<Lanes_, 3>, 2> relpos_cross;
+    std::array<std::array<Lanes_, 3>, 2> angular_component;
+
+    Lanes_ jac_diag_inv;
+    Lanes_ rhs;
+    Lanes_ applied_impulse;
+  };
+
+  struct FrictionGroup_ {
+    // Null in padding lanes, which have no friction and no twist radius, so
+    // that they never apply anything.
+    std::array<FrictionConstraint<CFG>*, width> frictions;
+
+    Bodies_ bodies;
+    std::array<Lanes_, 2> inv_mass;
+    Lanes_ friction;
+    Lanes_ twist_radius;
+    std::array<FrictionRow_, row_count_> rows;
+  };
+
+  // Linear and angular velocities of a group's bodies.
+  struct Velocities_ {
+    std::array<std::array<Lanes_, 3>, 2> linear;
+    std::array<std::array<Lanes_, 3>, 2> angular;
+  };
+
+  // Index of the first item of each color, and of the ones that did not fit
+  // in any.
+  using ColorBegins_ = std::array<std::size_t, max_colors + 2>;
+
+  // Groups sorted by color, followed by the ones that did not fit in any.
+  std::vector<Group_> groups_;
+
+  ColorBegins_ color_begins_ = {};
+
+  // Compact copies of the bodies' velocity deltas and push velocities, the
+  // static body's row comes last.
+  std::vector<Row_> velocities_;
+  std::vector<Row_> push_velocities_;
+  BodyDeltas<CFG>* deltas_ = nullptr;
+  BodyDeltas<CFG>* push_deltas_ = nullptr;
+  uint32_t static_index_ = 0;
+
+  // Lane of each contact, across all groups.
+  std::vector<uint32_t> contact_lanes_;
+
+  // Friction groups sorted by color, followed by the ones that did not fit
+  // in any.
+  std::vector<FrictionGroup_> friction_groups_;
+  ColorBegins_ friction_color_begins_ = {};
+
+  // Scratch data for build(), kept around to avoid reallocating every frame.
+  std::vector<uint64_t> body_colors_;
+  std::vector<uint32_t> item_colors_;
+
+  // Residuals of each task of the color being solved.
+  std::vector<Lanes_> task_residuals_;
+
+  // Colors items, and sorts them in groups by color. Every color starts a
+  // new group, and its last one is padded with lanes that do nothing, whose
+  // item pointers are null and whose bodies are the static one. Each item is
+  // then loaded with load(group, lane_in_group, item, index, lane).
+  template <typename ITEM_T, typename GROUP_T, typename LOAD_T>
+  void layOut_(std::vector<ITEM_T>& items, std::vector<GROUP_T>* groups,
+               ColorBegins_* color_begins, LOAD_T const& load) {
+    body_colors_.assign(static_index_ + 1, 0);
+    item_colors_.resize(items.size());
+    std::array<std::size_t, max_colors + 1> color_sizes = {};
+
+    for(std::size_t i = 0; i < items.size(); ++i) {
+      auto const& bodies_i = items[i].solver_bodies_;
+      auto color = pickColor_(bodies_i[0], bodies_i[1]);
+      item_colors_[i] = color;
+      ++color_sizes[color];
+    }
+
+    std::array<std::size_t, max_colors + 1> next_lane;
+    std::size_t group_count = 0;
+    for(int color = 0; color < max_colors; ++color) {
+      next_lane[color] = group_count * width;
+      group_count += (color_sizes[color] + width - 1) / width;
+    }
+    next_lane[max_colors] = group_count * width;
+    group_count += color_sizes[max_colors];
+
+    for(int color = 0; color <= max_colors; ++color) {
+      (*color_begins)[color] = next_lane[color] / width;
+    }
+    (*color_begins)[max_colors + 1] = group_count;
+
+    groups->resize(group_count);
+    for(auto& group : *groups) {
+      group = GROUP_T();
+      group.bodies[0].fill(static_index_);
+      group.bodies[1].fill(static_index_);
+    }
+
+    for(std::size_t i = 0; i < items.size(); ++i) {
+      auto color = item_colors_[i];
+      auto lane = next_lane[color];
+      next_lane[color] += color == max_colors ? width : 1;
+      load(&(*groups)[lane / width], int(lane % width), &items[i], i, lane);
+    }
+  }
+
+  // Lowest color that neither body uses yet, or max_colors if there is none
+  // left. The bodies are then marked as using it.
+  uint32_t pickColor_(uint32_t index_0, uint32_t index_1) {
+    uint64_t used = body_colors_[index_0] | body_colors_[index_1];
+
+    uint32_t color = 0;
+    while(color < max_colors && (used & (uint64_t(1) << color))) {
+      ++color;
+    }
+
+    if(color < max_colors) {
+      if(index_0 != static_index_) {
+        body_colors_[index_0] |= uint64_t(1) << color;
+      }
+      if(index_1 != static_index_) {
+        body_colors_[index_1] |= uint64_t(1) << color;
+      }
+    }
+    return color;
+  }
+
+  static void storeRow_(Row_* row, vec3_t const& linear,
+                        vec3_t const& angular) {
+    *row = Row_();
+    for(int c = 0; c < 3; ++c) {
+      (*row)[c] = linear[c];
+      (*row)[4 + c] = angular[c];
+    }
+  }
+
+  static void loadRow_(Row_ const& row, vec3_t* linear, vec3_t* angular) {
+    for(int c = 0; c < 3; ++c) {
+      (*linear)[c] = row[c];
+      (*angular)[c] = row[4 + c];
+    }
+  }
+
+  static void load_(Group_* group, int l, ContactConstraint<CFG>* contact) {
+    group->contacts[l] = contact;
+    for(int side = 0; side < 2; ++side) {
+      group->bodies[side][l] = contact->solver_bodies_[side];
+      group->inv_mass[side][l] = contact->inv_mass[side];
+      for(int c = 0; c < 3; ++c) {
+        group->normal[side][c][l] = contact->normals[side][c];
+        group->angular_component[side][c][l] =
+            contact->angular_component[side][c];
+        group->relpos_cross_normal[side][c][l] =
+            contact->relpos_cross_normal[side][c];
+      }
+    }
+
+    group->jac_diag_ab_inv[l] = contact->jac_diag_ab_inv;
+    group->cfm[l] = contact->cfm;
+    group->impulse[l] = contact->impulse;
+    group->applied_impulse[l] = contact->applied_impulse;
+    group->penetration_impulse[l] = contact->penetration_impulse;
+    group->applied_push_impulse[l] = contact->applied_push_impulse;
+  }
+
+  static void loadFriction_(FrictionGroup_* group, int l,
+                            FrictionConstraint<CFG>* friction) {
+    group->frictions[l] = friction;
+    for(int side = 0; side < 2; ++side) {
+      group->bodies[side][l] = friction->solver_bodies_[side];
+      group->inv_mass[side][l] = friction->inv_mass[side];
+    }
+    group->friction[l] = friction->friction;
+    group->twist_radius[l] = friction->twist_radius;
+
+    for(int r = 0; r < row_count_; ++r) {
+      auto const& row = friction->rows[r];
+      auto& dst = group->rows[r];
+      for(int side = 0; side < 2; ++side) {
+        for(int c = 0; c < 3; ++c) {
+          dst.linear[side][c][l] = row.linear[side][c];
+          dst.relpos_cross[side][c][l] = row.relpos_cross[side][c];
+          dst.angular_component[side][c][l] = row.angular_component[side][c];
+        }
+      }
+      dst.jac_diag_inv[l] = row.jac_diag_inv;
+      dst.rhs[l] = row.rhs;
+      dst.applied_impulse[l] = row.applied_impulse;
+    }
+  }
+
+  void solvePenetrations_(Group_& group, Lanes_* residual) {
+    Velocities_ vel;
+    gather_(group.bodies, push_velocities_, &vel);
+
+    Lanes_ vel_dot_n;
+    dotVelocities_(group, vel, &vel_dot_n);
+
+    Lanes_ d_impulse;
+    for(int l = 0; l < width; ++l) {
+      real_t d = group.penetration_impulse[l] -
+                 group.applied_push_impulse[l] * group.cfm[l];
+      d -= vel_dot_n[l] * group.jac_diag_ab_inv[l];
+
+      // Contacts only push, see ContactConstraint::getLowerLimit().
+      real_t applied = group.applied_push_impulse[l];
+      real_t new_impulse = applied + d;
+      d = new_impulse < 0 ? -applied : d;
+      new_impulse = new_impulse < 0 ? 0 : new_impulse;
+
+      // Only contacts that are penetrating deep enough get pushed apart.
+      bool active = group.penetration_impulse[l] != 0;
+      d_impulse[l] = active ? d : 0;
+      group.applied_push_impulse[l] = active ? new_impulse : applied;
+      (*residual)[l] += d_impulse[l] * d_impulse[l];
+    }
+
+    apply_(group, d_impulse, &vel);
+    scatter_(group.bodies, vel, &push_velocities_);
+  }
+
+  void solveContacts_(Group_& group, Lanes_* residual) {
+    Velocities_ vel;
+    gather_(group.bodies, velocities_, &vel);
+
+    Lanes_ vel_dot_n;
+    dotVelocities_(group, vel, &vel_dot_n);
+
+    Lanes_ d_impulse;
+    for(int l = 0; l < width; ++l) {
+      real_t d = group.impulse[l] - group.applied_impulse[l] * group.cfm[l];
+      d -= vel_dot_n[l] * group.jac_diag_ab_inv[l];
+
+      real_t applied = group.applied_impulse[l];
+      real_t new_impulse = applied + d;
+      d = new_impulse < 0 ? -applied : d;
+      new_impulse = new_impulse < 0 ? 0 : new_impulse;
+
+      d_impulse[l] = d;
+      group.applied_impulse[l] = new_impulse;
+      (*residual)[l] += d * d;
+    }
+
+    apply_(group, d_impulse, &vel);
+    scatter_(group.bodies, vel, &velocities_);
+  }
+
+  // Same as FrictionConstraint::solve(), lane by lane.
+  void solveFrictions_(FrictionGroup_& group, Lanes_* residual) {
+    Velocities_ vel;
+    gather_(group.bodies, velocities_, &vel);
+
+    // The normal impulses come from the contacts' lanes, which are solved by
+    // then.
+    Lanes_ limit;
+    for(int l = 0; l < width; ++l) {
+      auto friction = group.frictions[l];
+      real_t normal_impulse = 0;
+      if(friction) {
+        for(auto i = friction->contacts_begin; i < friction->contacts_end;
+            ++i) {
+          auto lane = contact_lanes_[i];
+          normal_impulse += groups_[lane / width].applied_impulse[lane % width];
+        }
+      }
+      limit[l] = group.friction[l] * normal_impulse;
+    }
+
+    // Both tangents are solved against the same velocities, and their
+    // impulses clamped together to a disc.
+    std::array<Lanes_, 2> new_impulse;
+    for(int i = 0; i < 2; ++i) {
+      auto const& row = group.rows[FrictionConstraint<CFG>::TANGENT_0 + i];
+      Lanes_ row_vel;
+      dotRow_(row, vel, &row_vel);
+      for(int l = 0; l < width; ++l) {
+        new_impulse[i][l] = row.applied_impulse[l] + row.rhs[l] -
+                            row_vel[l] * row.jac_diag_inv[l];
+      }
+    }
+
+    for(int l = 0; l < width; ++l) {
+      real_t len_sq = new_impulse[0][l] * new_impulse[0][l] +
+                      new_impulse[1][l] * new_impulse[1][l];
+      real_t scale = real_t(1);
+      if(len_sq > limit[l] * limit[l]) {
+        scale = limit[l] > 0 ? limit[l] / std::sqrt(len_sq) : real_t(0);
+      }
+      new_impulse[0][l] *= scale;
+      new_impulse[1][l] *= scale;
+    }
+
+    for(int i = 0; i < 2; ++i) {
+      auto& row = group.rows[FrictionConstraint<CFG>::TANGENT_0 + i];
+      Lanes_ d_impulse;
+      for(int l = 0; l < width; ++l) {
+        d_impulse[l] = new_impulse[i][l] - row.applied_impulse[l];
+        row.applied_impulse[l] = new_impulse[i][l];
+        (*residual)[l] += d_impulse[l] * d_impulse[l];
+      }
+      applyRow_(row, group.inv_mass, d_impulse, &vel);
+    }
+
+    // Single points, such as most of the ones involving spheres, cannot
+    // resist twisting.
+    auto& twist = group.rows[FrictionConstraint<CFG>::TWIST];
+    Lanes_ twist_vel;
+    dotRow_(twist, vel, &twist_vel);
+
+    Lanes_ d_impulse;
+    for(int l = 0; l < width; ++l) {
+      real_t twist_limit = limit[l] * group.twist_radius[l];
+      real_t applied = twist.applied_impulse[l];
+      real_t impulse =
+          applied + twist.rhs[l] - twist_vel[l] * twist.jac_diag_inv[l];
+      impulse = std::min(std::max(impulse, -twist_limit), twist_limit);
+
+      bool active = group.twist_radius[l] != 0;
+      d_impulse[l] = active ? impulse - applied : 0;
+      twist.applied_impulse[l] = active ? impulse : applied;
+      (*residual)[l] += d_impulse[l] * d_impulse[l];
+    }
+    applyRow_(twist, group.inv_mass, d_impulse, &vel);
+
+    scatter_(group.bodies, vel, &velocities_);
+  }
+
+  // Runs solve_item(index, residual) on every index of the ranges given by
+  // color_begins, color by color.
+  template <typename FN_T>
+  real_t solveColors_(ColorBegins_ const& color_begins,
+                      std::size_t items_per_task, ThreadPool* thread_pool,
+                      FN_T const& solve_item) {
+    Lanes_ residual = {};
+    for(int color = 0; color <= max_colors; ++color) {
+      std::size_t begin = color_begins[color];
+      std::size_t end = color_begins[color + 1];
+      if(begin == end) {
+        continue;
+      }
+
+      // The items of the last color share bodies, they must be solved one
+      // after the other.
+      std::size_t task_size = color == max_colors ? end - begin
+                                                  : items_per_task;
+      std::size_t task_count = (end - begin + task_size - 1) / task_size;
+      task_residuals_.assign(task_count, Lanes_());
+
+      auto solve_task = [&](std::size_t task, std::size_t) {
+        std::size_t task_begin = begin + task * task_size;
+        std::size_t task_end = std::min(end, task_begin + task_size);
+        for(std::size_t i = task_begin; i < task_end; ++i) {
+          solve_item(i, &task_residuals_[task]);
+        }
+      };
+
+      if(thread_pool && task_count > 1) {
+        thread_pool->parallelFor(task_count, solve_task);
+      } else {
+        for(std::size_t task = 0; task < task_count; ++task) {
+          solve_task(task, 0);
+        }
+      }
+
+      for(auto const& task_residual : task_residuals_) {
+        for(int l = 0; l < width; ++l) {
+          residual[l] += task_residual[l];
+        }
+      }
+    }
+    return sum_(residual);
+  }
+
+  static void gather_(Bodies_ const& bodies, std::vector<Row_> const& rows,
+                      Velocities_* vel) {
+    for(int side = 0; side < 2; ++side) {
+      for(int l = 0; l < width; ++l) {
+        auto const& row = rows[bodies[side][l]];
+        for(int c = 0; c < 3; ++c) {
+          vel->linear[side][c][l] = row[c];
+          vel->angular[side][c][l] = row[4 + c];
+        }
+      }
+    }
+  }
+
+  // Bodies appear at most once per group, so the order in which they are
+  // written back does not matter. The static body's row is shared by groups
+  // that may be solved concurrently, and always stays at zero, so it is
+  // left alone.
+  void scatter_(Bodies_ const& bodies, Velocities_ const& vel,
+                std::vector<Row_>* rows) const {
+    for(int side = 0; side < 2; ++side) {
+      for(int l = 0; l < width; ++l) {
+        auto index = bodies[side][l];
+        if(index == static_index_) {
+          continue;
+        }
+
+        auto& row = (*rows)[index];
+        for(int c = 0; c < 3; ++c) {
+          row[c] = vel.linear[side][c][l];
+          row[4 + c] = vel.angular[side][c][l];
+        }
+      }
+    }
+  }
+
+  // Velocities of both bodies along the contacts' jacobians.
+  static void dotVelocities_(Group_ const& group, Velocities_ const& vel,
+                             Lanes_* result) {
+    result->fill(0);
+    for(int side = 0; side < 2; ++side) {
+      for(int c = 0; c < 3; ++c) {
+        for(int l = 0; l < width; ++l) {
+          (*result)[l] +=
+              group.normal[side][c][l] * vel.linear[side][c][l] +
+              group.relpos_cross_normal[side][c][l] * vel.angular[side][c][l];
+        }
+      }
+    }
+  }
+
+  static void apply_(Group_ const& group, Lanes_ const& d_impulse,
+                     Velocities_* vel) {
+    for(int side = 0; side < 2; ++side) {
+      for(int c = 0; c < 3; ++c) {
+        for(int l = 0; l < width; ++l) {
+          vel->linear[side][c][l] += group.normal[side][c][l] *
+                                     group.inv_mass[side][l] * d_impulse[l];
+          vel->angular[side][c][l] +=
+              group.angular_component[side][c][l] * d_impulse[l];
+        }
+      }
+    }
+  }
+
+  // Velocities of both bodies along a friction row's jacobian.
+  static void dotRow_(FrictionRow_ const& row, Velocities_ const& vel,
+                      Lanes_* result) {
+    result->fill(0);
+    for(int side = 0; side < 2; ++side) {
+      for(int c = 0; c < 3; ++c) {
+        for(int l = 0; l < width; ++l) {
+          (*result)[l] +=
+              row.linear[side][c][l] * vel.linear[side][c][l] +
+              row.relpos_cross[side][c][l] * vel.angular[side][c][l];
+        }
+      }
+    }
+  }
+
+  static void applyRow_(FrictionRow_ const& row,
+                        std::array<Lanes_, 2> const& inv_mass,
+                        Lanes_ const& d_impulse, Velocities_* vel) {
+    for(int side = 0; side < 2; ++side) {
+      for(int c = 0; c < 3; ++c) {
+        for(int l = 0; l < width; ++l) {
+          vel->linear[side][c][l] += row.linear[side][c][l] *
+                                     inv_mass[side][l] * d_impulse[l];
+          vel->angular[side][c][l] +=
+              row.angular_component[side][c][l] * d_impulse[l];
+        }
+      }
+    }
+  }
+
+  static real_t sum_(Lanes_ const& lanes) {
+    real_t result = 0;
+    for(auto value : lanes) {
+      result += value;
+    }
+    return result;
+  }
+};
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+#ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_CONTACT_BLOCK_H
+#define PHYS_SEQUENTIAL_INPUT_SOLVER_CONTACT_BLOCK_H
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "phys/dynamics/solver/sequential_impulse/contact_constraint.h"
+
+namespace phys {
+namespace seqi_solver {
+
+// The contacts of a collision, whose normal impulses are solved together.
+//
+// Solved one by one, the contacts of a manifold keep undoing part of what the
+// others did, and take many iterations to settle on how to share the load.
+// A block instead finds all of their impulses at once, as the linear
+// complementarity problem:
+//
+//   w = mass * x - q,  x >= 0,  w >= 0,  x_i * w_i = 0
+//
+// where x are the new impulses, and w the velocities they leave along the
+// normals past what the contacts aim for.
+template <typename CFG>
+struct ContactBlock {
+  using real_t = typename CFG::real_t;
+
+  enum { max_size = CFG::max_contact_points_per_collision };
+
+  ContactBlock() {}
+
+  // The collision's contacts are contacts[contacts_begin, contacts_end).
+  ContactBlock(ContactConstraint<CFG> const* contacts, uint32_t contacts_begin,
+               uint32_t contacts_end)
+      : contacts_begin(contacts_begin), contacts_end(contacts_end) {
+    auto count = size();
+    assert(count <= max_size);
+
+    // Added to the diagonal, relative to it. Four points on a face only give
+    // three independent directions to push along, which leaves the matrix
+    // singular otherwise. Since the solver's q includes mass times the
+    // current impulses, this only slows down changes of the impulses, and
+    // does not change what they converge to.
+    real_t regularization = real_t(1e-3);
+
+    for(uint32_t i = 0; i < count; ++i) {
+      auto const& c_i = contacts[contacts_begin + i];
+      for(uint32_t j = 0; j < count; ++j) {
+        auto const& c_j = contacts[contacts_begin + j];
+
+        real_t k = 0;
+        if(i == j) {
+          // Includes the cfm.
+          k = (real_t(1) + regularization) / c_i.jac_diag_ab_inv;
+        } else {
+          // Static sides have no normal, nor angular component.
+          for(int side = 0; side < 2; ++side) {
+            k += dot(c_i.normals[side], c_j.normals[side]) *
+                     c_i.inv_mass[side] +
+                 dot(c_i.relpos_cross_normal[side],
+                     c_j.angular_component[side]);
+          }
+        }
+        mass[i * max_size + j] = k;
+      }
+    }
+  }
+
+  uint32_t size() const {
+    return contacts_end - contacts_begin;
+  }
+
+  // Finds the new impulses x, active being a mask of the contacts expected
+  // to push, which is only a hint. Returns false if there is no solution,
+  // which only happens when rounding errors get in the way.
+  bool solve(real_t const* q, uint32_t active, real_t* x) const {
+    if(size() == 2) {
+      return solveTwo_(q, x);
+    }
+    return solvePivoting_(q, active, x);
+  }
+
+  uint32_t contacts_begin = 0;
+  uint32_t contacts_end = 0;
+
+  // Effective mass matrix of the contacts, row major.
+  std::array<real_t, max_size * max_size> mass;
+
+ private:
+  real_t k_(uint32_t i, uint32_t j) const {
+    return mass[i * max_size + j];
+  }
+
+  // Goes through the four possible cases directly.
+  bool solveTwo_(real_t const* q, real_t* x) const {
+    real_t k_00 = k_(0, 0);
+    real_t k_01 = k_(0, 1);
+    real_t k_10 = k_(1, 0);
+    real_t k_11 = k_(1, 1);
+
+    // Both contacts push.
+    real_t det = k_00 * k_11 - k_01 * k_10;
+    if(det > real_t(0)) {
+      x[0] = (k_11 * q[0] - k_01 * q[1]) / det;
+      x[1] = (k_00 * q[1] - k_10 * q[0]) / det;
+      if(x[0] >= real_t(0) && x[1] >= real_t(0)) {
+        return true;
+      }
+    }
+
+    // Only the first one does.
+    x[0] = q[0] / k_00;
+    x[1] = 0;
+    if(x[0] >= real_t(0) && k_10 * x[0] - q[1] >= real_t(0)) {
+      return true;
+    }
+
+    // Only the second one does.
+    x[0] = 0;
+    x[1] = q[1] / k_11;
+    if(x[1] >= real_t(0) && k_01 * x[1] - q[0] >= real_t(0)) {
+      return true;
+    }
+
+    // Neither does.
+    x[0] = 0;
+    x[1] = 0;
+    return q[0] <= real_t(0) && q[1] <= real_t(0);
+  }
+
+  // Principal pivoting, flipping the contact with the lowest index that is
+  // wrong about pushing or not. That rule, from Murty, is guaranteed to
+  // reach the solution on positive definite matrices, in at most one pivot
+  // per subset of the contacts.
+  bool solvePivoting_(real_t const* q, uint32_t active, real_t* x) const {
+    auto count = size();
+
+    for(uint32_t pivot = 0; pivot < (1u << count); ++pivot) {
+      if(!solveActive_(q, active, x)) {
+        return false;
+      }
+
+      int wrong = -1;
+      for(uint32_t i = 0; i < count && wrong < 0; ++i) {
+        if(active & (1u << i)) {
+          if(x[i] < real_t(0)) {
+            wrong = int(i);
+          }
+        } else {
+          real_t w = -q[i];
+          for(uint32_t j = 0; j < count; ++j) {
+            w += k_(i, j) * x[j];
+          }
+          if(w < real_t(0)) {
+            wrong = int(i);
+          }
+        }
+      }
+
+      if(wrong < 0) {
+        return true;
+      }
+      active ^= 1u << wrong;
+    }
+
+    return false;
+  }
+
+  // Solves mass * x = q for the active contacts through a Cholesky
+  // decomposition, leaving the others at 0.
+  bool solveActive_(real_t const* q, uint32_t active, real_t* x) const {
+    std::array<uint32_t, max_size> index;
+    uint32_t n = 0;
+    for(uint32_t i = 0; i < size(); ++i) {
+      x[i] = 0;
+      if(active & (1u << i)) {
+        index[n++] = i;
+      }
+    }
+
+    std::array<real_t, max_size * max_size> l;
+    for(uint32_t i = 0; i < n; ++i) {
+      for(uint32_t j = 0; j <= i; ++j) {
+        real_t sum = k_(index[i], index[j]);
+        for(uint32_t k = 0; k < j; ++k) {
+          sum -= l[i * max_size + k] * l[j * max_size + k];
+        }
+
+        if(i == j) {
+          if(sum <= real_t(0)) {
+            return false;
+          }
+          l[i * max_size + i] = std::sqrt(sum);
+        } else {
+          l[i * max_size + j] = sum / l[j * max_size + j];
+        }
+      }
+    }
+
+    std::array<real_t, max_size> y;
+    for(uint32_t i = 0; i < n; ++i) {
+      real_t sum = q[index[i]];
+      for(uint32_t k = 0; k < i; ++k) {
+        sum -= l[i * max_size + k] * y[k];
+      }
+      y[i] = sum / l[i * max_size + i];
+    }
+
+    for(uint32_t i = n; i-- > 0;) {
+      real_t sum = y[i];
+      for(uint32_t k = i + 1; k < n; ++k) {
+        sum -= l[k * max_size + i] * x[index[k]];
+      }
+      x[index[i]] = sum / l[i * max_size + i];
+    }
+
+    return true;
+  }
+};
+}
+}
+#endif
\ No newline at end of file
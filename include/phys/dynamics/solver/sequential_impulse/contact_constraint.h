@@ -1,8 +1,12 @@
 #ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_CONTACT_CONSTRAINT_H
 #define PHYS_SEQUENTIAL_INPUT_SOLVER_CONTACT_CONSTRAINT_H
 
+#include <array>
+#include <cstdint>
 #include <limits>
+#include <vector>
 #include "phys/collision/collision.h"
+#include "phys/dynamics/solver/sequential_impulse/body.h"
 #include "phys/dynamics/solver/sequential_impulse/config.h"
 
 namespace phys {
@@ -13,15 +17,21 @@ struct ContactConstraint {
   using vec3_t = typename CFG::vec3_t;
   ContactConstraint() {}
 
+  // The contact is between bodies[index_0] and bodies[index_1].
   ContactConstraint(seqi_solver::Config<CFG> const& solver_cfg, real_t dt,
-                    Contact<CFG>* contact, seqi_solver::Body<CFG>* obj_cache_0,
-                    seqi_solver::Body<CFG>* obj_cache_1,
+                    Contact<CFG>* contact,
+                    std::vector<seqi_solver::Body<CFG>> const& bodies,
+                    uint32_t index_0, uint32_t index_1,
                     vec3_t const& rel_pos_0, vec3_t const& rel_pos_1,
                     real_t relative_vel) {
     real_t dt_inv = real_t(1) / dt;
 
     contact_ = contact;
-    solver_bodies_ = {obj_cache_0, obj_cache_1};
+    solver_bodies_ = {{index_0, index_1}};
+
+    auto const* obj_cache_0 = &bodies[index_0];
+    auto const* obj_cache_1 = &bodies[index_1];
+    inv_mass = {{obj_cache_0->inv_mass, obj_cache_1->inv_mass}};
 
     auto* rb_0 = obj_cache_0->target;
     auto* rb_1 = obj_cache_1->target;
@@ -45,6 +55,7 @@ struct ContactConstraint {
       angular_component[0] = ang_comp;
       relpos_cross_normal[0] = torque_axis;
     } else {
+      normals[0] = {0, 0, 0};
       angular_component[0] = {0, 0, 0};
       relpos_cross_normal[0] = {0, 0, 0};
     }
@@ -60,6 +71,7 @@ struct ContactConstraint {
       angular_component[1] = ang_comp;
       relpos_cross_normal[1] = -torque_axis;
     } else {
+      normals[1] = {0, 0, 0};
       angular_component[1] = {0, 0, 0};
       relpos_cross_normal[1] = {0, 0, 0};
     }
@@ -113,7 +125,10 @@ struct ContactConstraint {
   }
 
   Contact<CFG>* contact_;
-  std::array<seqi_solver::Body<CFG>*, 2> solver_bodies_;
+
+  // Indices of the bodies in the solver, see Solver::deltas_.
+  std::array<uint32_t, 2> solver_bodies_;
+  std::array<real_t, 2> inv_mass;
 
   std::array<vec3_t, 2> normals;
   std::array<vec3_t, 2> angular_component;
@@ -0,0 +1,268 @@
+#ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_FRICTION_CONSTRAINT_H
+#define PHYS_SEQUENTIAL_INPUT_SOLVER_FRICTION_CONSTRAINT_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "phys/collision/collision.h"
+#include "phys/dynamics/solver/sequential_impulse/body.h"
+#include "phys/math_types/tangent.h"
+
+namespace phys {
+namespace seqi_solver {
+
+// Friction of a whole collision, applied once at the center of its contact
+// points instead of at each of them.
+//
+// Two rows oppose sliding along the contact plane, and a third one opposes
+// twisting around the normal, which is what a patch of points would
+// otherwise resist through their individual friction. The sliding impulse is
+// limited to the friction coefficient times the sum of the points' normal
+// impulses, and the twisting one to that same limit times the points'
+// average distance to their center, along the contact plane.
+template <typename CFG>
+struct FrictionConstraint {
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum { TANGENT_0, TANGENT_1, TWIST, row_count };
+
+  struct Row {
+    // Jacobian of each body.
+    std::array<vec3_t, 2> linear;
+    std::array<vec3_t, 2> relpos_cross;
+
+    // relpos_cross, through each body's inverse inertia.
+    std::array<vec3_t, 2> angular_component;
+
+    real_t jac_diag_inv = 0;
+    real_t rhs = 0;
+    real_t applied_impulse = 0;
+  };
+
+  FrictionConstraint() {}
+
+  // The collision is between bodies[index_0] and bodies[index_1], and its
+  // points are solved by contacts_[contacts_begin, contacts_end) in the
+  // solver.
+  FrictionConstraint(Collision<CFG>* col, std::vector<Body<CFG>> const& bodies,
+                     uint32_t index_0, uint32_t index_1,
+                     uint32_t contacts_begin, uint32_t contacts_end)
+      : collision(col),
+        solver_bodies_({{index_0, index_1}}),
+        contacts_begin(contacts_begin),
+        contacts_end(contacts_end) {
+    auto const& body_0 = bodies[index_0];
+    auto const& body_1 = bodies[index_1];
+    inv_mass = {{body_0.inv_mass, body_1.inv_mass}};
+    friction = std::sqrt(col->objects[0]->friction * col->objects[1]->friction);
+
+    // Like contacts, each body is pushed at its own side of the points, which
+    // matters for speculative ones.
+    std::array<vec3_t, 2> centers = {{{0, 0, 0}, {0, 0, 0}}};
+    vec3_t sum_normal = {0, 0, 0};
+    for(auto const& point : col->points) {
+      centers[0] += point.ws_position[0];
+      centers[1] += point.ws_position[1];
+      sum_normal += point.ws_normal;
+    }
+    real_t point_count = real_t(col->points.size());
+    centers[0] /= point_count;
+    centers[1] /= point_count;
+    normal = normalize(sum_normal);
+
+    twist_radius = 0;
+    for(auto const& point : col->points) {
+      vec3_t offset = point.ws_position[0] - centers[0];
+      twist_radius += length(offset - normal * dot(normal, offset));
+    }
+    twist_radius /= point_count;
+
+    vec3_t rel_pos_0 =
+        centers[0] - col->objects[0]->transform.getTranslation();
+    vec3_t rel_pos_1 =
+        centers[1] - col->objects[1]->transform.getTranslation();
+
+    // The first tangent follows the sliding direction when there is one, so
+    // that the disc clamp below only has to shorten it.
+    vec3_t vel = body_0.getRelativeVelocity(rel_pos_0) -
+                 body_1.getRelativeVelocity(rel_pos_1);
+    vec3_t slide = vel - normal * dot(normal, vel);
+    real_t slide_sq = dot(slide, slide);
+    if(slide_sq > std::numeric_limits<real_t>::epsilon()) {
+      tangents[0] = slide / std::sqrt(slide_sq);
+    } else {
+      tangents[0] = anyTangent<CFG>(normal);
+    }
+    tangents[1] = cross(normal, tangents[0]);
+
+    for(int i = 0; i < 2; ++i) {
+      setRow_(&rows[TANGENT_0 + i], bodies, tangents[i],
+              cross(rel_pos_0, tangents[i]), cross(rel_pos_1, tangents[i]));
+    }
+    setRow_(&rows[TWIST], bodies, {0, 0, 0}, normal, normal);
+  }
+
+  // Starts from factor times the impulses applied during the previous step,
+  // applied to the deltas of the solver's bodies. The tangent impulse is
+  // given in world space, since the tangents change from one step to the
+  // next.
+  void warmStart(vec3_t const& tangent_impulse, real_t twist_impulse,
+                 real_t factor, BodyDelta<CFG>* deltas) {
+    rows[TANGENT_0].applied_impulse =
+        dot(tangent_impulse, tangents[0]) * factor;
+    rows[TANGENT_1].applied_impulse =
+        dot(tangent_impulse, tangents[1]) * factor;
+    rows[TWIST].applied_impulse = twist_impulse * factor;
+
+    auto& delta_0 = deltas[solver_bodies_[0]];
+    auto& delta_1 = deltas[solver_bodies_[1]];
+    for(auto const& row : rows) {
+      apply_(row, row.applied_impulse, &delta_0.linear, &delta_0.angular,
+             &delta_1.linear, &delta_1.angular);
+    }
+  }
+
+  vec3_t getTangentImpulse() const {
+    return tangents[0] * rows[TANGENT_0].applied_impulse +
+           tangents[1] * rows[TANGENT_1].applied_impulse;
+  }
+
+  // Solves the rows against the bodies' velocity deltas, normal_impulse being
+  // the sum of the collision's contacts' current impulses. Returns the sum of
+  // the squared changes of the impulses.
+  real_t solve(vec3_t* linear_vel_0, vec3_t* angular_vel_0,
+               vec3_t* linear_vel_1, vec3_t* angular_vel_1,
+               real_t normal_impulse) {
+    real_t limit = friction * normal_impulse;
+
+    // Both tangents are solved against the same velocities, and their
+    // impulses clamped together to a disc.
+    std::array<real_t, 2> new_impulse;
+    for(int i = 0; i < 2; ++i) {
+      auto const& row = rows[TANGENT_0 + i];
+      new_impulse[i] = row.applied_impulse +
+                       getImpulse_(row, *linear_vel_0, *angular_vel_0,
+                                   *linear_vel_1, *angular_vel_1);
+    }
+
+    real_t len_sq =
+        new_impulse[0] * new_impulse[0] + new_impulse[1] * new_impulse[1];
+    if(len_sq > limit * limit) {
+      real_t scale = limit > 0 ? limit / std::sqrt(len_sq) : real_t(0);
+      new_impulse[0] *= scale;
+      new_impulse[1] *= scale;
+    }
+
+    real_t residual = 0;
+    for(int i = 0; i < 2; ++i) {
+      auto& row = rows[TANGENT_0 + i];
+      real_t d_impulse = new_impulse[i] - row.applied_impulse;
+      row.applied_impulse = new_impulse[i];
+      apply_(row, d_impulse, linear_vel_0, angular_vel_0, linear_vel_1,
+             angular_vel_1);
+      residual += d_impulse * d_impulse;
+    }
+
+    // Single points, such as most of the ones involving spheres, cannot
+    // resist twisting.
+    if(twist_radius == 0) {
+      return residual;
+    }
+
+    auto& twist = rows[TWIST];
+    real_t twist_limit = limit * twist_radius;
+    real_t twist_impulse =
+        twist.applied_impulse + getImpulse_(twist, *linear_vel_0,
+                                            *angular_vel_0, *linear_vel_1,
+                                            *angular_vel_1);
+    twist_impulse =
+        std::min(std::max(twist_impulse, -twist_limit), twist_limit);
+
+    real_t d_impulse = twist_impulse - twist.applied_impulse;
+    twist.applied_impulse = twist_impulse;
+    apply_(twist, d_impulse, linear_vel_0, angular_vel_0, linear_vel_1,
+           angular_vel_1);
+    residual += d_impulse * d_impulse;
+
+    return residual;
+  }
+
+  Collision<CFG>* collision = nullptr;
+
+  // Indices of the bodies in the solver, see Solver::deltas_.
+  std::array<uint32_t, 2> solver_bodies_;
+
+  // Range of the collision's contacts in the solver.
+  uint32_t contacts_begin = 0;
+  uint32_t contacts_end = 0;
+
+  std::array<real_t, 2> inv_mass;
+  real_t friction = 0;
+  real_t twist_radius = 0;
+
+  vec3_t normal;
+  std::array<vec3_t, 2> tangents;
+  std::array<Row, row_count> rows;
+
+ private:
+  // Fills a row whose jacobian is linear and relpos_cross_0 on the first
+  // body, and their opposites on the second one.
+  void setRow_(Row* row, std::vector<Body<CFG>> const& bodies,
+               vec3_t const& linear, vec3_t const& relpos_cross_0,
+               vec3_t const& relpos_cross_1) {
+    row->linear = {{linear, -linear}};
+    row->relpos_cross = {{relpos_cross_0, -relpos_cross_1}};
+
+    real_t denom = 0;
+    real_t init_vel = 0;
+    for(int side = 0; side < 2; ++side) {
+      auto const* body = &bodies[solver_bodies_[side]];
+      auto* target = body->target;
+      row->angular_component[side] =
+          target ? target->inv_inertia_tensor_world_ * row->relpos_cross[side]
+                 : vec3_t{0, 0, 0};
+
+      denom += dot(row->linear[side], row->linear[side]) * inv_mass[side] +
+               dot(row->relpos_cross[side], row->angular_component[side]);
+
+      init_vel +=
+          dot(row->linear[side],
+              body->linear_velocity + body->applied_force_impulse) +
+          dot(row->relpos_cross[side],
+              body->angular_velocity + body->applied_torque_impulse);
+    }
+
+    row->jac_diag_inv = denom > 0 ? real_t(1) / denom : real_t(0);
+    row->rhs = -init_vel * row->jac_diag_inv;
+    row->applied_impulse = 0;
+  }
+
+  // Impulse that would cancel the row's velocity, on top of what it already
+  // applied.
+  static real_t getImpulse_(Row const& row, vec3_t const& linear_vel_0,
+                            vec3_t const& angular_vel_0,
+                            vec3_t const& linear_vel_1,
+                            vec3_t const& angular_vel_1) {
+    real_t vel = dot(row.linear[0], linear_vel_0) +
+                 dot(row.relpos_cross[0], angular_vel_0) +
+                 dot(row.linear[1], linear_vel_1) +
+                 dot(row.relpos_cross[1], angular_vel_1);
+    return row.rhs - vel * row.jac_diag_inv;
+  }
+
+  void apply_(Row const& row, real_t d_impulse, vec3_t* linear_vel_0,
+              vec3_t* angular_vel_0, vec3_t* linear_vel_1,
+              vec3_t* angular_vel_1) const {
+    *linear_vel_0 += row.linear[0] * (inv_mass[0] * d_impulse);
+    *angular_vel_0 += row.angular_component[0] * d_impulse;
+    *linear_vel_1 += row.linear[1] * (inv_mass[1] * d_impulse);
+    *angular_vel_1 += row.angular_component[1] * d_impulse;
+  }
+};
+}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+#ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_JOINT_CONSTRAINT_H
+#define PHYS_SEQUENTIAL_INPUT_SOLVER_JOINT_CONSTRAINT_H
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "phys/dynamics/joint.h"
+#include "phys/dynamics/solver/sequential_impulse/body.h"
+#include "phys/math_types/tangent.h"
+
+namespace phys {
+namespace seqi_solver {
+
+// The rows of a joint, whose impulses are solved together.
+//
+// A joint's rows share both of its bodies, so solving them one by one has
+// each undo part of what the others did, the hinge's angular rows pulling
+// its anchor sideways and so on. Instead, each iteration solves
+//
+//   mass * d_impulses = rhs - velocities
+//
+// for all of them at once, through a Cholesky decomposition of their
+// effective mass matrix done once per step. The rows are not limited, so
+// that is all there is to it.
+//
+// Since a joint's rows are always gone through together, field by field,
+// each field is stored as an array indexed by row. That only holds within a
+// joint, the solver keeps whole JointConstraints one after the other.
+template <typename CFG>
+struct JointConstraint {
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+  using mat3x3_t = typename CFG::mat3x3_t;
+
+  enum { max_rows = 6 };
+
+  template <typename T>
+  using PerRow = std::array<T, max_rows>;
+
+  JointConstraint() {}
+
+  // The joint is between bodies[index_0] and bodies[index_1]. Its drift is
+  // taken back by erp of it per step.
+  template <typename ALGO>
+  JointConstraint(Joint<CFG, ALGO>* joint,
+                  std::vector<Body<CFG>> const& bodies, uint32_t index_0,
+                  uint32_t index_1, real_t dt, real_t erp)
+      : joint_impulses(joint->applied_impulses_.data()),
+        solver_bodies_({{index_0, index_1}}) {
+    using JointType = Joint<CFG, ALGO>;
+    inv_mass = {{bodies[index_0].inv_mass, bodies[index_1].inv_mass}};
+
+    // The shared static body sits at the origin, unrotated, which is where
+    // the joint's world side anchor and axis are expressed.
+    std::array<mat3x3_t, 2> rotations;
+    std::array<vec3_t, 2> rel_pos;
+    std::array<vec3_t, 2> anchors;
+    for(int side = 0; side < 2; ++side) {
+      auto const& trans = bodies[solver_bodies_[side]].world_transform;
+      rotations[side] = trans.getRotationMatrix();
+      rel_pos[side] = rotations[side] * joint->os_anchors_[side];
+      anchors[side] = trans.getTranslation() + rel_pos[side];
+    }
+
+    vec3_t drift = anchors[1] - anchors[0];
+    real_t bias = erp / dt;
+    std::array<vec3_t, 3> world_axes = {
+        {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+
+    // Sliders only keep the anchors on the first body's axis, the others
+    // keep them together.
+    if(joint->type_ == JointType::SLIDER) {
+      vec3_t axis = rotations[0] * joint->os_axes_[0];
+      vec3_t tangent_0 = anyTangent<CFG>(axis);
+      vec3_t tangent_1 = cross(axis, tangent_0);
+
+      // The first body also turns the axis the second one slides along.
+      for(auto const& t : {tangent_0, tangent_1}) {
+        addRow_(bodies, t, cross(rel_pos[0] + drift, t),
+                cross(rel_pos[1], t), dot(drift, t) * bias);
+      }
+    } else {
+      for(auto const& e : world_axes) {
+        addRow_(bodies, e, cross(rel_pos[0], e), cross(rel_pos[1], e),
+                dot(drift, e) * bias);
+      }
+    }
+
+    if(joint->type_ == JointType::HINGE) {
+      // Rotations around the axes perpendicular to the first body's one.
+      vec3_t axis_0 = rotations[0] * joint->os_axes_[0];
+      vec3_t axis_1 = rotations[1] * joint->os_axes_[1];
+      vec3_t tangent_0 = anyTangent<CFG>(axis_0);
+      vec3_t tangent_1 = cross(axis_0, tangent_0);
+      vec3_t misalignment = cross(axis_0, axis_1);
+
+      for(auto const& t : {tangent_0, tangent_1}) {
+        addRow_(bodies, {0, 0, 0}, t, t, dot(misalignment, t) * bias);
+      }
+    } else if(joint->type_ != JointType::BALL_SOCKET) {
+      // How far the second body turned from where the first one would have
+      // it, as a rotation vector, which only needs to be accurate for small
+      // rotations. Matrices are indexed by column.
+      mat3x3_t target = rotations[0] * joint->relative_rotation_;
+      mat3x3_t error = rotations[1] * transpose(target);
+      vec3_t angle = vec3_t{error[1][2] - error[2][1],
+                            error[2][0] - error[0][2],
+                            error[0][1] - error[1][0]} *
+                     real_t(0.5);
+
+      for(auto const& e : world_axes) {
+        addRow_(bodies, {0, 0, 0}, e, e, dot(angle, e) * bias);
+      }
+    }
+
+    assert(row_count == uint32_t(joint->getRowCount()));
+    factor_();
+  }
+
+  // Starts from factor times the impulses the joint ended the previous step
+  // with, applied to the deltas of the solver's bodies.
+  void warmStart(real_t factor, BodyDelta<CFG>* deltas) {
+    for(uint32_t i = 0; i < row_count; ++i) {
+      applied_impulses[i] = joint_impulses[i] * factor;
+      apply_(i, applied_impulses[i], deltas);
+    }
+  }
+
+  // Solves the rows against the velocity deltas of the bodies, found at
+  // deltas[solver_bodies_]. Returns the sum of the squared changes of the
+  // impulses.
+  real_t solve(BodyDelta<CFG>* deltas) {
+    auto const& delta_0 = deltas[solver_bodies_[0]];
+    auto const& delta_1 = deltas[solver_bodies_[1]];
+    vec3_t linear_delta = delta_1.linear - delta_0.linear;
+
+    PerRow<real_t> d_impulses;
+    for(uint32_t i = 0; i < row_count; ++i) {
+      real_t vel = dot(linear[i], linear_delta) +
+                   dot(relpos_cross[0][i], delta_0.angular) +
+                   dot(relpos_cross[1][i], delta_1.angular);
+      d_impulses[i] = rhs[i] - vel;
+    }
+    solveFactored_(d_impulses.data());
+
+    real_t residual = 0;
+    for(uint32_t i = 0; i < row_count; ++i) {
+      applied_impulses[i] += d_impulses[i];
+      apply_(i, d_impulses[i], deltas);
+      residual += d_impulses[i] * d_impulses[i];
+    }
+    return residual;
+  }
+
+  // Keeps the impulses for warm starting the next step.
+  void store() const {
+    for(uint32_t i = 0; i < row_count; ++i) {
+      joint_impulses[i] = applied_impulses[i];
+    }
+  }
+
+  // Joint::applied_impulses_
+  real_t* joint_impulses = nullptr;
+
+  // Indices of the bodies in the solver, see Solver::deltas_.
+  std::array<uint32_t, 2> solver_bodies_;
+
+  std::array<real_t, 2> inv_mass;
+
+  uint32_t row_count = 0;
+
+  // Jacobian of the second body, the first one's linear part being the
+  // opposite.
+  PerRow<vec3_t> linear;
+  std::array<PerRow<vec3_t>, 2> relpos_cross;
+
+  // relpos_cross, through each body's inverse inertia.
+  std::array<PerRow<vec3_t>, 2> angular_component;
+
+  // Velocity along each row that the impulses aim for, with the initial one
+  // taken out.
+  PerRow<real_t> rhs;
+  PerRow<real_t> applied_impulses;
+
+  // Cholesky factor of the rows' effective mass matrix, lower triangle, row
+  // major.
+  std::array<real_t, max_rows * max_rows> mass_factor;
+
+ private:
+  // Adds a row whose jacobian is axis and relpos_cross_1 on the second body,
+  // and the opposite of axis and relpos_cross_0 on the first one, which is
+  // how fast the second body moves away along it. error is the velocity
+  // along the row that takes back its drift.
+  void addRow_(std::vector<Body<CFG>> const& bodies, vec3_t const& axis,
+               vec3_t const& relpos_cross_0, vec3_t const& relpos_cross_1,
+               real_t error) {
+    uint32_t i = row_count++;
+    linear[i] = axis;
+    relpos_cross[0][i] = -relpos_cross_0;
+    relpos_cross[1][i] = relpos_cross_1;
+
+    real_t init_vel = 0;
+    for(int side = 0; side < 2; ++side) {
+      auto const* body = &bodies[solver_bodies_[side]];
+      auto* target = body->target;
+      angular_component[side][i] =
+          target ? target->inv_inertia_tensor_world_ * relpos_cross[side][i]
+                 : vec3_t{0, 0, 0};
+
+      init_vel +=
+          dot(sideLinear_(side, i),
+              body->linear_velocity + body->applied_force_impulse) +
+          dot(relpos_cross[side][i],
+              body->angular_velocity + body->applied_torque_impulse);
+    }
+
+    rhs[i] = -init_vel - error;
+    applied_impulses[i] = 0;
+  }
+
+  // Rows are independent, and at least one of the bodies is dynamic, so the
+  // matrix is positive definite.
+  void factor_() {
+    for(uint32_t i = 0; i < row_count; ++i) {
+      for(uint32_t j = 0; j <= i; ++j) {
+        real_t sum = dot(linear[i], linear[j]) * (inv_mass[0] + inv_mass[1]);
+        for(int side = 0; side < 2; ++side) {
+          sum += dot(relpos_cross[side][i], angular_component[side][j]);
+        }
+        for(uint32_t k = 0; k < j; ++k) {
+          sum -= l_(i, k) * l_(j, k);
+        }
+
+        if(i != j) {
+          mass_factor[i * max_rows + j] = sum / l_(j, j);
+        } else {
+          assert(sum > real_t(0));
+          mass_factor[i * max_rows + i] = std::sqrt(sum);
+        }
+      }
+    }
+  }
+
+  real_t l_(uint32_t i, uint32_t j) const {
+    return mass_factor[i * max_rows + j];
+  }
+
+  // Replaces x by the solution of mass * result = x.
+  void solveFactored_(real_t* x) const {
+    for(uint32_t i = 0; i < row_count; ++i) {
+      for(uint32_t k = 0; k < i; ++k) {
+        x[i] -= l_(i, k) * x[k];
+      }
+      x[i] /= l_(i, i);
+    }
+
+    for(uint32_t i = row_count; i-- > 0;) {
+      for(uint32_t k = i + 1; k < row_count; ++k) {
+        x[i] -= l_(k, i) * x[k];
+      }
+      x[i] /= l_(i, i);
+    }
+  }
+
+  vec3_t sideLinear_(int side, uint32_t i) const {
+    return side == 0 ? -linear[i] : linear[i];
+  }
+
+  void apply_(uint32_t i, real_t d_impulse, BodyDelta<CFG>* deltas) const {
+    for(int side = 0; side < 2; ++side) {
+      deltas[solver_bodies_[side]].applyImpulse(
+          sideLinear_(side, i) * inv_mass[side], angular_component[side][i],
+          d_impulse);
+    }
+  }
+};
+}
+}
+#endif
\ No newline at end of file
@@ -1,9 +1,18 @@
 #ifndef PHYS_SEQUENTIAL_INPUT_SOLVER_SOLVER_H
 #define PHYS_SEQUENTIAL_INPUT_SOLVER_SOLVER_H
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
 #include "phys/dynamics/solver/sequential_impulse/body.h"
 #include "phys/dynamics/solver/sequential_impulse/config.h"
+#include "phys/dynamics/solver/sequential_impulse/contact_batches.h"
+#include "phys/dynamics/solver/sequential_impulse/contact_block.h"
 #include "phys/dynamics/solver/sequential_impulse/contact_constraint.h"
+#include "phys/dynamics/solver/sequential_impulse/friction_constraint.h"
+#include "phys/dynamics/solver/sequential_impulse/joint_constraint.h"
 #include "phys/util_types/array_view.h"
 
 namespace phys {
@@ -14,22 +23,120 @@ class Solver {
   using real_t = typename CFG::real_t;
   using vec3_t = typename CFG::vec3_t;
 
+  enum {
+    // The World moves the bodies according to the velocities solve() leaves.
+    integrates_transforms = 0,
+
+    supports_joints = 1,
+  };
+
   Solver(Config<CFG> const& cfg = Config<CFG>()) : config_(cfg) {}
 
+  Config<CFG>& config() {
+    return config_;
+  }
+
+  // What solve() did on one island.
+  struct IslandStats {
+    uint32_t island_id;
+    uint32_t contact_count;
+    uint32_t joint_count;
+
+    int iterations;
+    int penetration_iterations;
+
+    // How much the last iteration changed the island's impulses, relative to
+    // them: the norm of the changes over the norm of the impulses. See
+    // Config::residual_threshold.
+    real_t residual;
+    real_t penetration_residual;
+  };
+
+  // One entry per island solved since clearIslandStats(), in the order they
+  // were solved. The World clears them at the start of every step.
+  std::vector<IslandStats> const& islandStats() const {
+    return island_stats_;
+  }
+
+  void clearIslandStats() {
+    island_stats_.resize(0);
+  }
+
+  // Whether solve() spreads a single island with that many contact points
+  // and joints across the threads of the pool it is given, in which case the
+  // World hands it the whole pool. Islands with joints never are, see
+  // Config::min_parallel_contacts.
+  bool splitsIsland(std::size_t contact_count,
+                    std::size_t joint_count) const {
+    return joint_count == 0 && config_.min_parallel_contacts != 0 &&
+           contact_count >= config_.min_parallel_contacts;
+  }
+
+  // The collisions and joints may belong to several islands, each sorted by
+  // island_id_, in which case each island iterates until its own residual is
+  // low enough, within its own budget of Config::iterations.
+  //
+  // thread_pool is optional, large enough islands get solved by all of its
+  // threads, see splitsIsland().
   template <typename ALGO>
   void solve(ArrayView<DynamicBody<CFG, ALGO>*> objects,
-             ArrayView<Collision<CFG>*> collisions, real_t dt) {
+             ArrayView<Collision<CFG>*> collisions,
+             ArrayView<Joint<CFG, ALGO>*> joints, real_t dt,
+             ThreadPool* thread_pool = nullptr) {
     dt_ = dt;
-    setup_(objects, collisions);
 
-    resolvePenetrations_();
+    // Batches mix up the contacts they hold, so they are only used on a
+    // single island without joints, which they know nothing about, and
+    // without the bottom-up final pass. This is decided up front, so that
+    // batched islands do not order their collisions for that pass.
+    std::size_t contact_count = 0;
+    for(auto col : collisions) {
+      contact_count += col->points.size();
+    }
+    bool single_island =
+        joints.size() == 0 && collisions.size() != 0 &&
+        collisions[0]->island_id_ ==
+            collisions[collisions.size() - 1]->island_id_;
+    bool parallel = single_island && thread_pool &&
+                    thread_pool->threadCount() > 1 &&
+                    splitsIsland(contact_count, 0);
+    thread_pool_ = parallel ? thread_pool : nullptr;
+
+    batched_ = parallel ||
+               (single_island && config_.batch_contacts &&
+                contact_count >= config_.min_batched_contacts);
+    shock_propagation_ = config_.shock_propagation && !batched_;
+
+    setup_(objects, collisions, joints);
+    if(batched_) {
+      batches_.build(contacts_, deltas_, push_deltas_, &frictions_);
+    }
 
-    for(int i = 0; i < config_.iterations; ++i) {
-      auto residual = solveIteration_();
+    // Islands share no dynamic body, so solving them one after the other is
+    // the same as interleaving their iterations.
+    for(auto const& island : islands_) {
+      IslandStats stats;
+      stats.island_id = island.island_id;
+      stats.contact_count = island.contacts_end - island.contacts_begin;
+      stats.joint_count = island.joints_end - island.joints_begin;
+
+      resolvePenetrations_(island, &stats);
+
+      stats.iterations = 0;
+      stats.residual = 0;
+      while(stats.iterations < config_.iterations) {
+        stats.residual = solveIteration_(island);
+        ++stats.iterations;
+
+        if(stats.residual <= config_.residual_threshold) {
+          break;
+        }
+      }
 
-      if(residual <= config_.residual_threshold) {
-        break;
+      if(shock_propagation_) {
+        propagateShock_(island);
       }
+      island_stats_.push_back(stats);
     }
 
     finish_();
@@ -37,74 +144,343 @@ class Solver {
 
   template <typename ALGO>
   void setup_(ArrayView<DynamicBody<CFG, ALGO>*> objects,
-              ArrayView<Collision<CFG>*> collisions) {
+              ArrayView<Collision<CFG>*> collisions,
+              ArrayView<Joint<CFG, ALGO>*> joints) {
     bodies_.resize(0);
     contacts_.resize(0);
+    frictions_.resize(0);
+    blocks_.resize(0);
+    joints_.resize(0);
+    islands_.resize(0);
 
-    bodies_.reserve(objects.size());
+    bodies_.reserve(objects.size() + 1);
 
     for(auto obj : objects) {
       obj->solver_id_ = uint32_t(bodies_.size());
       bodies_.emplace_back(&obj->dynamics_data_, dt_);
     }
-    auto col_count = collisions.size();
 
+    // Shared by all static objects.
+    static_index_ = uint32_t(bodies_.size());
+    bodies_.emplace_back();
+    deltas_.assign(bodies_.size(), BodyDelta<CFG>());
+    push_deltas_.assign(bodies_.size(), BodyDelta<CFG>());
+
+    if(shock_propagation_) {
+      orderBottomUp_<ALGO>(collisions);
+      collisions = ArrayView<Collision<CFG>*>(ordered_collisions_.begin(),
+                                              ordered_collisions_.end());
+    }
+
+    // Both are sorted by island, though either may have none for a given
+    // island.
+    std::size_t col_index = 0;
+    std::size_t joint_index = 0;
+    while(col_index < collisions.size() || joint_index < joints.size()) {
+      auto island_id = std::numeric_limits<uint32_t>::max();
+      if(col_index < collisions.size()) {
+        island_id = collisions[col_index]->island_id_;
+      }
+      if(joint_index < joints.size()) {
+        island_id = std::min(island_id, joints[joint_index]->island_id_);
+      }
+
+      Island island;
+      island.island_id = island_id;
+      island.contacts_begin = uint32_t(contacts_.size());
+      island.frictions_begin = uint32_t(frictions_.size());
+      island.blocks_begin = uint32_t(blocks_.size());
+      island.joints_begin = uint32_t(joints_.size());
+
+      while(col_index < collisions.size() &&
+            collisions[col_index]->island_id_ == island_id) {
+        addCollision_<ALGO>(collisions[col_index++]);
+      }
+      while(joint_index < joints.size() &&
+            joints[joint_index]->island_id_ == island_id) {
+        addJoint_<ALGO>(joints[joint_index++]);
+      }
+
+      island.contacts_end = uint32_t(contacts_.size());
+      island.frictions_end = uint32_t(frictions_.size());
+      island.blocks_end = uint32_t(blocks_.size());
+      island.joints_end = uint32_t(joints_.size());
+      islands_.push_back(island);
+    }
+  }
+
+  // Ranges of contacts_, frictions_, blocks_ and joints_ belonging to one
+  // island.
+  struct Island {
+    uint32_t island_id;
+    uint32_t contacts_begin;
+    uint32_t contacts_end;
+    uint32_t frictions_begin;
+    uint32_t frictions_end;
+    uint32_t blocks_begin;
+    uint32_t blocks_end;
+    uint32_t joints_begin;
+    uint32_t joints_end;
+  };
+
+  // Sets depths_ to how many collisions away from the ground each body is,
+  // the ground being static bodies and infinitely heavy dynamic ones, and
+  // fills ordered_collisions_ with the collisions of each island from the
+  // lowest to the highest.
+  template <typename ALGO>
+  void orderBottomUp_(ArrayView<Collision<CFG>*> collisions) {
+    auto body_count = std::size_t(static_index_);
+    depths_.resize(body_count);
+    links_begin_.assign(body_count + 1, 0);
+    queue_.resize(0);
+
+    for(std::size_t i = 0; i < body_count; ++i) {
+      if(bodies_[i].inv_mass == real_t(0)) {
+        depths_[i] = 0;
+        queue_.push_back(uint32_t(i));
+      } else {
+        depths_[i] = unsupported_;
+      }
+    }
+
+    // Static objects have no index in bodies_.
+    auto index = [](Collision<CFG>* col, int side) {
+      auto body = DynamicBody<CFG, ALGO>::fromCollisionObject(
+          col->objects[side]);
+      return body ? body->solver_id_ : uint32_t(no_body_);
+    };
+
+    // Bodies touching each other, grouped by body. links_begin_ is first
+    // used to count them.
+    for(auto col : collisions) {
+      if(col->points.size() != 0) {
+        auto index_0 = index(col, 0);
+        auto index_1 = index(col, 1);
+        if(index_0 != no_body_ && index_1 != no_body_) {
+          ++links_begin_[index_0 + 1];
+          ++links_begin_[index_1 + 1];
+        }
+      }
+    }
+    for(std::size_t i = 0; i < body_count; ++i) {
+      links_begin_[i + 1] += links_begin_[i];
+    }
+
+    links_.resize(links_begin_[body_count]);
+    for(auto col : collisions) {
+      if(col->points.size() != 0) {
+        auto index_0 = index(col, 0);
+        auto index_1 = index(col, 1);
+        if(index_0 != no_body_ && index_1 != no_body_) {
+          links_[links_begin_[index_0]++] = index_1;
+          links_[links_begin_[index_1]++] = index_0;
+        } else if(index_0 != no_body_ || index_1 != no_body_) {
+          // Whichever one is not static.
+          auto body = std::min(index_0, index_1);
+          if(depths_[body] == unsupported_) {
+            depths_[body] = 1;
+            queue_.push_back(body);
+          }
+        }
+      }
+    }
+
+    // Filling shifted links_begin_ by one body.
+    for(std::size_t i = body_count; i > 0; --i) {
+      links_begin_[i] = links_begin_[i - 1];
+    }
+    links_begin_[0] = 0;
+
+    // Breadth first from the ground up.
+    for(std::size_t i = 0; i < queue_.size(); ++i) {
+      auto body = queue_[i];
+      for(auto link = links_begin_[body]; link < links_begin_[body + 1];
+          ++link) {
+        auto other = links_[link];
+        if(depths_[other] == unsupported_) {
+          depths_[other] = depths_[body] + 1;
+          queue_.push_back(other);
+        }
+      }
+    }
+
+    // Collisions are as deep as their lowest body. The islands' collisions
+    // stay together, in the same order.
+    using Entry = std::pair<uint32_t, Collision<CFG>*>;
+    collision_depths_.resize(0);
     for(auto col : collisions) {
-      addCollision_<ALGO>(col);
+      auto index_0 = index(col, 0);
+      auto index_1 = index(col, 1);
+      uint32_t depth_0 = index_0 == no_body_ ? 0 : depths_[index_0];
+      uint32_t depth_1 = index_1 == no_body_ ? 0 : depths_[index_1];
+      collision_depths_.emplace_back(std::min(depth_0, depth_1), col);
+    }
+
+    auto island_begin = collision_depths_.begin();
+    while(island_begin != collision_depths_.end()) {
+      auto island_id = island_begin->second->island_id_;
+      auto island_end = std::find_if(
+          island_begin, collision_depths_.end(), [island_id](Entry const& e) {
+            return e.second->island_id_ != island_id;
+          });
+      std::stable_sort(island_begin, island_end,
+                       [](Entry const& lhs, Entry const& rhs) {
+                         return lhs.first < rhs.first;
+                       });
+      island_begin = island_end;
+    }
+
+    ordered_collisions_.resize(0);
+    for(auto const& entry : collision_depths_) {
+      ordered_collisions_.push_back(entry.second);
     }
   }
 
-  void resolvePenetrations_() {
-    for(int iteration = 0; iteration < config_.penetration_iterations;
-        ++iteration) {
-      real_t residual = 0.0f;
-      for(auto& contact : contacts_) {
-        residual += solvePenetration_(contact);
+  void resolvePenetrations_(Island const& island, IslandStats* stats) {
+    stats->penetration_iterations = 0;
+    stats->penetration_residual = 0;
+    if(config_.penetration_iterations <= 0) {
+      return;
+    }
+
+    // Bodies of the contacts that push get moved by their push velocities.
+    for(auto i = island.contacts_begin; i < island.contacts_end; ++i) {
+      auto const& c = contacts_[i];
+      if(c.penetration_impulse != real_t(0)) {
+        bodies_[c.solver_bodies_[0]].push_applied = true;
+        bodies_[c.solver_bodies_[1]].push_applied = true;
       }
+    }
 
-      if(residual <= config_.residual_threshold) {
+    while(stats->penetration_iterations < config_.penetration_iterations) {
+      real_t residual = 0;
+      real_t impulses = 0;
+      if(batched_) {
+        residual = batches_.solvePenetrations(thread_pool_);
+        impulses = batches_.squaredPushImpulses();
+      } else {
+        for(auto i = island.contacts_begin; i < island.contacts_end; ++i) {
+          auto& c = contacts_[i];
+          auto d_impulse = solvePenetration_(c, push_deltas_.data());
+          residual += d_impulse * d_impulse;
+          impulses += c.applied_push_impulse * c.applied_push_impulse;
+        }
+      }
+
+      stats->penetration_residual = relativeResidual_(residual, impulses);
+      ++stats->penetration_iterations;
+      if(stats->penetration_residual <= config_.residual_threshold) {
         break;
       }
     }
   }
 
-  real_t solveIteration_() {
+  // Returns how much the island's impulses changed, relative to them.
+  real_t solveIteration_(Island const& island) {
     real_t residual = real_t(0);
+    real_t impulses = real_t(0);
 
     // Solve generic constraints
+    for(auto i = island.joints_begin; i < island.joints_end; ++i) {
+      auto& joint = joints_[i];
+      residual += joint.solve(deltas_.data());
+      for(uint32_t row = 0; row < joint.row_count; ++row) {
+        auto impulse = joint.applied_impulses[row];
+        impulses += impulse * impulse;
+      }
+    }
 
     // Solve contacts
-    for(auto& contact : contacts_) {
-      auto contact_residual = solveContact_(contact);
-      residual += contact_residual * contact_residual;
+    if(batched_) {
+      residual += batches_.solveContacts(thread_pool_);
+      impulses += batches_.squaredImpulses();
+    } else {
+      if(config_.block_contacts) {
+        for(auto i = island.blocks_begin; i < island.blocks_end; ++i) {
+          residual += solveBlock_(blocks_[i]);
+        }
+      } else {
+        for(auto i = island.contacts_begin; i < island.contacts_end; ++i) {
+          auto contact_residual = solveContact_(contacts_[i], deltas_.data());
+          residual += contact_residual * contact_residual;
+        }
+      }
+
+      for(auto i = island.contacts_begin; i < island.contacts_end; ++i) {
+        auto impulse = contacts_[i].applied_impulse;
+        impulses += impulse * impulse;
+      }
     }
 
     // Solve friction
+    if(batched_) {
+      residual += batches_.solveFrictions(thread_pool_);
+      impulses += batches_.squaredFrictionImpulses();
+    } else {
+      for(auto i = island.frictions_begin; i < island.frictions_end; ++i) {
+        residual += solveFriction_(frictions_[i]);
+      }
 
-    return residual;
+      for(auto i = island.frictions_begin; i < island.frictions_end; ++i) {
+        for(auto const& row : frictions_[i].rows) {
+          impulses += row.applied_impulse * row.applied_impulse;
+        }
+      }
+    }
+
+    return relativeResidual_(residual, impulses);
+  }
+
+  // Residual, from the sum of the squared changes of impulses and the sum of
+  // the squared impulses. Impulses that all went back to 0 changed entirely.
+  static real_t relativeResidual_(real_t residual, real_t impulses) {
+    if(impulses > real_t(0)) {
+      return std::sqrt(residual / impulses);
+    }
+    return residual > real_t(0) ? real_t(1) : real_t(0);
   }
 
   void finish_() {
-    for(auto& body : bodies_) {
-      auto* object = body.target;
+    if(batched_) {
+      batches_.store();
+    }
 
-      body.finish(dt_, config_.split_impulse_turn_erp);
+    for(auto& contact : contacts_) {
+      contact.contact_->applied_impulse = contact.applied_impulse;
+    }
+
+    for(auto& friction : frictions_) {
+      friction.collision->friction_impulse_ = friction.getTangentImpulse();
+      friction.collision->twist_impulse_ =
+          friction.rows[FrictionConstraint<CFG>::TWIST].applied_impulse;
+    }
+
+    for(auto const& joint : joints_) {
+      joint.store();
+    }
+
+    for(uint32_t i = 0; i < static_index_; ++i) {
+      bodies_[i].finish(dt_, config_.split_impulse_turn_erp, deltas_[i],
+                        push_deltas_[i]);
     }
   }
 
-  real_t solvePenetration_(seqi_solver::ContactConstraint<CFG>& c) {
+  // Solves the contact against the push velocities of the bodies, found at
+  // push_deltas[c.solver_bodies_].
+  static real_t solvePenetration_(seqi_solver::ContactConstraint<CFG>& c,
+                                  BodyDelta<CFG>* push_deltas) {
     real_t d_impulse = 0;
 
     if(c.penetration_impulse != real_t(0)) {
-      auto* body_0 = c.solver_bodies_[0];
-      auto* body_1 = c.solver_bodies_[1];
+      auto* body_0 = &push_deltas[c.solver_bodies_[0]];
+      auto* body_1 = &push_deltas[c.solver_bodies_[1]];
 
       d_impulse = c.penetration_impulse - c.applied_push_impulse * c.cfm;
 
-      real_t dv_0_dot_n = dot(c.normals[0], body_0->push_vel) +
-                          dot(c.relpos_cross_normal[0], body_0->turn_vel);
-      real_t dv_1_dot_n = dot(c.normals[1], body_1->push_vel) +
-                          dot(c.relpos_cross_normal[1], body_1->turn_vel);
+      real_t dv_0_dot_n = dot(c.normals[0], body_0->linear) +
+                          dot(c.relpos_cross_normal[0], body_0->angular);
+      real_t dv_1_dot_n = dot(c.normals[1], body_1->linear) +
+                          dot(c.relpos_cross_normal[1], body_1->angular);
 
       d_impulse -= dv_0_dot_n * c.jac_diag_ab_inv;
       d_impulse -= dv_1_dot_n * c.jac_diag_ab_inv;
@@ -117,25 +493,149 @@ class Solver {
 
       c.applied_push_impulse = new_impulse;
 
-      body_0->applyPushImpulse(c.normals[0] * body_0->inv_mass,
-                               c.angular_component[0], d_impulse);
-      body_1->applyPushImpulse(c.normals[1] * body_1->inv_mass,
-                               c.angular_component[1], d_impulse);
+      body_0->applyImpulse(c.normals[0] * c.inv_mass[0],
+                           c.angular_component[0], d_impulse);
+      body_1->applyImpulse(c.normals[1] * c.inv_mass[1],
+                           c.angular_component[1], d_impulse);
     }
 
     return d_impulse;
   }
 
-  real_t solveContact_(seqi_solver::ContactConstraint<CFG>& c) {
+  // Returns the sum of the squared changes of the impulses.
+  real_t solveFriction_(FrictionConstraint<CFG>& f) {
+    real_t normal_impulse = 0;
+    for(auto i = f.contacts_begin; i < f.contacts_end; ++i) {
+      normal_impulse += contacts_[i].applied_impulse;
+    }
+
+    auto& body_0 = deltas_[f.solver_bodies_[0]];
+    auto& body_1 = deltas_[f.solver_bodies_[1]];
+    return f.solve(&body_0.linear, &body_0.angular, &body_1.linear,
+                   &body_1.angular, normal_impulse);
+  }
+
+  // Returns the sum of the squared changes of the impulses.
+  real_t solveBlock_(ContactBlock<CFG> const& block) {
+    enum { max_size = ContactBlock<CFG>::max_size };
+    auto* first = &contacts_[block.contacts_begin];
+    auto size = block.size();
+
+    if(size == 1) {
+      auto d_impulse = solveContact_(*first, deltas_.data());
+      return d_impulse * d_impulse;
+    }
+
+    auto* body_0 = &deltas_[first->solver_bodies_[0]];
+    auto* body_1 = &deltas_[first->solver_bodies_[1]];
+
+    // Same as solveContact_(), with the velocities that the current impulses
+    // are responsible for added back, since they get replaced as a whole.
+    std::array<real_t, max_size> q = {};
+    uint32_t active = 0;
+    for(uint32_t i = 0; i < size; ++i) {
+      auto const& c = first[i];
+      real_t vel = dot(c.normals[0], body_0->linear) +
+                   dot(c.relpos_cross_normal[0], body_0->angular) +
+                   dot(c.normals[1], body_1->linear) +
+                   dot(c.relpos_cross_normal[1], body_1->angular);
+
+      q[i] = (c.impulse - c.applied_impulse * c.cfm) / c.jac_diag_ab_inv - vel;
+      for(uint32_t j = 0; j < size; ++j) {
+        q[i] += block.mass[i * max_size + j] * first[j].applied_impulse;
+      }
+
+      if(c.applied_impulse > real_t(0)) {
+        active |= 1u << i;
+      }
+    }
+
+    std::array<real_t, max_size> impulses = {};
+    if(!block.solve(q.data(), active, impulses.data())) {
+      real_t residual = 0;
+      for(uint32_t i = 0; i < size; ++i) {
+        auto d_impulse = solveContact_(first[i], deltas_.data());
+        residual += d_impulse * d_impulse;
+      }
+      return residual;
+    }
+
+    real_t residual = 0;
+    for(uint32_t i = 0; i < size; ++i) {
+      auto& c = first[i];
+      real_t d_impulse = impulses[i] - c.applied_impulse;
+      c.applied_impulse = impulses[i];
+
+      body_0->applyImpulse(c.normals[0] * c.inv_mass[0],
+                           c.angular_component[0], d_impulse);
+      body_1->applyImpulse(c.normals[1] * c.inv_mass[1],
+                           c.angular_component[1], d_impulse);
+      residual += d_impulse * d_impulse;
+    }
+    return residual;
+  }
+
+  // Solves the island's contacts once more from the bottom up, with the
+  // lower body of each treated as infinitely heavy, so that the ones above
+  // cannot push it back down.
+  void propagateShock_(Island const& island) {
+    for(auto i = island.contacts_begin; i < island.contacts_end; ++i) {
+      auto& c = contacts_[i];
+      auto depth_0 = depth_(c.solver_bodies_[0]);
+      auto depth_1 = depth_(c.solver_bodies_[1]);
+      if(depth_0 == depth_1) {
+        solveContact_(c, deltas_.data());
+      } else {
+        solveOneSided_(c, depth_0 < depth_1 ? 1 : 0);
+      }
+    }
+  }
+
+  // Same as solveContact_(), with only the given side moving.
+  void solveOneSided_(seqi_solver::ContactConstraint<CFG>& c, int side) {
+    auto* body = &deltas_[c.solver_bodies_[side]];
+    auto* body_0 = &deltas_[c.solver_bodies_[0]];
+    auto* body_1 = &deltas_[c.solver_bodies_[1]];
+
+    real_t vel = dot(c.normals[0], body_0->linear) +
+                 dot(c.relpos_cross_normal[0], body_0->angular) +
+                 dot(c.normals[1], body_1->linear) +
+                 dot(c.relpos_cross_normal[1], body_1->angular);
+
+    // jac_diag_ab_inv includes both bodies, and the cfm.
+    real_t cfm = c.cfm / c.jac_diag_ab_inv;
+    real_t denom =
+        dot(c.normals[side], c.normals[side]) * c.inv_mass[side] +
+        dot(c.relpos_cross_normal[side], c.angular_component[side]) + cfm;
+
+    real_t d_impulse =
+        ((c.impulse - c.applied_impulse * c.cfm) / c.jac_diag_ab_inv - vel) /
+        denom;
+
+    auto new_impulse = c.applied_impulse + d_impulse;
+    if(new_impulse < c.getLowerLimit()) {
+      d_impulse = c.getLowerLimit() - c.applied_impulse;
+      new_impulse = c.getLowerLimit();
+    }
+    c.applied_impulse = new_impulse;
+
+    body->applyImpulse(c.normals[side] * c.inv_mass[side],
+                       c.angular_component[side], d_impulse);
+  }
+
+  // Solves the contact against the velocity deltas of the bodies, found at
+  // deltas[c.solver_bodies_].
+  static real_t solveContact_(seqi_solver::ContactConstraint<CFG>& c,
+                              BodyDelta<CFG>* deltas) {
     real_t d_impulse = c.impulse - c.applied_impulse * c.cfm;
 
-    auto* body_0 = c.solver_bodies_[0];
-    auto* body_1 = c.solver_bodies_[1];
+    auto* body_0 = &deltas[c.solver_bodies_[0]];
+    auto* body_1 = &deltas[c.solver_bodies_[1]];
 
-    real_t dv_0_dot_n = dot(c.normals[0], body_0->delta_v) +
-                        dot(c.relpos_cross_normal[0], body_0->delta_w);
-    real_t dv_1_dot_n = dot(c.normals[1], body_1->delta_v) +
-                        dot(c.relpos_cross_normal[1], body_1->delta_w);
+    real_t dv_0_dot_n = dot(c.normals[0], body_0->linear) +
+                        dot(c.relpos_cross_normal[0], body_0->angular);
+    real_t dv_1_dot_n = dot(c.normals[1], body_1->linear) +
+                        dot(c.relpos_cross_normal[1], body_1->angular);
 
     d_impulse -= dv_0_dot_n * c.jac_diag_ab_inv;
     d_impulse -= dv_1_dot_n * c.jac_diag_ab_inv;
@@ -149,10 +649,10 @@ class Solver {
 
     c.applied_impulse = new_impulse;
 
-    body_0->applyImpulse(c.normals[0] * body_0->inv_mass,
-                         c.angular_component[0], d_impulse);
-    body_1->applyImpulse(c.normals[1] * body_1->inv_mass,
-                         c.angular_component[1], d_impulse);
+    body_0->applyImpulse(c.normals[0] * c.inv_mass[0], c.angular_component[0],
+                         d_impulse);
+    body_1->applyImpulse(c.normals[1] * c.inv_mass[1], c.angular_component[1],
+                         d_impulse);
 
     return d_impulse;
   }
@@ -161,11 +661,84 @@ class Solver {
   real_t dt_;
 
   Config<CFG> config_;
+
+  // Setup and finish data of each body, by solver_id_, followed by the body
+  // shared by all static objects.
   std::vector<seqi_solver::Body<CFG>> bodies_;
+  uint32_t static_index_ = 0;
+
+  // Velocity deltas and push velocities of bodies_, which are all the
+  // iterations touch. Constraints refer to bodies by their index in them.
+  BodyDeltas<CFG> deltas_;
+  BodyDeltas<CFG> push_deltas_;
+
   std::vector<seqi_solver::ContactConstraint<CFG>> contacts_;
 
-  // Static body shared by all static objects.
-  seqi_solver::Body<CFG> staticBody;
+  // One per collision with points, next to its contacts.
+  std::vector<FrictionConstraint<CFG>> frictions_;
+
+  // One per collision with points, when Config::block_contacts is set.
+  std::vector<ContactBlock<CFG>> blocks_;
+
+  // Solved before the contacts of their island.
+  std::vector<JointConstraint<CFG>> joints_;
+  std::vector<Island> islands_;
+
+  // Whether the contacts of the current solve() went through batches_.
+  bool batched_ = false;
+  ContactBatches<CFG> batches_;
+
+  // Pool the batches are spread across, if any.
+  ThreadPool* thread_pool_ = nullptr;
+
+  // Whether the current solve() ends with propagateShock_().
+  bool shock_propagation_ = false;
+
+  std::vector<IslandStats> island_stats_;
+
+  enum : uint32_t {
+    // Depth of the bodies that do not rest on the ground, even indirectly.
+    unsupported_ = std::numeric_limits<uint32_t>::max(),
+    // Index of static objects' bodies.
+    no_body_ = std::numeric_limits<uint32_t>::max()
+  };
+
+  // Only filled with Config::shock_propagation, see orderBottomUp_().
+  std::vector<uint32_t> depths_;
+  std::vector<uint32_t> links_begin_;
+  std::vector<uint32_t> links_;
+  std::vector<uint32_t> queue_;
+  std::vector<std::pair<uint32_t, Collision<CFG>*>> collision_depths_;
+  std::vector<Collision<CFG>*> ordered_collisions_;
+
+  uint32_t depth_(uint32_t body) const {
+    return body == static_index_ ? 0 : depths_[body];
+  }
+
+  // Applies part of the contact's impulse from the previous step up front.
+  void warmStart_(seqi_solver::ContactConstraint<CFG>& c) {
+    real_t impulse = c.contact_->applied_impulse * config_.warm_start_factor;
+    if(impulse == real_t(0)) {
+      return;
+    }
+
+    c.applied_impulse = impulse;
+
+    deltas_[c.solver_bodies_[0]].applyImpulse(c.normals[0] * c.inv_mass[0],
+                                              c.angular_component[0], impulse);
+    deltas_[c.solver_bodies_[1]].applyImpulse(c.normals[1] * c.inv_mass[1],
+                                              c.angular_component[1], impulse);
+  }
+
+  template <typename ALGO>
+  void addJoint_(Joint<CFG, ALGO>* joint) {
+    auto body_1 = joint->bodies_[1];
+    uint32_t index_0 = joint->bodies_[0]->solver_id_;
+    uint32_t index_1 = body_1 ? body_1->solver_id_ : static_index_;
+
+    joints_.emplace_back(joint, bodies_, index_0, index_1, dt_, config_.erp);
+    joints_.back().warmStart(config_.warm_start_factor, deltas_.data());
+  }
 
   template <typename ALGO>
   void addCollision_(Collision<CFG>* col) {
@@ -174,10 +747,10 @@ class Solver {
     auto dyn_obj_1 =
         DynamicBody<CFG, ALGO>::fromCollisionObject(col->objects[1]);
 
-    seqi_solver::Body<CFG>* solver_body_0 =
-        dyn_obj_0 ? &bodies_[dyn_obj_0->solver_id_] : &staticBody;
-    seqi_solver::Body<CFG>* solver_body_1 =
-        dyn_obj_1 ? &bodies_[dyn_obj_1->solver_id_] : &staticBody;
+    uint32_t index_0 = dyn_obj_0 ? dyn_obj_0->solver_id_ : static_index_;
+    uint32_t index_1 = dyn_obj_1 ? dyn_obj_1->solver_id_ : static_index_;
+    auto const* solver_body_0 = &bodies_[index_0];
+    auto const* solver_body_1 = &bodies_[index_1];
 
     // No fuzzy-float check needed, infinite mass should always be a
     // hard-assigned 0. Hitting this should imply the existence of a
@@ -200,9 +773,30 @@ class Solver {
       vec3_t vel = vel_0 - vel_1;
       real_t relative_vel = dot(contact.ws_normal, vel);
 
-      contacts_.emplace_back(config_, dt_, &contact, solver_body_0,
-                             solver_body_1, rel_pos_0, rel_pos_1, relative_vel);
+      contacts_.emplace_back(config_, dt_, &contact, bodies_, index_0, index_1,
+                             rel_pos_0, rel_pos_1, relative_vel);
+      warmStart_(contacts_.back());
+    }
+
+    auto contacts_end = uint32_t(contacts_.size());
+    auto contacts_begin = contacts_end - uint32_t(col->points.size());
+    if(config_.block_contacts && contacts_begin != contacts_end) {
+      blocks_.emplace_back(contacts_.data(), contacts_begin, contacts_end);
+    }
+
+    bool has_friction =
+        col->objects[0]->friction * col->objects[1]->friction > real_t(0);
+    if(col->points.size() == 0 || !has_friction) {
+      // Nothing to carry over to the next time they touch.
+      col->friction_impulse_ = {0, 0, 0};
+      col->twist_impulse_ = 0;
+      return;
     }
+
+    frictions_.emplace_back(col, bodies_, index_0, index_1, contacts_begin,
+                            contacts_end);
+    frictions_.back().warmStart(col->friction_impulse_, col->twist_impulse_,
+                                config_.warm_start_factor, deltas_.data());
   }
 };
 }
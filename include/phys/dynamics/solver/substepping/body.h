@@ -0,0 +1,75 @@
+#ifndef PHYS_SUBSTEP_SOLVER_BODY_H
+#define PHYS_SUBSTEP_SOLVER_BODY_H
+
+#include "phys/dynamics/dynamic_body.h"
+#include "phys/math_types/transform.h"
+
+namespace phys {
+namespace substep_solver {
+
+template <typename CFG>
+struct Body {
+  using vec3_t = typename CFG::vec3_t;
+  using real_t = typename CFG::real_t;
+  using mat3x3_t = typename CFG::mat3x3_t;
+
+  // The static body, that never moves.
+  Body() {}
+
+  Body(DynamicBodyData<CFG>* tgt, real_t substep_dt) {
+    target = tgt;
+    start_transform = *target->transform;
+    transform = start_transform;
+
+    inv_mass = real_t(1) / target->mass_;
+    inv_inertia = target->inv_inertia_tensor_world_;
+    linear_velocity = target->linear_velocity_;
+    angular_velocity = target->angular_velocity_;
+
+    force_impulse = target->net_force_ * (inv_mass * substep_dt);
+    torque_impulse = inv_inertia * target->net_torque_ * substep_dt;
+  }
+
+  DynamicBodyData<CFG>* target = nullptr;
+
+  // Where the body was at the start of the step, and where the substeps
+  // moved it so far.
+  Transform<CFG> start_transform;
+  Transform<CFG> transform;
+
+  real_t inv_mass = real_t(0);
+  mat3x3_t inv_inertia = mat3x3_t(real_t(0));
+
+  vec3_t linear_velocity = {0, 0, 0};
+  vec3_t angular_velocity = {0, 0, 0};
+
+  // Applied at the start of every substep.
+  vec3_t force_impulse = {0, 0, 0};
+  vec3_t torque_impulse = {0, 0, 0};
+
+  void applyImpulse(vec3_t const& lin, vec3_t const& ang, real_t mag) {
+    linear_velocity += lin * mag;
+    angular_velocity += ang * mag;
+  }
+
+  void integrateVelocity() {
+    linear_velocity += force_impulse;
+    angular_velocity += torque_impulse;
+  }
+
+  void integratePosition(real_t substep_dt) {
+    Transform<CFG> next;
+    integrateTransform(transform, linear_velocity, angular_velocity,
+                       substep_dt, &next);
+    transform = next;
+  }
+
+  void finish() {
+    target->linear_velocity_ = linear_velocity;
+    target->angular_velocity_ = angular_velocity;
+    *target->transform = transform;
+  }
+};
+}
+}
+#endif
\ No newline at end of file
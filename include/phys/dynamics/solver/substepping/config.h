@@ -0,0 +1,32 @@
+#ifndef PHYS_SUBSTEP_SOLVER_CONFIG_H
+#define PHYS_SUBSTEP_SOLVER_CONFIG_H
+
+namespace phys {
+namespace substep_solver {
+template <typename CFG>
+struct Config {
+  using real_t = typename CFG::real_t;
+
+  // Number of substeps each step is split into.
+  int substeps = 4;
+
+  // Iterations per substep, with and without the push that resolves
+  // penetrations.
+  int iterations = 1;
+  int relax_iterations = 1;
+
+  // Penetrating contacts push the bodies apart like a spring with this
+  // frequency and damping ratio, at no more than max_push_velocity. The
+  // frequency is capped to a quarter of the substeps' rate.
+  real_t contact_hertz = real_t(60);
+  real_t contact_damping_ratio = real_t(10);
+  real_t max_push_velocity = real_t(3);
+
+  // Contacts start from this fraction of the impulse they ended the previous
+  // step with. 0 disables it.
+  real_t warm_start_factor = real_t(1);
+};
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,234 @@
+#ifndef PHYS_SUBSTEP_SOLVER_CONTACT_CONSTRAINT_H
+#define PHYS_SUBSTEP_SOLVER_CONTACT_CONSTRAINT_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "phys/collision/collision.h"
+#include "phys/dynamics/solver/substepping/body.h"
+#include "phys/math_types/tangent.h"
+
+namespace phys {
+namespace substep_solver {
+
+// A contact point, with its friction.
+//
+// The jacobians are computed once per step, but the separation is measured
+// again at every substep, from where the bodies moved the point's anchors.
+template <typename CFG>
+struct ContactConstraint {
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum { NORMAL, TANGENT_0, TANGENT_1, row_count };
+
+  struct Row {
+    // Jacobian of each body.
+    std::array<vec3_t, 2> linear;
+    std::array<vec3_t, 2> relpos_cross;
+
+    // relpos_cross, through each body's inverse inertia.
+    std::array<vec3_t, 2> angular_component;
+
+    real_t mass = 0;
+    real_t impulse = 0;
+  };
+
+  ContactConstraint() {}
+
+  ContactConstraint(Contact<CFG>* contact, Body<CFG>* body_0, Body<CFG>* body_1,
+                    real_t friction)
+      : contact_(contact), bodies_({{body_0, body_1}}), friction(friction) {
+    normal = contact->ws_normal;
+    separation = contact->distance;
+    restitution = contact->total_restitution;
+
+    std::array<vec3_t, 2> rel_pos;
+    for(int side = 0; side < 2; ++side) {
+      auto const& trans = bodies_[side]->start_transform;
+      rel_pos[side] = contact->ws_position[side] - trans.getTranslation();
+      start_anchors[side] = trans.applyToVec(contact->os_position[side]);
+    }
+
+    auto tangent_0 = anyTangent<CFG>(normal);
+    auto tangent_1 = cross(normal, tangent_0);
+    setRow_(&rows[NORMAL], normal, rel_pos);
+    setRow_(&rows[TANGENT_0], tangent_0, rel_pos);
+    setRow_(&rows[TANGENT_1], tangent_1, rel_pos);
+
+    relative_velocity = getVelocity_(rows[NORMAL]);
+  }
+
+  // Starts the rows from the given impulses. They are applied again at the
+  // start of every substep.
+  void setImpulses(real_t normal_impulse, vec3_t const& tangent_impulse) {
+    rows[NORMAL].impulse = normal_impulse;
+    for(int i = 0; i < 2; ++i) {
+      auto& row = rows[TANGENT_0 + i];
+      row.impulse = dot(tangent_impulse, row.linear[0]);
+    }
+  }
+
+  vec3_t getTangentImpulse() const {
+    return rows[TANGENT_0].linear[0] * rows[TANGENT_0].impulse +
+           rows[TANGENT_1].linear[0] * rows[TANGENT_1].impulse;
+  }
+
+  void warmStart() {
+    for(auto const& row : rows) {
+      apply_(row, row.impulse);
+    }
+  }
+
+  // Where the anchors moved since the start of the step tells how much the
+  // separation changed, along the normal of the step.
+  real_t getSeparation() const {
+    real_t result = separation;
+    for(int side = 0; side < 2; ++side) {
+      auto const* body = bodies_[side];
+      if(body->target) {
+        vec3_t anchor = body->transform.applyToVec(contact_->os_position[side]);
+        result += dot(rows[NORMAL].linear[side], anchor - start_anchors[side]);
+      }
+    }
+    return result;
+  }
+
+  // How soft contacts are while they push penetrations apart, see
+  // Solver::getSoftness_().
+  struct Softness {
+    real_t bias_rate;
+    real_t mass_scale;
+    real_t impulse_scale;
+  };
+
+  // Speculative contacts only let the bodies close the gap, and penetrating
+  // ones push them apart, softly, when use_bias is set. Otherwise, they are
+  // rigid. Returns the squared change of the impulse.
+  real_t solveNormal(real_t substep_dt_inv, Softness const& softness,
+                     real_t max_push, bool use_bias) {
+    real_t current = getSeparation();
+    real_t bias = 0;
+    real_t mass_scale = 1;
+    real_t impulse_scale = 0;
+    if(current > real_t(0)) {
+      bias = current * substep_dt_inv;
+    } else if(use_bias) {
+      bias = std::max(current * softness.bias_rate, -max_push);
+      mass_scale = softness.mass_scale;
+      impulse_scale = softness.impulse_scale;
+    }
+
+    auto& row = rows[NORMAL];
+    real_t d_impulse = -row.mass * mass_scale * (getVelocity_(row) + bias) -
+                       impulse_scale * row.impulse;
+    real_t new_impulse = std::max(row.impulse + d_impulse, real_t(0));
+    d_impulse = new_impulse - row.impulse;
+    row.impulse = new_impulse;
+    apply_(row, d_impulse);
+    return d_impulse * d_impulse;
+  }
+
+  // Clamps both tangents together to a disc. Returns the sum of the squared
+  // changes of the impulses.
+  real_t solveFriction() {
+    real_t limit = friction * rows[NORMAL].impulse;
+
+    std::array<real_t, 2> new_impulse;
+    for(int i = 0; i < 2; ++i) {
+      auto const& row = rows[TANGENT_0 + i];
+      new_impulse[i] = row.impulse - row.mass * getVelocity_(row);
+    }
+
+    real_t len_sq =
+        new_impulse[0] * new_impulse[0] + new_impulse[1] * new_impulse[1];
+    if(len_sq > limit * limit) {
+      real_t scale = limit > 0 ? limit / std::sqrt(len_sq) : real_t(0);
+      new_impulse[0] *= scale;
+      new_impulse[1] *= scale;
+    }
+
+    real_t residual = 0;
+    for(int i = 0; i < 2; ++i) {
+      auto& row = rows[TANGENT_0 + i];
+      real_t d_impulse = new_impulse[i] - row.impulse;
+      row.impulse = new_impulse[i];
+      apply_(row, d_impulse);
+      residual += d_impulse * d_impulse;
+    }
+    return residual;
+  }
+
+  // Bounces back with a fraction of the velocity the bodies approached with
+  // at the start of the step.
+  void applyRestitution() {
+    if(restitution == real_t(0) || relative_velocity >= real_t(0)) {
+      return;
+    }
+
+    auto& row = rows[NORMAL];
+    real_t target = -restitution * relative_velocity;
+    real_t new_impulse = std::max(
+        row.impulse - row.mass * (getVelocity_(row) - target), real_t(0));
+    apply_(row, new_impulse - row.impulse);
+    row.impulse = new_impulse;
+  }
+
+  Contact<CFG>* contact_ = nullptr;
+  std::array<Body<CFG>*, 2> bodies_;
+
+  real_t friction = 0;
+  real_t restitution = 0;
+
+  // Along the normal, at the start of the step.
+  real_t separation = 0;
+  real_t relative_velocity = 0;
+
+  vec3_t normal;
+  std::array<vec3_t, 2> start_anchors;
+  std::array<Row, row_count> rows;
+
+ private:
+  // Fills a row pushing the first body along dir, and the second one
+  // against it.
+  void setRow_(Row* row, vec3_t const& dir,
+               std::array<vec3_t, 2> const& rel_pos) {
+    row->linear = {{dir, -dir}};
+    row->relpos_cross = {{cross(rel_pos[0], dir), -cross(rel_pos[1], dir)}};
+
+    real_t denom = 0;
+    for(int side = 0; side < 2; ++side) {
+      auto const* body = bodies_[side];
+      row->angular_component[side] =
+          body->inv_inertia * row->relpos_cross[side];
+      if(body->target) {
+        denom += body->inv_mass +
+                 dot(row->relpos_cross[side], row->angular_component[side]);
+      }
+    }
+
+    row->mass = denom > 0 ? real_t(1) / denom : real_t(0);
+    row->impulse = 0;
+  }
+
+  real_t getVelocity_(Row const& row) const {
+    real_t vel = 0;
+    for(int side = 0; side < 2; ++side) {
+      auto const* body = bodies_[side];
+      vel += dot(row.linear[side], body->linear_velocity) +
+             dot(row.relpos_cross[side], body->angular_velocity);
+    }
+    return vel;
+  }
+
+  void apply_(Row const& row, real_t impulse) {
+    for(int side = 0; side < 2; ++side) {
+      auto* body = bodies_[side];
+      body->applyImpulse(row.linear[side] * body->inv_mass,
+                         row.angular_component[side], impulse);
+    }
+  }
+};
+}
+}
+#endif
\ No newline at end of file
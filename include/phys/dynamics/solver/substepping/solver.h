@@ -0,0 +1,222 @@
+#ifndef PHYS_SUBSTEP_SOLVER_SOLVER_H
+#define PHYS_SUBSTEP_SOLVER_SOLVER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "phys/dynamics/joint.h"
+#include "phys/dynamics/solver/substepping/body.h"
+#include "phys/dynamics/solver/substepping/config.h"
+#include "phys/dynamics/solver/substepping/contact_constraint.h"
+#include "phys/util_types/array_view.h"
+#include "phys/util_types/thread_pool.h"
+
+namespace phys {
+namespace substep_solver {
+
+// Splits each step into substeps, that each run a single iteration or so.
+//
+// Instead of running the narrowphase again, every substep measures the
+// contacts' separation from where the bodies moved their anchors so far.
+// Since each substep starts from the positions and velocities the previous
+// one left, this converges much faster per iteration than iterating more on
+// a whole step, especially between bodies of very different masses.
+//
+// The bodies are moved by the solver, through the substeps, rather than by
+// the World. Speculative contacts keep them from going through what they
+// are about to hit, as with the other solvers.
+template <typename CFG>
+class Solver {
+ public:
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  enum {
+    integrates_transforms = 1,
+
+    // Joints are not supported yet, World::createJoint() does not compile.
+    supports_joints = 0,
+  };
+
+  Solver(Config<CFG> const& cfg = Config<CFG>()) : config_(cfg) {}
+
+  Config<CFG>& config() {
+    return config_;
+  }
+
+  // Islands are not solved separately, and every substep runs the same
+  // iterations, so there are no statistics to report.
+  struct IslandStats {};
+
+  std::vector<IslandStats> const& islandStats() const {
+    return island_stats_;
+  }
+
+  void clearIslandStats() {}
+
+  // Islands are never spread across threads.
+  bool splitsIsland(std::size_t /*contact_count*/,
+                    std::size_t /*joint_count*/) const {
+    return false;
+  }
+
+  // The collisions may belong to several islands, which does not make a
+  // difference here. The thread pool is not used, and there are no joints,
+  // see supports_joints.
+  template <typename ALGO>
+  void solve(ArrayView<DynamicBody<CFG, ALGO>*> objects,
+             ArrayView<Collision<CFG>*> collisions,
+             ArrayView<Joint<CFG, ALGO>*> /*joints*/, real_t dt,
+             ThreadPool* /*thread_pool*/ = nullptr) {
+    real_t substep_dt = dt / real_t(config_.substeps);
+    real_t substep_dt_inv = real_t(1) / substep_dt;
+    softness_ = getSoftness_(substep_dt);
+    setup_(objects, collisions, substep_dt);
+
+    for(int substep = 0; substep < config_.substeps; ++substep) {
+      for(auto& body : bodies_) {
+        body.integrateVelocity();
+      }
+
+      for(auto& contact : contacts_) {
+        contact.warmStart();
+      }
+
+      for(int i = 0; i < config_.iterations; ++i) {
+        solveIteration_(substep_dt_inv, true);
+      }
+
+      for(auto& body : bodies_) {
+        body.integratePosition(substep_dt);
+      }
+
+      // Takes out the velocity that pushing penetrations apart added, so that
+      // the bodies do not keep it.
+      for(int i = 0; i < config_.relax_iterations; ++i) {
+        solveIteration_(substep_dt_inv, false);
+      }
+    }
+
+    for(auto& contact : contacts_) {
+      contact.applyRestitution();
+    }
+
+    finish_();
+  }
+
+ private:
+  Config<CFG> config_;
+  std::vector<IslandStats> island_stats_;
+  std::vector<Body<CFG>> bodies_;
+  std::vector<ContactConstraint<CFG>> contacts_;
+
+  // Body shared by all static objects.
+  Body<CFG> static_body_;
+
+  typename ContactConstraint<CFG>::Softness softness_;
+
+  // Range of contacts_ of each collision with points.
+  struct Manifold_ {
+    Collision<CFG>* collision;
+    uint32_t contacts_begin;
+    uint32_t contacts_end;
+  };
+  std::vector<Manifold_> manifolds_;
+
+  template <typename ALGO>
+  void setup_(ArrayView<DynamicBody<CFG, ALGO>*> objects,
+              ArrayView<Collision<CFG>*> collisions, real_t substep_dt) {
+    bodies_.resize(0);
+    contacts_.resize(0);
+    manifolds_.resize(0);
+
+    bodies_.reserve(objects.size());
+    for(auto obj : objects) {
+      obj->solver_id_ = uint32_t(bodies_.size());
+      bodies_.emplace_back(&obj->dynamics_data_, substep_dt);
+    }
+
+    for(auto col : collisions) {
+      addCollision_<ALGO>(col);
+    }
+  }
+
+  template <typename ALGO>
+  void addCollision_(Collision<CFG>* col) {
+    if(col->points.size() == 0) {
+      col->friction_impulse_ = {0, 0, 0};
+      col->twist_impulse_ = 0;
+      return;
+    }
+
+    std::array<Body<CFG>*, 2> bodies;
+    for(int side = 0; side < 2; ++side) {
+      auto dyn_obj =
+          DynamicBody<CFG, ALGO>::fromCollisionObject(col->objects[side]);
+      bodies[side] = dyn_obj ? &bodies_[dyn_obj->solver_id_] : &static_body_;
+    }
+
+    real_t friction =
+        std::sqrt(col->objects[0]->friction * col->objects[1]->friction);
+
+    // Impulses are kept per step, and applied at every substep, the
+    // collision's friction being shared evenly by its points.
+    real_t factor = config_.warm_start_factor / real_t(config_.substeps);
+    vec3_t tangent_impulse =
+        col->friction_impulse_ * (factor / real_t(col->points.size()));
+
+    auto contacts_begin = uint32_t(contacts_.size());
+    for(auto& point : col->points) {
+      contacts_.emplace_back(&point, bodies[0], bodies[1], friction);
+      contacts_.back().setImpulses(point.applied_impulse * factor,
+                                   tangent_impulse);
+    }
+    manifolds_.push_back({col, contacts_begin, uint32_t(contacts_.size())});
+  }
+
+  // Contacts pushing penetrations apart act as damped springs, which keeps
+  // them from overshooting, and from feeding the overshoot back through warm
+  // starting. The spring is kept well below what the substeps can resolve.
+  typename ContactConstraint<CFG>::Softness getSoftness_(real_t substep_dt) {
+    real_t hertz = std::min(config_.contact_hertz, real_t(0.25) / substep_dt);
+    real_t omega = real_t(2 * 3.14159265358979) * hertz;
+    real_t a_1 = real_t(2) * config_.contact_damping_ratio + substep_dt * omega;
+    real_t a_2 = substep_dt * omega * a_1;
+    real_t a_3 = real_t(1) / (real_t(1) + a_2);
+    return {omega / a_1, a_2 * a_3, a_3};
+  }
+
+  void solveIteration_(real_t substep_dt_inv, bool use_bias) {
+    for(auto& contact : contacts_) {
+      contact.solveNormal(substep_dt_inv, softness_, config_.max_push_velocity,
+                          use_bias);
+      contact.solveFriction();
+    }
+  }
+
+  void finish_() {
+    real_t substeps = real_t(config_.substeps);
+    for(auto& contact : contacts_) {
+      contact.contact_->applied_impulse =
+          contact.rows[ContactConstraint<CFG>::NORMAL].impulse * substeps;
+    }
+
+    for(auto const& manifold : manifolds_) {
+      vec3_t tangent_impulse = {0, 0, 0};
+      for(auto i = manifold.contacts_begin; i < manifold.contacts_end; ++i) {
+        tangent_impulse += contacts_[i].getTangentImpulse();
+      }
+      manifold.collision->friction_impulse_ = tangent_impulse * substeps;
+      manifold.collision->twist_impulse_ = 0;
+    }
+
+    for(auto& body : bodies_) {
+      body.finish();
+    }
+  }
+};
+}
+}
+#endif
\ No newline at end of file
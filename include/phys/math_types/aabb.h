@@ -12,6 +12,11 @@ struct Aabb {
   Aabb();
   Aabb(vec3_t const& half_extent, Transform<CFG> const& transform);
 
+  // Bounds of a box centered on center, both expressed in the local space of
+  // transform.
+  Aabb(vec3_t const& center, vec3_t const& half_extent,
+       Transform<CFG> const& transform);
+
   vec3_t min_bound;
   vec3_t max_bound;
 };
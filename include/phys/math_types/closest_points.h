@@ -0,0 +1,41 @@
+#ifndef PHYS_TYPES_CLOSEST_POINTS_H
+#define PHYS_TYPES_CLOSEST_POINTS_H
+
+namespace phys {
+
+// Returns the parameter t in [0, 1] of the point of segment [a, b] that is
+// closest to p.
+template <typename CFG>
+typename CFG::real_t closestPointOnSegment(typename CFG::vec3_t const& a,
+                                           typename CFG::vec3_t const& b,
+                                           typename CFG::vec3_t const& p);
+
+// Finds the closest points between segments [p0, p1] and [q0, q1].
+// Writes their parameters along each segment in s and t.
+template <typename CFG>
+void closestPointsSegmentSegment(typename CFG::vec3_t const& p0,
+                                 typename CFG::vec3_t const& p1,
+                                 typename CFG::vec3_t const& q0,
+                                 typename CFG::vec3_t const& q1,
+                                 typename CFG::real_t* s,
+                                 typename CFG::real_t* t);
+
+// Returns the point of triangle (a, b, c) that is closest to p.
+template <typename CFG>
+typename CFG::vec3_t closestPointOnTriangle(typename CFG::vec3_t const& a,
+                                           typename CFG::vec3_t const& b,
+                                           typename CFG::vec3_t const& c,
+                                           typename CFG::vec3_t const& p);
+
+// Finds the point of segment [p0, p1] that is closest to an origin-centered
+// box. Writes its parameter in t and returns the squared distance, which is 0
+// if the segment intersects the box.
+template <typename CFG>
+typename CFG::real_t closestPointSegmentBox(
+    typename CFG::vec3_t const& half_extent, typename CFG::vec3_t const& p0,
+    typename CFG::vec3_t const& p1, typename CFG::real_t* t);
+}
+
+#include "phys/math_types/impl/closest_points_impl.h"
+
+#endif
\ No newline at end of file
@@ -1,19 +1,33 @@
 #ifndef PHYS_TYPES_AABB_IMPL_H
 #define PHYS_TYPES_AABB_IMPL_H
 
+#include <cmath>
+
 namespace phys {
 
 template <typename CFG>
 Aabb<CFG>::Aabb() {}
 
 template <typename CFG>
-Aabb<CFG>::Aabb(vec3_t const& half_extent, Transform<CFG> const& transform) {
-  auto const& trans = transform.getTranslation();
+Aabb<CFG>::Aabb(vec3_t const& half_extent, Transform<CFG> const& transform)
+    : Aabb(vec3_t{0, 0, 0}, half_extent, transform) {}
+
+template <typename CFG>
+Aabb<CFG>::Aabb(vec3_t const& center, vec3_t const& half_extent,
+                Transform<CFG> const& transform) {
+  vec3_t world_center = transform.applyToVec(center);
+
+  // The extent of the rotated box along each world axis.
   auto const& rot = transform.getRotationMatrix();
-  vec3_t rotated_extent = abs(rot * half_extent);
+  vec3_t rotated_extent;
+  for(int i = 0; i < 3; ++i) {
+    rotated_extent[i] = std::abs(rot[0][i]) * half_extent[0] +
+                        std::abs(rot[1][i]) * half_extent[1] +
+                        std::abs(rot[2][i]) * half_extent[2];
+  }
 
-  min_bound = trans - rotated_extent;
-  max_bound = trans + rotated_extent;
+  min_bound = world_center - rotated_extent;
+  max_bound = world_center + rotated_extent;
 }
 }
 
@@ -0,0 +1,210 @@
+#ifndef PHYS_TYPES_CLOSEST_POINTS_IMPL_H
+#define PHYS_TYPES_CLOSEST_POINTS_IMPL_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace phys {
+
+template <typename CFG>
+typename CFG::real_t closestPointOnSegment(typename CFG::vec3_t const& a,
+                                           typename CFG::vec3_t const& b,
+                                           typename CFG::vec3_t const& p) {
+  using real_t = typename CFG::real_t;
+
+  auto ab = b - a;
+  real_t len_sq = dot(ab, ab);
+  if(len_sq <= std::numeric_limits<real_t>::epsilon()) {
+    return real_t(0);
+  }
+
+  real_t t = dot(p - a, ab) / len_sq;
+  return std::min(std::max(t, real_t(0)), real_t(1));
+}
+
+template <typename CFG>
+void closestPointsSegmentSegment(typename CFG::vec3_t const& p0,
+                                 typename CFG::vec3_t const& p1,
+                                 typename CFG::vec3_t const& q0,
+                                 typename CFG::vec3_t const& q1,
+                                 typename CFG::real_t* s,
+                                 typename CFG::real_t* t) {
+  using real_t = typename CFG::real_t;
+  auto const eps = std::numeric_limits<real_t>::epsilon();
+  auto clamp01 = [](real_t v) {
+    return std::min(std::max(v, real_t(0)), real_t(1));
+  };
+
+  auto d1 = p1 - p0;
+  auto d2 = q1 - q0;
+  auto r = p0 - q0;
+
+  real_t a = dot(d1, d1);
+  real_t e = dot(d2, d2);
+  real_t f = dot(d2, r);
+
+  // Either segment may be degenerate.
+  if(a <= eps && e <= eps) {
+    *s = *t = real_t(0);
+    return;
+  }
+
+  if(a <= eps) {
+    *s = real_t(0);
+    *t = clamp01(f / e);
+    return;
+  }
+
+  real_t c = dot(d1, r);
+  if(e <= eps) {
+    *t = real_t(0);
+    *s = clamp01(-c / a);
+    return;
+  }
+
+  real_t b = dot(d1, d2);
+  real_t denom = a * e - b * b;
+
+  // Parallel segments have infinitely many solutions, any s will do.
+  *s = denom > eps ? clamp01((b * f - c * e) / denom) : real_t(0);
+  *t = (b * *s + f) / e;
+
+  if(*t < real_t(0)) {
+    *t = real_t(0);
+    *s = clamp01(-c / a);
+  } else if(*t > real_t(1)) {
+    *t = real_t(1);
+    *s = clamp01((b - c) / a);
+  }
+}
+
+template <typename CFG>
+typename CFG::vec3_t closestPointOnTriangle(typename CFG::vec3_t const& a,
+                                           typename CFG::vec3_t const& b,
+                                           typename CFG::vec3_t const& c,
+                                           typename CFG::vec3_t const& p) {
+  using real_t = typename CFG::real_t;
+
+  // Walks through the triangle's Voronoi regions, see Ericson's "Real-Time
+  // Collision Detection", 5.1.5.
+  auto ab = b - a;
+  auto ac = c - a;
+  auto ap = p - a;
+  real_t d1 = dot(ab, ap);
+  real_t d2 = dot(ac, ap);
+  if(d1 <= 0 && d2 <= 0) {
+    return a;
+  }
+
+  auto bp = p - b;
+  real_t d3 = dot(ab, bp);
+  real_t d4 = dot(ac, bp);
+  if(d3 >= 0 && d4 <= d3) {
+    return b;
+  }
+
+  real_t vc = d1 * d4 - d3 * d2;
+  if(vc <= 0 && d1 >= 0 && d3 <= 0) {
+    return a + ab * (d1 / (d1 - d3));
+  }
+
+  auto cp = p - c;
+  real_t d5 = dot(ab, cp);
+  real_t d6 = dot(ac, cp);
+  if(d6 >= 0 && d5 <= d6) {
+    return c;
+  }
+
+  real_t vb = d5 * d2 - d1 * d6;
+  if(vb <= 0 && d2 >= 0 && d6 <= 0) {
+    return a + ac * (d2 / (d2 - d6));
+  }
+
+  real_t va = d3 * d6 - d5 * d4;
+  if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+  }
+
+  real_t denom = real_t(1) / (va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+template <typename CFG>
+typename CFG::real_t closestPointSegmentBox(
+    typename CFG::vec3_t const& half_extent, typename CFG::vec3_t const& p0,
+    typename CFG::vec3_t const& p1, typename CFG::real_t* t) {
+  using real_t = typename CFG::real_t;
+
+  auto d = p1 - p0;
+
+  // The squared distance to the box is a convex piecewise quadratic function
+  // of t. Its pieces are delimited by the points where the segment crosses
+  // the box's slabs, and each piece can be minimized in closed form.
+  real_t breaks[8];
+  int break_count = 0;
+  breaks[break_count++] = real_t(0);
+  for(int i = 0; i < 3; ++i) {
+    if(d[i] != real_t(0)) {
+      for(real_t bound : {-half_extent[i], half_extent[i]}) {
+        real_t bt = (bound - p0[i]) / d[i];
+        if(bt > real_t(0) && bt < real_t(1)) {
+          breaks[break_count++] = bt;
+        }
+      }
+    }
+  }
+  breaks[break_count++] = real_t(1);
+  std::sort(breaks, breaks + break_count);
+
+  auto dist_sq_at = [&](real_t at) {
+    real_t result = 0;
+    for(int i = 0; i < 3; ++i) {
+      real_t v = p0[i] + d[i] * at;
+      real_t excess = std::max(std::abs(v) - half_extent[i], real_t(0));
+      result += excess * excess;
+    }
+    return result;
+  };
+
+  real_t best_t = real_t(0);
+  real_t best_dist_sq = dist_sq_at(best_t);
+
+  for(int piece = 0; piece + 1 < break_count; ++piece) {
+    real_t t0 = breaks[piece];
+    real_t t1 = breaks[piece + 1];
+    real_t mid = (t0 + t1) * real_t(0.5);
+
+    // Within a piece, each axis is either inside its slab, or clamped to a
+    // fixed face.
+    real_t num = 0;
+    real_t den = 0;
+    for(int i = 0; i < 3; ++i) {
+      real_t v = p0[i] + d[i] * mid;
+      if(v > half_extent[i]) {
+        num += d[i] * (p0[i] - half_extent[i]);
+        den += d[i] * d[i];
+      } else if(v < -half_extent[i]) {
+        num += d[i] * (p0[i] + half_extent[i]);
+        den += d[i] * d[i];
+      }
+    }
+
+    real_t piece_t = t1;
+    if(den > real_t(0)) {
+      piece_t = std::min(std::max(-num / den, t0), t1);
+    }
+
+    real_t piece_dist_sq = dist_sq_at(piece_t);
+    if(piece_dist_sq < best_dist_sq) {
+      best_dist_sq = piece_dist_sq;
+      best_t = piece_t;
+    }
+  }
+
+  *t = best_t;
+  return best_dist_sq;
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef PHYS_TYPES_TANGENT_IMPL_H
+#define PHYS_TYPES_TANGENT_IMPL_H
+
+#include <cmath>
+
+namespace phys {
+
+template <typename CFG>
+typename CFG::vec3_t anyTangent(typename CFG::vec3_t const& normal) {
+  using real_t = typename CFG::real_t;
+  using vec3_t = typename CFG::vec3_t;
+
+  // Cross with whichever axis is the furthest from the normal.
+  vec3_t axis = std::abs(normal[0]) < real_t(0.57) ? vec3_t{1, 0, 0}
+                                                     : vec3_t{0, 1, 0};
+  return normalize(cross(normal, axis));
+}
+}
+
+#endif
\ No newline at end of file
@@ -47,6 +47,12 @@ Transform<CFG> Transform<CFG>::inverse() const {
   return Transform(inv_rot, inv_rot * -translation_);
 }
 
+template <typename CFG>
+Transform<CFG> Transform<CFG>::operator*(Transform const& rhs) const {
+  return Transform(rotation_ * rhs.rotation_,
+                   rotation_ * rhs.translation_ + translation_);
+}
+
 template <typename CFG>
 bool Transform<CFG>::operator==(Transform const& rhs) const {
   return rotation_ == rhs.rotation_ && translation_ == rhs.translation_;
@@ -0,0 +1,14 @@
+#ifndef PHYS_TYPES_TANGENT_H
+#define PHYS_TYPES_TANGENT_H
+
+namespace phys {
+
+// Returns a unit vector perpendicular to the unit vector normal. Which one
+// is arbitrary, but stable for a given normal.
+template <typename CFG>
+typename CFG::vec3_t anyTangent(typename CFG::vec3_t const& normal);
+}
+
+#include "phys/math_types/impl/tangent_impl.h"
+
+#endif
\ No newline at end of file
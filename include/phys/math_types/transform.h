@@ -23,6 +23,9 @@ struct Transform {
 
   Transform inverse() const;
 
+  // Composition, rhs is applied first.
+  Transform operator*(Transform const& rhs) const;
+
   bool operator==(Transform const& rhs) const;
 
   vec3_t applyToVec(vec3_t const& vec) const;
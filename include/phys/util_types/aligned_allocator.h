@@ -0,0 +1,39 @@
+#ifndef PHYS_MISC_ALIGNED_ALLOCATOR_H
+#define PHYS_MISC_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+
+namespace phys {
+
+// Standard allocator honoring alignof(T), for over-aligned types in
+// containers. std::allocator only does so from C++17 onwards.
+//
+// Each block is over-allocated by the alignment plus a pointer, the latter
+// remembering where the block actually starts.
+template <typename T>
+struct AlignedAllocator {
+  using value_type = T;
+
+  AlignedAllocator() = default;
+
+  template <typename U>
+  AlignedAllocator(AlignedAllocator<U> const&) {}
+
+  T* allocate(std::size_t count);
+  void deallocate(T* ptr, std::size_t count);
+};
+
+template <typename T, typename U>
+bool operator==(AlignedAllocator<T> const&, AlignedAllocator<U> const&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(AlignedAllocator<T> const&, AlignedAllocator<U> const&) {
+  return false;
+}
+}
+
+#include "phys/util_types/impl/aligned_allocator_impl.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef PHYS_MISC_ALIGNED_ALLOCATOR_IMPL_H
+#define PHYS_MISC_ALIGNED_ALLOCATOR_IMPL_H
+
+#include <cstdint>
+#include <new>
+
+namespace phys {
+
+template <typename T>
+T* AlignedAllocator<T>::allocate(std::size_t count) {
+  std::size_t alignment = alignof(T);
+  if(alignment < alignof(void*)) {
+    alignment = alignof(void*);
+  }
+
+  auto block = static_cast<char*>(
+      ::operator new(count * sizeof(T) + alignment + sizeof(void*)));
+
+  auto start = reinterpret_cast<std::uintptr_t>(block + sizeof(void*));
+  start = (start + alignment - 1) & ~std::uintptr_t(alignment - 1);
+
+  auto result = reinterpret_cast<char*>(start);
+  reinterpret_cast<void**>(result)[-1] = block;
+  return reinterpret_cast<T*>(result);
+}
+
+template <typename T>
+void AlignedAllocator<T>::deallocate(T* ptr, std::size_t) {
+  ::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+}
+}
+
+#endif
\ No newline at end of file
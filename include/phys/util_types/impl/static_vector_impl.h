@@ -15,7 +15,7 @@ typename StaticVector<T, CAP>::const_iterator StaticVector<T, CAP>::begin()
 template <typename T, std::size_t CAP>
 typename StaticVector<T, CAP>::const_iterator StaticVector<T, CAP>::end()
     const {
-  return values_.end();
+  return values_.begin() + count_;
 }
 
 template <typename T, std::size_t CAP>
@@ -50,6 +50,12 @@ void StaticVector<T, CAP>::pop_back() {
   --count_;
 }
 
+template <typename T, std::size_t CAP>
+void StaticVector<T, CAP>::resize(std::size_t size) {
+  assert(size <= CAP);
+  count_ = size;
+}
+
 template <typename T, std::size_t CAP>
 T& StaticVector<T, CAP>::operator[](std::size_t i) {
   return values_[i];
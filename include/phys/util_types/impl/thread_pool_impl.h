@@ -0,0 +1,95 @@
+#ifndef PHYS_MISC_THREAD_POOL_IMPL_H
+#define PHYS_MISC_THREAD_POOL_IMPL_H
+
+namespace phys {
+
+inline ThreadPool::ThreadPool(unsigned int worker_count) {
+  workers_.reserve(worker_count);
+  for(unsigned int i = 0; i < worker_count; ++i) {
+    // Thread index 0 is reserved for the calling thread.
+    workers_.emplace_back([this, i]() { workerMain_(i + 1); });
+  }
+}
+
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_cv_.notify_all();
+
+  for(auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+inline std::size_t ThreadPool::threadCount() const {
+  return workers_.size() + 1;
+}
+
+template <typename FN_T>
+void ThreadPool::parallelFor(std::size_t task_count, FN_T const& fn) {
+  if(workers_.empty() || task_count <= 1) {
+    for(std::size_t i = 0; i < task_count; ++i) {
+      fn(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = [](void const* ctx, std::size_t task, std::size_t thread) {
+      (*static_cast<FN_T const*>(ctx))(task, thread);
+    };
+    job_ctx_ = &fn;
+    task_count_ = task_count;
+    next_task_ = 0;
+    busy_workers_ = workers_.size();
+    ++generation_;
+  }
+  wake_cv_.notify_all();
+
+  runTasks_(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this]() { return busy_workers_ == 0; });
+}
+
+inline void ThreadPool::workerMain_(std::size_t thread_index) {
+  std::uint64_t seen_generation = 0;
+  for(;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_cv_.wait(lock, [&]() {
+        return stopping_ || generation_ != seen_generation;
+      });
+
+      if(stopping_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+
+    runTasks_(thread_index);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(--busy_workers_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+}
+
+inline void ThreadPool::runTasks_(std::size_t thread_index) {
+  for(;;) {
+    auto task = next_task_.fetch_add(1);
+    if(task >= task_count_) {
+      break;
+    }
+    job_(job_ctx_, task, thread_index);
+  }
+}
+}
+
+#endif
\ No newline at end of file
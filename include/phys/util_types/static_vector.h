@@ -35,6 +35,7 @@ struct StaticVector {
   bool full() const;
   std::size_t size() const;
   void pop_back();
+  void resize(std::size_t size);
   T& operator[](std::size_t i);
 
  private:
@@ -0,0 +1,63 @@
+#ifndef PHYS_MISC_THREAD_POOL_H
+#define PHYS_MISC_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace phys {
+
+// A minimal fork-join worker pool. The thread calling parallelFor()
+// participates in the work, so a pool created with 0 workers simply runs
+// everything inline.
+//
+// Like the narrowphase factory, a pool can be shared between multiple worlds,
+// as long as they are not stepped concurrently.
+class ThreadPool {
+ public:
+  explicit ThreadPool(unsigned int worker_count);
+  ~ThreadPool();
+
+  ThreadPool(ThreadPool const&) = delete;
+  ThreadPool& operator=(ThreadPool const&) = delete;
+
+  // Number of threads that can run tasks, including the calling thread.
+  std::size_t threadCount() const;
+
+  // Invokes fn(task_index, thread_index) for every task_index in
+  // [0, task_count), and returns once all of them are done.
+  // thread_index is in [0, threadCount()), and is stable for the duration of
+  // a task, which makes it suitable to index per-thread scratch data.
+  template <typename FN_T>
+  void parallelFor(std::size_t task_count, FN_T const& fn);
+
+ private:
+  using job_fn_t = void (*)(void const*, std::size_t, std::size_t);
+
+  void workerMain_(std::size_t thread_index);
+  void runTasks_(std::size_t thread_index);
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_cv_;
+  std::condition_variable done_cv_;
+
+  std::uint64_t generation_ = 0;
+  std::size_t busy_workers_ = 0;
+  bool stopping_ = false;
+
+  // Current job.
+  job_fn_t job_ = nullptr;
+  void const* job_ctx_ = nullptr;
+  std::size_t task_count_ = 0;
+  std::atomic<std::size_t> next_task_{0};
+};
+}
+
+#include "phys/util_types/impl/thread_pool_impl.h"
+
+#endif
\ No newline at end of file
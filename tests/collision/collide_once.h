@@ -0,0 +1,72 @@
+#ifndef PHYS_TESTS_COLLISION_COLLIDE_ONCE_H
+#define PHYS_TESTS_COLLISION_COLLIDE_ONCE_H
+
+#include <utility>
+#include "gtest/gtest.h"
+#include "phys/phys.h"
+
+// Runs the narrowphase once on a fresh collision between two shapes, with
+// room for as many points as the collision world would give it.
+//
+// The points are reported from the first shape's point of view, whichever
+// order the algorithm takes them in: ws_position[0] is on shape_a, and the
+// normals point from shape_b towards it. The objects do not outlive this
+// function, so the returned collision does not refer to them.
+inline phys::Collision<phys::DefaultConfig> collideOnce(
+    phys::Shape<phys::DefaultConfig>* shape_a,
+    phys::Transform<phys::DefaultConfig> const& transform_a,
+    phys::Shape<phys::DefaultConfig>* shape_b,
+    phys::Transform<phys::DefaultConfig> const& transform_b) {
+  using CFG = phys::DefaultConfig;
+
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  phys::col::Object<CFG> obj_a;
+  obj_a.shape = shape_a;
+  obj_a.transform = transform_a;
+  phys::col::Object<CFG> obj_b;
+  obj_b.shape = shape_b;
+  obj_b.transform = transform_b;
+
+  // Algorithms take their shapes ordered by type.
+  phys::Collision<CFG> collision;
+  collision.objects = {&obj_a, &obj_b};
+  bool swapped = shape_a->getShapeType() > shape_b->getShapeType();
+  if(swapped) {
+    std::swap(collision.objects[0], collision.objects[1]);
+  }
+
+  auto narrowphase = factory.getNarrowphase(shape_a, shape_b);
+  collision.points.setCapacity(narrowphase->contactCapacity());
+  narrowphase->process(&collision);
+
+  if(swapped) {
+    for(auto& point : collision.points) {
+      point.ws_normal = -point.ws_normal;
+      std::swap(point.ws_position[0], point.ws_position[1]);
+      std::swap(point.os_position[0], point.os_position[1]);
+    }
+  }
+
+  collision.objects = {nullptr, nullptr};
+  return collision;
+}
+
+inline phys::Transform<phys::DefaultConfig> at(
+    phys::DefaultConfig::vec3_t const& position) {
+  phys::Transform<phys::DefaultConfig> result;
+  result.setTranslation(position);
+  return result;
+}
+
+inline void expectVecNear(phys::DefaultConfig::vec3_t const& expected,
+                          phys::DefaultConfig::vec3_t const& actual,
+                          phys::DefaultConfig::real_t tolerance = 1e-5f) {
+  EXPECT_NEAR(expected.x, actual.x, tolerance);
+  EXPECT_NEAR(expected.y, actual.y, tolerance);
+  EXPECT_NEAR(expected.z, actual.z, tolerance);
+}
+
+#endif
\ No newline at end of file
@@ -112,4 +112,49 @@ TEST(AxisSweepBroadphase, 2CollisionsOverlap) {
   bp.addHandle(&handle_3, aabb[2], on_added, on_removed);
 
   EXPECT_EQ(2, count);
-}
\ No newline at end of file
+}
+
+TEST(AxisSweepBroadphase, MinEdgeMovesPastSeveralEdges) {
+  using CFG = phys::DefaultConfig;
+
+  phys::col::AxisSweepBroadphase<CFG> bp(10);
+  phys::Aabb<CFG> aabb[2];
+
+  int count = 0;
+  auto on_added = [&count](auto, auto) { ++count; };
+  auto on_removed = [&count](auto, auto) { --count; };
+
+  aabb[0].min_bound = {0.0f, 0.0f, 0.0f};
+  aabb[0].max_bound = {1.0f, 1.0f, 1.0f};
+
+  aabb[1].min_bound = {1.5f, 1.5f, 1.5f};
+  aabb[1].max_bound = {2.0f, 2.0f, 2.0f};
+
+  handle_t handle_1;
+  handle_t handle_2;
+
+  bp.addHandle(&handle_1, aabb[0], on_added, on_removed);
+  bp.addHandle(&handle_2, aabb[1], on_added, on_removed);
+
+  // The first box jumps over the second one, so its min edge has to move up
+  // past both of the second box's edges.
+  aabb[0].min_bound = {2.5f, 2.5f, 2.5f};
+  aabb[0].max_bound = {3.0f, 3.0f, 3.0f};
+  bp.updateHandle(&handle_1, aabb[0], on_added, on_removed);
+
+  for(int i = 0; i < 3; ++i) {
+    auto const& edges = bp.edges_[i];
+    for(std::size_t j = 1; j < edges.size(); ++j) {
+      EXPECT_LE(edges[j - 1].position, edges[j].position);
+    }
+
+    for(auto handle : {&handle_1, &handle_2}) {
+      ASSERT_LT(handle->min_edges_[i], edges.size());
+      ASSERT_LT(handle->max_edges_[i], edges.size());
+      EXPECT_EQ(handle, edges[handle->min_edges_[i]].handle);
+      EXPECT_EQ(handle, edges[handle->max_edges_[i]].handle);
+    }
+  }
+
+  EXPECT_EQ(0, count);
+}
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include "phys/phys.h"
+#include "collide_once.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+namespace {
+// Lays capsules down, their segment along X.
+phys::Transform<CFG> lyingAt(vec3_t const& position) {
+  auto result = at(position);
+  result.setRotation(CFG::quat_t(0.7071068f, 0.0f, 0.0f, 0.7071068f));
+  return result;
+}
+
+// Same, along Z.
+phys::Transform<CFG> acrossAt(vec3_t const& position) {
+  auto result = at(position);
+  result.setRotation(CFG::quat_t(0.7071068f, 0.7071068f, 0.0f, 0.0f));
+  return result;
+}
+
+// Expects every point to be distance away from the ground, along Y.
+void expectOnGround(phys::Collision<CFG> const& collision, real_t distance) {
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(distance, point.distance, 1e-5f);
+    expectVecNear({0.0f, 1.0f, 0.0f}, point.ws_normal);
+    EXPECT_NEAR(0.0f, point.ws_position[1].y, 1e-5f);
+  }
+}
+}
+
+TEST(CapsuleContacts, LyingOnPlaneTouchesWithBothEnds) {
+  phys::shapes::Capsule<CFG> capsule(0.25f, 1.0f);
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+  auto collision = collideOnce(&capsule, lyingAt({0.5f, 0.24f, 0.0f}), &floor,
+                               phys::Transform<CFG>());
+
+  ASSERT_EQ(2u, collision.points.size());
+  expectOnGround(collision, -0.01f);
+  real_t ends = collision.points[0].ws_position[1].x +
+                collision.points[1].ws_position[1].x;
+  EXPECT_NEAR(1.0f, ends, 1e-5f);
+  EXPECT_NEAR(2.0f, std::abs(collision.points[0].ws_position[1].x -
+                             collision.points[1].ws_position[1].x),
+              1e-5f);
+}
+
+TEST(CapsuleContacts, StandingOnPlaneTouchesWithItsLowerEnd) {
+  phys::shapes::Capsule<CFG> capsule(0.25f, 1.0f);
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+  auto collision = collideOnce(&capsule, at({0.0f, 1.2f, 0.0f}), &floor,
+                               phys::Transform<CFG>());
+
+  ASSERT_EQ(1u, collision.points.size());
+  expectOnGround(collision, -0.05f);
+
+  auto above = collideOnce(&capsule, at({0.0f, 1.5f, 0.0f}), &floor,
+                           phys::Transform<CFG>());
+  EXPECT_EQ(0u, above.points.size());
+  EXPECT_NEAR(0.25f, above.separation_, 1e-5f);
+}
+
+TEST(CapsuleContacts, SphereAgainstCapsuleSide) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::shapes::Capsule<CFG> capsule(0.5f, 1.0f);
+  auto collision =
+      collideOnce(&sphere, at({0.9f, 0.2f, 0.0f}), &capsule, at({0, 0, 0}));
+
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_EQ(1u, collision.points.capacity());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.1f, point.distance, 1e-5f);
+  expectVecNear({1.0f, 0.0f, 0.0f}, point.ws_normal);
+  expectVecNear({0.4f, 0.2f, 0.0f}, point.ws_position[0]);
+  expectVecNear({0.5f, 0.2f, 0.0f}, point.ws_position[1]);
+}
+
+TEST(CapsuleContacts, SphereBeyondCapsuleEnd) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::shapes::Capsule<CFG> capsule(0.5f, 1.0f);
+
+  // Against the cap, along the axis.
+  auto collision =
+      collideOnce(&sphere, at({0.0f, 1.99f, 0.0f}), &capsule, at({0, 0, 0}));
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(-0.01f, collision.points[0].distance, 1e-5f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, collision.points[0].ws_normal);
+
+  auto far =
+      collideOnce(&sphere, at({0.0f, 2.5f, 0.0f}), &capsule, at({0, 0, 0}));
+  EXPECT_EQ(0u, far.points.size());
+  EXPECT_NEAR(0.5f, far.separation_, 1e-5f);
+}
+
+TEST(CapsuleContacts, ParallelCapsulesTouchAlongALine) {
+  phys::shapes::Capsule<CFG> top(0.25f, 1.0f);
+  phys::shapes::Capsule<CFG> bottom(0.25f, 1.0f);
+  auto collision = collideOnce(&top, lyingAt({0.5f, 0.49f, 0.0f}), &bottom,
+                               lyingAt({0, 0, 0}));
+
+  // Both ends of the overlap, from 0.5 - 1 to 1.
+  ASSERT_EQ(2u, collision.points.size());
+  real_t lowest = 10.0f;
+  real_t highest = -10.0f;
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(-0.01f, point.distance, 1e-5f);
+    expectVecNear({0.0f, 1.0f, 0.0f}, point.ws_normal);
+    EXPECT_NEAR(0.25f, point.ws_position[1].y, 1e-5f);
+    lowest = std::min(lowest, point.ws_position[1].x);
+    highest = std::max(highest, point.ws_position[1].x);
+  }
+  EXPECT_NEAR(-0.5f, lowest, 1e-5f);
+  EXPECT_NEAR(1.0f, highest, 1e-5f);
+}
+
+TEST(CapsuleContacts, CrossedCapsulesTouchAtOnePoint) {
+  phys::shapes::Capsule<CFG> top(0.25f, 1.0f);
+  phys::shapes::Capsule<CFG> bottom(0.25f, 1.0f);
+  auto collision = collideOnce(&top, acrossAt({0.3f, 0.45f, 0.2f}), &bottom,
+                               lyingAt({0, 0, 0}));
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.05f, point.distance, 1e-5f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, point.ws_normal);
+  expectVecNear({0.3f, 0.25f, 0.0f}, point.ws_position[1]);
+
+  auto apart = collideOnce(&top, acrossAt({0.3f, 0.8f, 0.2f}), &bottom,
+                           lyingAt({0, 0, 0}));
+  EXPECT_EQ(0u, apart.points.size());
+  EXPECT_NEAR(0.3f, apart.separation_, 1e-5f);
+}
+
+TEST(CapsuleContacts, LyingOnBoxTouchesWithBothEnds) {
+  phys::shapes::Capsule<CFG> capsule(0.25f, 1.0f);
+  phys::shapes::Box<CFG> ground({2.0f, 0.5f, 2.0f});
+  auto collision = collideOnce(&capsule, lyingAt({0.5f, 0.24f, 0.3f}),
+                               &ground, at({0.0f, -0.5f, 0.0f}));
+
+  ASSERT_EQ(2u, collision.points.size());
+  expectOnGround(collision, -0.01f);
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(1.0f, std::abs(point.ws_position[1].x - 0.5f), 1e-5f);
+    EXPECT_NEAR(0.3f, point.ws_position[1].z, 1e-5f);
+  }
+
+  auto above = collideOnce(&capsule, lyingAt({0.5f, 0.35f, 0.3f}), &ground,
+                           at({0.0f, -0.5f, 0.0f}));
+  EXPECT_EQ(0u, above.points.size());
+  EXPECT_NEAR(0.1f, above.separation_, 1e-5f);
+}
+
+TEST(CapsuleContacts, SegmentInsideBoxPushedOutThroughNearestFace) {
+  phys::shapes::Capsule<CFG> capsule(0.25f, 1.0f);
+  phys::shapes::Box<CFG> ground({2.0f, 0.5f, 2.0f});
+  auto collision = collideOnce(&capsule, lyingAt({0.0f, -0.1f, 0.0f}),
+                               &ground, at({0.0f, -0.5f, 0.0f}));
+
+  // The segment is 0.1 under the top face, plus the radius.
+  ASSERT_EQ(2u, collision.points.size());
+  expectOnGround(collision, -0.35f);
+}
\ No newline at end of file
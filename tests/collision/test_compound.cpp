@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "phys/phys.h"
+#include "collide_once.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using Compound = phys::shapes::Compound<CFG>;
+using Sphere = phys::shapes::Sphere<CFG>;
+
+TEST(Compound, MidphaseFindsOverlappingChildren) {
+  Sphere sphere(0.5f);
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<real_t> pos(-5.0f, 5.0f);
+
+  std::vector<Compound::Child> children;
+  for(int i = 0; i < 40; ++i) {
+    children.push_back({&sphere, at({pos(rng), pos(rng), pos(rng)})});
+  }
+  Compound compound(children.data(), uint32_t(children.size()));
+  EXPECT_EQ(children.size(), compound.getChildCount());
+
+  std::uniform_real_distribution<real_t> size(0.0f, 3.0f);
+  for(int q = 0; q < 100; ++q) {
+    phys::Aabb<CFG> query;
+    query.min_bound = {pos(rng), pos(rng), pos(rng)};
+    query.max_bound = query.min_bound + vec3_t{size(rng), size(rng), size(rng)};
+
+    std::set<uint32_t> expected;
+    for(uint32_t i = 0; i < children.size(); ++i) {
+      vec3_t center = children[i].transform.getTranslation();
+      bool overlap = true;
+      for(int axis = 0; axis < 3; ++axis) {
+        overlap = overlap && center[axis] + 0.5f >= query.min_bound[axis] &&
+                  center[axis] - 0.5f <= query.max_bound[axis];
+      }
+      if(overlap) {
+        expected.insert(i);
+      }
+    }
+
+    std::set<uint32_t> found;
+    compound.visitChildren(query, [&](uint32_t child) {
+      EXPECT_TRUE(found.insert(child).second);
+    });
+    EXPECT_EQ(expected, found);
+  }
+}
+
+TEST(Compound, InertiaUsesParallelAxis) {
+  Sphere sphere(0.5f);
+
+  Compound::Child single = {&sphere, phys::Transform<CFG>()};
+  Compound centered(&single, 1);
+
+  vec3_t expected;
+  vec3_t inertia;
+  sphere.getInertia(2.0f, expected);
+  centered.getInertia(2.0f, inertia);
+  EXPECT_FLOAT_EQ(expected.x, inertia.x);
+  EXPECT_FLOAT_EQ(expected.y, inertia.y);
+
+  // Two equal spheres, one unit away from the origin along X.
+  Compound::Child pair[] = {{&sphere, at({-1.0f, 0.0f, 0.0f})},
+                            {&sphere, at({1.0f, 0.0f, 0.0f})}};
+  Compound dumbbell(pair, 2);
+  dumbbell.getInertia(2.0f, inertia);
+  EXPECT_FLOAT_EQ(expected.x, inertia.x);
+  EXPECT_FLOAT_EQ(expected.y + 2.0f, inertia.y);
+  EXPECT_FLOAT_EQ(expected.z + 2.0f, inertia.z);
+
+  EXPECT_FLOAT_EQ(1.5f, dumbbell.getBoundingRadius());
+}
+
+TEST(Compound, MergesChildContacts) {
+  Sphere sphere(0.5f);
+  Compound::Child pair[] = {{&sphere, at({-1.0f, 0.0f, 0.0f})},
+                            {&sphere, at({1.0f, 0.0f, 0.0f})}};
+  Compound dumbbell(pair, 2);
+
+  // A dumbbell lying across another one.
+  auto collision = collideOnce(&dumbbell, at({0.0f, 0.0f, 0.0f}), &dumbbell,
+                               at({0.0f, 0.99f, 0.0f}));
+
+  // Only the spheres stacked on top of each other touch.
+  ASSERT_EQ(2u, collision.points.size());
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(-0.01f, point.distance, 1e-4f);
+    EXPECT_NEAR(-1.0f, point.ws_normal.y, 1e-4f);
+  }
+
+  // Moving them apart reports a separation instead.
+  auto apart = collideOnce(&dumbbell, at({0.0f, 0.0f, 0.0f}), &dumbbell,
+                           at({0.0f, 2.0f, 0.0f}));
+  EXPECT_EQ(0u, apart.points.size());
+  EXPECT_GT(apart.separation_, apart.getRestingMargin());
+}
+
+TEST(Compound, BoundsQueriesOfPlanes) {
+  Sphere sphere(0.5f);
+  Compound::Child pair[] = {{&sphere, at({0.0f, 0.0f, 0.0f})},
+                            {&sphere, at({0.0f, 4.0f, 0.0f})}};
+  Compound column(pair, 2);
+
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+
+  // The plane's infinite radius does not leak into the reported separation.
+  auto above = collideOnce(&floor, phys::Transform<CFG>(), &column,
+                           at({0.0f, 3.0f, 0.0f}));
+  EXPECT_EQ(0u, above.points.size());
+  EXPECT_GT(above.separation_, above.getRestingMargin());
+  EXPECT_LT(above.separation_, 2.5f);
+
+  auto collision = collideOnce(&floor, phys::Transform<CFG>(), &column,
+                               at({0.0f, 0.49f, 0.0f}));
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(-0.01f, collision.points[0].distance, 1e-4f);
+}
+
+TEST(Compound, SkipsChildPairsWithoutAlgorithm) {
+  // Heightfields cannot collide with each other, spheres can.
+  std::vector<uint16_t> samples(9 * 9, 0);
+  phys::shapes::Heightfield<CFG> field(9, 9, samples.data(), 1.0f, 1.0f,
+                                       0.0f);
+  Sphere sphere(0.5f);
+  Compound::Child children[] = {{&field, at({0.0f, 0.3f, 0.0f})},
+                                {&sphere, at({4.0f, 0.49f, 4.0f})}};
+  Compound compound(children, 2);
+
+  auto collision = collideOnce(&field, phys::Transform<CFG>(), &compound,
+                               phys::Transform<CFG>());
+
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(-0.01f, collision.points[0].distance, 1e-4f);
+  EXPECT_NEAR(-1.0f, collision.points[0].ws_normal.y, 1e-4f);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using ContactManifold = phys::ContactManifold<CFG>;
+
+namespace {
+void fill(ContactManifold* manifold, std::size_t count) {
+  for(std::size_t i = 0; i < count; ++i) {
+    manifold->emplace_back().distance = float(i);
+  }
+}
+}
+
+TEST(ContactManifold, GrowsUpToCapacity) {
+  ContactManifold manifold;
+  EXPECT_EQ(std::size_t(CFG::max_contact_points_per_collision),
+            manifold.capacity());
+
+  fill(&manifold, CFG::max_contact_points_per_collision);
+  EXPECT_TRUE(manifold.full());
+
+  float expected = 0.0f;
+  for(auto const& contact : manifold) {
+    EXPECT_EQ(expected, contact.distance);
+    expected += 1.0f;
+  }
+}
+
+TEST(ContactManifold, ChangesCapacity) {
+  ContactManifold manifold;
+  manifold.setCapacity(1);
+  fill(&manifold, 1);
+  EXPECT_TRUE(manifold.full());
+
+  manifold.setCapacity(3);
+  fill(&manifold, 2);
+  EXPECT_TRUE(manifold.full());
+
+  manifold.resize(1);
+  manifold.setCapacity(1);
+  ASSERT_EQ(1u, manifold.size());
+  EXPECT_EQ(0.0f, manifold[0].distance);
+}
+
+TEST(ContactManifold, CopiesAndMoves) {
+  ContactManifold manifold;
+  fill(&manifold, 3);
+
+  ContactManifold copy = manifold;
+  manifold[0].distance = 10.0f;
+  ASSERT_EQ(3u, copy.size());
+  EXPECT_EQ(0.0f, copy[0].distance);
+  EXPECT_EQ(2.0f, copy[2].distance);
+
+  ContactManifold moved = std::move(copy);
+  ASSERT_EQ(3u, moved.size());
+  EXPECT_EQ(2.0f, moved[2].distance);
+
+  // Assigning a manifold to itself keeps its points.
+  ContactManifold& self = moved;
+  moved = self;
+  ASSERT_EQ(3u, moved.size());
+  EXPECT_EQ(2.0f, moved[2].distance);
+
+  moved = std::move(self);
+  ASSERT_EQ(3u, moved.size());
+  EXPECT_EQ(2.0f, moved[2].distance);
+}
+
+TEST(ContactManifold, RecyclesPooledBlocks) {
+  phys::ContactPool<CFG> pool;
+
+  phys::Contact<CFG> const* first_block = nullptr;
+  {
+    ContactManifold manifold;
+    manifold.setCapacity(2, &pool);
+    fill(&manifold, 2);
+    first_block = manifold.begin();
+
+    // Moving to another capacity keeps the points.
+    manifold.resize(1);
+    manifold.setCapacity(1, &pool);
+    ASSERT_EQ(1u, manifold.size());
+    EXPECT_EQ(0.0f, manifold[0].distance);
+  }
+
+  // Blocks of a given capacity are reused once released.
+  ContactManifold manifold;
+  manifold.setCapacity(2, &pool);
+  EXPECT_EQ(first_block, manifold.begin());
+
+  ContactManifold other;
+  other.setCapacity(2, &pool);
+  EXPECT_NE(manifold.begin(), other.begin());
+}
+
+TEST(ContactManifold, AlgorithmsDeclareCapacity) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  phys::shapes::Sphere<CFG> sphere(1.0f);
+  phys::shapes::Box<CFG> box({1.0f, 1.0f, 1.0f});
+  EXPECT_EQ(1u, factory.getNarrowphase(&sphere, &sphere)->contactCapacity());
+  EXPECT_EQ(std::size_t(CFG::max_contact_points_per_collision),
+            factory.getNarrowphase(&box, &box)->contactCapacity());
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using Collision = phys::Collision<CFG>;
+
+TEST(ContactRefresh, SkipsObjectsThatDidNotMove) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  collision.refresh();
+  EXPECT_FALSE(collision.needsRefresh());
+
+  // Updating the motion of an object that stayed put keeps its contacts.
+  a.updateMotion();
+  EXPECT_FALSE(collision.needsRefresh());
+
+  b.transform.setTranslation({0.0f, 1.0f, 0.0f});
+  b.updateMotion();
+  EXPECT_TRUE(collision.needsRefresh());
+
+  collision.refresh();
+  EXPECT_FALSE(collision.needsRefresh());
+}
+
+TEST(ContactRefresh, DropsDriftedPointsInOrder) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  for(real_t x : {2.0f, 0.0f, 1.0f}) {
+    phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                          vec3_t{x, 0.0f, 0.0f}, -0.01f);
+  }
+
+  // Tilting a lifts its points further away the further they are from its
+  // origin. Only the one at x = 2 gets out of contact distance.
+  a.transform.setRotation(
+      CFG::quat_t(std::cos(0.01f), 0.0f, 0.0f, std::sin(0.01f)));
+  a.updateMotion();
+  ASSERT_TRUE(collision.needsRefresh());
+  collision.refresh();
+  EXPECT_FALSE(collision.needsRefresh());
+
+  ASSERT_EQ(2u, collision.points.size());
+  EXPECT_NEAR(0.0f, collision.points[0].ws_position[1].x, 1e-5f);
+  EXPECT_NEAR(1.0f, collision.points[1].ws_position[1].x, 1e-5f);
+  EXPECT_NEAR(-0.01f, collision.points[0].distance, 1e-4f);
+  EXPECT_GT(collision.points[1].distance, -0.01f);
+}
+
+TEST(ContactRefresh, ReusesManifoldWithinTolerance) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  a.transform.setTranslation({0.0f, 0.99f, 0.0f});
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  EXPECT_FALSE(collision.canReuseManifold(0.005f, 0.01f));
+
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{0.0f, 0.5f, 0.0f}, -0.01f);
+  collision.recordManifoldPose(true);
+  EXPECT_TRUE(collision.canReuseManifold(0.005f, 0.01f));
+
+  // Moving both objects together does not change their relative pose.
+  a.transform.setTranslation({5.0f, 0.99f, 0.0f});
+  b.transform.setTranslation({5.0f, 0.0f, 0.0f});
+  EXPECT_TRUE(collision.canReuseManifold(0.005f, 0.01f));
+
+  a.transform.setTranslation({5.003f, 0.99f, 0.0f});
+  EXPECT_TRUE(collision.canReuseManifold(0.005f, 0.01f));
+  a.transform.setTranslation({5.01f, 0.99f, 0.0f});
+  EXPECT_FALSE(collision.canReuseManifold(0.005f, 0.01f));
+
+  a.transform.setTranslation({5.0f, 0.99f, 0.0f});
+  a.transform.setRotation(
+      CFG::quat_t(std::cos(0.004f), 0.0f, 0.0f, std::sin(0.004f)));
+  EXPECT_TRUE(collision.canReuseManifold(0.005f, 0.01f));
+  a.transform.setRotation(
+      CFG::quat_t(std::cos(0.02f), 0.0f, 0.0f, std::sin(0.02f)));
+  EXPECT_FALSE(collision.canReuseManifold(0.005f, 0.01f));
+}
+
+TEST(ContactRefresh, DroppedPointsInvalidateManifold) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{0.0f, 0.0f, 0.0f}, -0.01f);
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{1.0f, 0.0f, 0.0f}, -0.01f);
+  collision.recordManifoldPose(true);
+
+  // Tilting a by 0.04 lifts the second point out of contact distance, even
+  // though the pose is well within the rotation tolerance.
+  a.transform.setRotation(
+      CFG::quat_t(std::cos(0.02f), 0.0f, 0.0f, std::sin(0.02f)));
+  a.updateMotion();
+  collision.refresh();
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_FALSE(collision.canReuseManifold(0.005f, 0.1f));
+}
+
+TEST(ContactRefresh, ReusesPartialManifoldsOnlyWhenOneShot) {
+  phys::shapes::Box<CFG> box({0.5f, 0.5f, 0.5f});
+  phys::col::Object<CFG> a;
+  a.shape = &box;
+  phys::col::Object<CFG> b;
+  b.shape = &box;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{0.0f, 0.0f, 0.0f}, -0.01f);
+
+  // Algorithms that add a point per call have more to find.
+  collision.recordManifoldPose(false);
+  EXPECT_FALSE(collision.canReuseManifold(0.005f, 0.01f));
+  collision.recordManifoldPose(true);
+  EXPECT_TRUE(collision.canReuseManifold(0.005f, 0.01f));
+
+  // Until there is no room left.
+  for(int i = 1; i < CFG::max_contact_points_per_collision; ++i) {
+    phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                          vec3_t{real_t(i), 0.0f, 0.0f}, -0.01f);
+  }
+  collision.recordManifoldPose(false);
+  EXPECT_TRUE(collision.canReuseManifold(0.005f, 0.01f));
+}
+
+TEST(ContactRefresh, MatchedPointsKeepTheirImpulse) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  collision.points.setCapacity(1);
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{0.0f, 0.0f, 0.0f}, -0.01f);
+  collision.points[0].applied_impulse = 2.0f;
+
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{0.001f, 0.0f, 0.0f}, -0.01f);
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_EQ(2.0f, collision.points[0].applied_impulse);
+
+  // A point far enough away takes over the slot, but not the impulse.
+  phys::col::addContact(collision, vec3_t{0.0f, 1.0f, 0.0f},
+                        vec3_t{1.0f, 0.0f, 0.0f}, -0.01f);
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_EQ(0.0f, collision.points[0].applied_impulse);
+}
\ No newline at end of file
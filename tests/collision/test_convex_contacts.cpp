@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include "phys/phys.h"
+#include "collide_once.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+// These pairs have no dedicated algorithm, and go through ConvexConvex.
+
+namespace {
+// EPA only approximates curved surfaces, and its normals are a bit off.
+const real_t epa_tolerance = 5e-3f;
+
+// Lays shapes down, their Y axis along X.
+phys::Transform<CFG> lyingAt(vec3_t const& position) {
+  auto result = at(position);
+  result.setRotation(CFG::quat_t(0.7071068f, 0.0f, 0.0f, 0.7071068f));
+  return result;
+}
+}
+
+TEST(ConvexContacts, CylinderRestingOnBox) {
+  phys::shapes::Cylinder<CFG> cylinder(0.5f, 0.5f);
+  phys::shapes::Box<CFG> ground({2.0f, 0.5f, 2.0f});
+  auto collision = collideOnce(&cylinder, at({0.3f, 0.49f, -0.2f}), &ground,
+                               at({0.0f, -0.5f, 0.0f}));
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.01f, point.distance, 1e-4f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, point.ws_normal, epa_tolerance);
+  EXPECT_NEAR(0.0f, point.ws_position[1].y, 1e-4f);
+  EXPECT_NEAR(-0.01f, point.ws_position[0].y, 1e-4f);
+
+  // Somewhere under the cylinder.
+  vec3_t offset = point.ws_position[1] - vec3_t{0.3f, 0.0f, -0.2f};
+  EXPECT_LE(length(offset), 0.5f + 1e-4f);
+}
+
+TEST(ConvexContacts, CylinderSunkDeepIntoBox) {
+  phys::shapes::Cylinder<CFG> cylinder(0.5f, 0.5f);
+  phys::shapes::Box<CFG> ground({2.0f, 0.5f, 2.0f});
+  auto collision = collideOnce(&cylinder, at({0.0f, 0.2f, 0.0f}), &ground,
+                               at({0.0f, -0.5f, 0.0f}));
+
+  // The way out is up, the sides of the box are further.
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(-0.3f, collision.points[0].distance, 1e-3f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, collision.points[0].ws_normal,
+                epa_tolerance);
+}
+
+TEST(ConvexContacts, CylinderAboveBoxReportsSeparation) {
+  phys::shapes::Cylinder<CFG> cylinder(0.5f, 0.5f);
+  phys::shapes::Box<CFG> ground({2.0f, 0.5f, 2.0f});
+  auto collision = collideOnce(&cylinder, at({0.0f, 0.6f, 0.0f}), &ground,
+                               at({0.0f, -0.5f, 0.0f}));
+
+  EXPECT_EQ(0u, collision.points.size());
+  EXPECT_NEAR(0.1f, collision.separation_, 1e-3f);
+}
+
+TEST(ConvexContacts, SphereAgainstCylinderSide) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::shapes::Cylinder<CFG> cylinder(0.5f, 1.0f);
+
+  auto collision =
+      collideOnce(&sphere, at({0.9f, 0.3f, 0.0f}), &cylinder, at({0, 0, 0}));
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.1f, point.distance, 1e-3f);
+  expectVecNear({1.0f, 0.0f, 0.0f}, point.ws_normal, epa_tolerance);
+  EXPECT_NEAR(0.4f, point.ws_position[0].x, 5e-3f);
+  EXPECT_NEAR(0.5f, point.ws_position[1].x, 5e-3f);
+
+  // The points are interpolated across a face of the shapes' difference,
+  // which only lands them near the deepest point.
+  EXPECT_NEAR(0.3f, point.ws_position[1].y, 0.05f);
+
+  // Close enough for a speculative contact, but not touching.
+  auto near =
+      collideOnce(&sphere, at({1.01f, 0.3f, 0.0f}), &cylinder, at({0, 0, 0}));
+  ASSERT_EQ(1u, near.points.size());
+  EXPECT_NEAR(0.01f, near.points[0].distance, 1e-4f);
+  expectVecNear({1.0f, 0.0f, 0.0f}, near.points[0].ws_normal, epa_tolerance);
+}
+
+TEST(ConvexContacts, CapsuleLyingAcrossCylinder) {
+  phys::shapes::Capsule<CFG> capsule(0.25f, 1.0f);
+  phys::shapes::Cylinder<CFG> cylinder(0.5f, 0.5f);
+
+  auto collision = collideOnce(&capsule, lyingAt({0.2f, 0.74f, 0.0f}),
+                               &cylinder, at({0, 0, 0}));
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(-0.01f, collision.points[0].distance, 1e-3f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, collision.points[0].ws_normal,
+                epa_tolerance);
+  EXPECT_NEAR(0.5f, collision.points[0].ws_position[1].y, 1e-3f);
+}
+
+TEST(ConvexContacts, CylindersStackedAndSideBySide) {
+  phys::shapes::Cylinder<CFG> top(0.5f, 0.5f);
+  phys::shapes::Cylinder<CFG> bottom(0.5f, 0.5f);
+
+  auto stacked =
+      collideOnce(&top, at({0.2f, 0.99f, 0.1f}), &bottom, at({0, 0, 0}));
+  ASSERT_EQ(1u, stacked.points.size());
+  EXPECT_NEAR(-0.01f, stacked.points[0].distance, 1e-3f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, stacked.points[0].ws_normal, epa_tolerance);
+
+  auto side =
+      collideOnce(&top, at({0.0f, 0.0f, -0.98f}), &bottom, at({0, 0, 0}));
+  ASSERT_EQ(1u, side.points.size());
+  EXPECT_NEAR(-0.02f, side.points[0].distance, 1e-3f);
+  expectVecNear({0.0f, 0.0f, -1.0f}, side.points[0].ws_normal, epa_tolerance);
+
+  auto apart =
+      collideOnce(&top, at({0.0f, 0.0f, -1.5f}), &bottom, at({0, 0, 0}));
+  EXPECT_EQ(0u, apart.points.size());
+  EXPECT_NEAR(0.5f, apart.separation_, 1e-3f);
+}
+
+TEST(ConvexContacts, EpaIterationLimitKeepsClosestFace) {
+  // Without a tolerance, EPA never settles on curved shapes, and stops at its
+  // iteration limit right after an expansion that replaced the closest face.
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  a.transform = at({0.8f, 0.1f, 0.0f});
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  phys::col::narrow::ConvexConvex<CFG> algorithm;
+  algorithm.epa_tolerance = 0.0f;
+  phys::Collision<CFG> collision;
+  collision.objects = {&a, &b};
+  collision.points.setCapacity(algorithm.contactCapacity());
+  algorithm.process(&collision);
+
+  ASSERT_EQ(1u, collision.points.size());
+  vec3_t offset = {0.8f, 0.1f, 0.0f};
+  EXPECT_NEAR(length(offset) - 1.0f, collision.points[0].distance, 1e-3f);
+  expectVecNear(normalize(offset), collision.points[0].ws_normal,
+                epa_tolerance);
+}
+
+TEST(ConvexContacts, BoxRestingOnBox) {
+  phys::shapes::Box<CFG> top({0.5f, 0.5f, 0.5f});
+  phys::shapes::Box<CFG> bottom({2.0f, 0.5f, 2.0f});
+
+  auto collision =
+      collideOnce(&top, at({0.3f, 0.99f, -0.2f}), &bottom, at({0, 0, 0}));
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.01f, point.distance, 1e-4f);
+  expectVecNear({0.0f, 1.0f, 0.0f}, point.ws_normal, 1e-4f);
+  EXPECT_NEAR(0.5f, point.ws_position[1].y, 1e-4f);
+
+  // Somewhere under the top box.
+  EXPECT_LE(std::abs(point.ws_position[1].x - 0.3f), 0.5f + 1e-4f);
+  EXPECT_LE(std::abs(point.ws_position[1].z + 0.2f), 0.5f + 1e-4f);
+
+  auto above =
+      collideOnce(&top, at({0.3f, 1.2f, -0.2f}), &bottom, at({0, 0, 0}));
+  EXPECT_EQ(0u, above.points.size());
+  EXPECT_NEAR(0.2f, above.separation_, 1e-3f);
+}
+
+TEST(ConvexContacts, BoxesSideBySide) {
+  phys::shapes::Box<CFG> box({0.5f, 0.5f, 0.5f});
+  auto collision =
+      collideOnce(&box, at({0.95f, 0.1f, 0.0f}), &box, at({0, 0, 0}));
+
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(-0.05f, collision.points[0].distance, 1e-4f);
+  expectVecNear({1.0f, 0.0f, 0.0f}, collision.points[0].ws_normal, 1e-4f);
+}
\ No newline at end of file
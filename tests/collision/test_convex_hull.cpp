@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+TEST(ConvexHull, DiscardsInteriorPoints) {
+  std::vector<vec3_t> points;
+  for(int x = -1; x <= 1; x += 2) {
+    for(int y = -1; y <= 1; y += 2) {
+      for(int z = -1; z <= 1; z += 2) {
+        points.push_back({real_t(x), real_t(y), real_t(z)});
+      }
+    }
+  }
+  points.push_back({0.0f, 0.0f, 0.0f});
+  points.push_back({0.5f, 1.0f, 0.5f});  // on a face
+
+  phys::shapes::ConvexHull<CFG> hull(points.data(), points.size());
+  EXPECT_EQ(8, hull.getVertexCount());
+
+  // Every vertex of a cube has exactly 3 neighbors along the cube's edges,
+  // plus whatever the faces' triangulation adds.
+  for(uint32_t i = 0; i < hull.getVertexCount(); ++i) {
+    auto count = hull.neighborsEnd(i) - hull.neighborsBegin(i);
+    EXPECT_GE(count, 3);
+    EXPECT_LE(count, 6);
+  }
+
+  vec3_t support = hull.getSupportingVertex({1.0f, 2.0f, -3.0f});
+  EXPECT_EQ(vec3_t(1.0f, 1.0f, -1.0f), support);
+}
+
+TEST(ConvexHull, ClimbingMatchesBruteForce) {
+  std::mt19937 rng(1234);
+  std::normal_distribution<real_t> dist;
+
+  std::vector<vec3_t> points;
+  for(int i = 0; i < 500; ++i) {
+    vec3_t p = {dist(rng), dist(rng), dist(rng)};
+    points.push_back(normalize(p));
+  }
+
+  phys::shapes::ConvexHull<CFG> hull(points.data(), points.size());
+  ASSERT_GT(hull.getVertexCount(),
+            phys::shapes::ConvexHull<CFG>::linear_scan_max_vertices);
+
+  uint32_t hint = 0;
+  for(int q = 0; q < 1000; ++q) {
+    vec3_t dir = {dist(rng), dist(rng), dist(rng)};
+
+    real_t best = std::numeric_limits<real_t>::lowest();
+    for(auto const& p : points) {
+      best = std::max(best, dot(p, dir));
+    }
+
+    EXPECT_NEAR(best, dot(hull.getSupportingVertexWithHint(dir, &hint), dir),
+                1e-5f);
+    EXPECT_NEAR(best, dot(hull.getSupportingVertex(dir), dir), 1e-5f);
+  }
+}
+
+TEST(ConvexHull, FaceNeighborsShareEdges) {
+  std::mt19937 rng(4321);
+  std::normal_distribution<real_t> dist;
+
+  std::vector<vec3_t> points;
+  for(int i = 0; i < 200; ++i) {
+    points.push_back({dist(rng), dist(rng), dist(rng)});
+  }
+
+  phys::shapes::ConvexHull<CFG> hull(points.data(), points.size());
+  ASSERT_GT(hull.getFaceCount(), 0u);
+
+  for(uint32_t i = 0; i < hull.getFaceCount(); ++i) {
+    auto const& face = hull.getFace(i);
+    for(int e = 0; e < 3; ++e) {
+      // The neighbor walks the shared edge the other way around.
+      auto const& neighbor = hull.getFace(face.neighbors[e]);
+      bool found = false;
+      for(int n = 0; n < 3; ++n) {
+        found |= neighbor.vertices[n] == face.vertices[(e + 1) % 3] &&
+                 neighbor.vertices[(n + 1) % 3] == face.vertices[e];
+      }
+      EXPECT_TRUE(found);
+    }
+  }
+
+  for(uint32_t i = 0; i < hull.getVertexCount(); ++i) {
+    auto const& face = hull.getFace(hull.getVertexFace(i));
+    EXPECT_TRUE(face.vertices[0] == i || face.vertices[1] == i ||
+                face.vertices[2] == i);
+  }
+}
+
+TEST(ConvexHull, FlatPointCloud) {
+  vec3_t points[] = {
+      {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+      {1.0f, 0.0f, 1.0f}, {0.5f, 0.0f, 0.5f},
+  };
+
+  phys::shapes::ConvexHull<CFG> hull(points, 5);
+  vec3_t support = hull.getSupportingVertex({1.0f, 0.0f, 1.0f});
+  EXPECT_EQ(vec3_t(1.0f, 0.0f, 1.0f), support);
+}
\ No newline at end of file
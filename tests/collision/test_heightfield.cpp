@@ -0,0 +1,246 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include "phys/phys.h"
+#include "collide_once.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using Heightfield = phys::shapes::Heightfield<CFG>;
+
+namespace {
+// Spans a few tiles, without being a multiple of their size.
+const uint32_t columns = 70;
+const uint32_t rows = 41;
+const real_t cell_size = 0.5f;
+const real_t height_scale = 0.01f;
+const real_t height_offset = -2.0f;
+
+std::vector<uint16_t> makeSamples() {
+  std::vector<uint16_t> samples(columns * rows);
+  for(uint32_t z = 0; z < rows; ++z) {
+    for(uint32_t x = 0; x < columns; ++x) {
+      samples[z * columns + x] = uint16_t((x * 37 + z * 91) % 400);
+    }
+  }
+  return samples;
+}
+
+std::set<uint32_t> collectTriangles(Heightfield const& field,
+                                    phys::Aabb<CFG> const& query) {
+  std::set<uint32_t> result;
+  field.visitTriangles(query, [&](uint32_t index, vec3_t const* tri) {
+    EXPECT_TRUE(result.insert(index).second);
+
+    // Both triangles of a cell face up.
+    vec3_t normal = cross(tri[1] - tri[0], tri[2] - tri[0]);
+    EXPECT_GT(normal.y, 0.0f);
+  });
+  return result;
+}
+
+// 8 x 8 cells of size 1, flat at y = 0 except for a valley along X = 4,
+// whose sides rise by 0.5 per cell.
+std::vector<uint16_t> makeValleySamples() {
+  std::vector<uint16_t> samples(9 * 9);
+  for(uint32_t z = 0; z < 9; ++z) {
+    for(uint32_t x = 0; x < 9; ++x) {
+      samples[z * 9 + x] = uint16_t(x < 4 ? 4 - x : x - 4);
+    }
+  }
+  return samples;
+}
+
+std::vector<uint16_t> makeFlatSamples() {
+  return std::vector<uint16_t>(9 * 9, 0);
+}
+
+// Expects every point to be distance away from flat ground at y = 0.
+void expectOnFlatGround(phys::Collision<CFG> const& collision,
+                        real_t distance) {
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(distance, point.distance, 1e-5f);
+    EXPECT_NEAR(1.0f, point.ws_normal.y, 1e-5f);
+    EXPECT_NEAR(0.0f, point.ws_position[1].y, 1e-5f);
+  }
+}
+}
+
+TEST(Heightfield, StoresQuantizedHeights) {
+  auto samples = makeSamples();
+  Heightfield field(columns, rows, samples.data(), cell_size, height_scale,
+                    height_offset);
+
+  EXPECT_FLOAT_EQ(height_offset + samples[5 * columns + 3] * height_scale,
+                  field.getHeight(3, 5));
+
+  phys::Aabb<CFG> bounds;
+  field.getAabb(&bounds, phys::Transform<CFG>());
+  EXPECT_LE(bounds.min_bound.x, 0.0f);
+  EXPECT_GE(bounds.max_bound.x, (columns - 1) * cell_size);
+  EXPECT_LE(bounds.min_bound.y, height_offset);
+  EXPECT_GE(bounds.max_bound.y, height_offset + 399 * height_scale);
+}
+
+TEST(Heightfield, VisitsCellsUnderFootprint) {
+  auto samples = makeSamples();
+  Heightfield field(columns, rows, samples.data(), cell_size, height_scale,
+                    height_offset);
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<real_t> pos(-2.0f, 37.0f);
+  std::uniform_real_distribution<real_t> height(-3.0f, 3.0f);
+  std::uniform_real_distribution<real_t> size(0.0f, 3.0f);
+
+  for(int q = 0; q < 200; ++q) {
+    phys::Aabb<CFG> query;
+    query.min_bound = {pos(rng), height(rng), pos(rng)};
+    query.max_bound = query.min_bound + vec3_t{size(rng), size(rng), size(rng)};
+
+    // Every cell overlapping the footprint that rises up to the query.
+    std::set<uint32_t> expected;
+    for(uint32_t z = 0; z + 1 < rows; ++z) {
+      for(uint32_t x = 0; x + 1 < columns; ++x) {
+        if((x + 1) * cell_size < query.min_bound.x ||
+           x * cell_size > query.max_bound.x ||
+           (z + 1) * cell_size < query.min_bound.z ||
+           z * cell_size > query.max_bound.z) {
+          continue;
+        }
+
+        real_t top = std::max(
+            std::max(field.getHeight(x, z), field.getHeight(x + 1, z)),
+            std::max(field.getHeight(x, z + 1), field.getHeight(x + 1, z + 1)));
+        if(top >= query.min_bound.y) {
+          uint32_t cell = z * (columns - 1) + x;
+          expected.insert(cell * 2);
+          expected.insert(cell * 2 + 1);
+        }
+      }
+    }
+
+    // Cells are located by flooring, and heights are compared after
+    // quantization, so a few extra ones may come up at the borders.
+    auto found = collectTriangles(field, query);
+    EXPECT_TRUE(std::includes(found.begin(), found.end(), expected.begin(),
+                              expected.end()));
+    EXPECT_LE(found.size(), expected.size() + 16);
+  }
+}
+
+TEST(Heightfield, RejectsQueriesAboveTerrain) {
+  auto samples = makeSamples();
+  Heightfield field(columns, rows, samples.data(), cell_size, height_scale,
+                    height_offset);
+
+  phys::Aabb<CFG> query;
+  query.min_bound = {1.0f, height_offset + 4.0f, 1.0f};
+  query.max_bound = {30.0f, height_offset + 5.0f, 15.0f};
+  EXPECT_TRUE(collectTriangles(field, query).empty());
+
+  query.min_bound = {40.0f, -10.0f, 1.0f};
+  query.max_bound = {41.0f, 10.0f, 2.0f};
+  EXPECT_TRUE(collectTriangles(field, query).empty());
+}
+
+TEST(Heightfield, SphereRestingOnCellEdge) {
+  auto samples = makeFlatSamples();
+  Heightfield field(9, 9, samples.data(), 1.0f, 0.5f, 0.0f);
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+
+  // Inside a cell, then right above an edge and a corner shared by several
+  // triangles, which all find the same point.
+  for(vec3_t const& position : {vec3_t{2.3f, 0.49f, 5.6f},
+                                vec3_t{3.0f, 0.49f, 5.5f},
+                                vec3_t{3.0f, 0.49f, 5.0f}}) {
+    auto collision =
+        collideOnce(&sphere, at(position), &field, phys::Transform<CFG>());
+    ASSERT_EQ(1u, collision.points.size());
+    expectOnFlatGround(collision, -0.01f);
+    EXPECT_NEAR(position.x, collision.points[0].ws_position[1].x, 1e-5f);
+    EXPECT_NEAR(position.z, collision.points[0].ws_position[1].z, 1e-5f);
+  }
+
+  auto above = collideOnce(&sphere, at({3.0f, 0.6f, 5.0f}), &field,
+                           phys::Transform<CFG>());
+  EXPECT_EQ(0u, above.points.size());
+  EXPECT_NEAR(0.1f, above.separation_, 1e-5f);
+}
+
+TEST(Heightfield, SphereInValleyTouchesBothSides) {
+  auto samples = makeValleySamples();
+  Heightfield field(9, 9, samples.data(), 1.0f, 0.5f, 0.0f);
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+
+  // Both sides are 0.49 away from the center, across the cell edge at the
+  // bottom of the valley.
+  real_t slope_len = std::sqrt(1.25f);
+  auto collision = collideOnce(&sphere, at({4.0f, 0.49f * slope_len, 4.5f}),
+                               &field, phys::Transform<CFG>());
+
+  ASSERT_EQ(2u, collision.points.size());
+  std::set<int> sides;
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(-0.01f, point.distance, 1e-5f);
+    EXPECT_NEAR(1.0f / slope_len, point.ws_normal.y, 1e-5f);
+    EXPECT_NEAR(0.5f / slope_len, std::abs(point.ws_normal.x), 1e-5f);
+    sides.insert(point.ws_normal.x > 0 ? 1 : -1);
+  }
+  EXPECT_EQ(2u, sides.size());
+}
+
+TEST(Heightfield, SphereOnRidgeTouchesItsEdge) {
+  // The valley, upside down.
+  auto samples = makeValleySamples();
+  for(auto& sample : samples) {
+    sample = uint16_t(4 - sample);
+  }
+  Heightfield field(9, 9, samples.data(), 1.0f, 0.5f, 0.0f);
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+
+  auto collision = collideOnce(&sphere, at({4.0f, 2.49f, 4.5f}), &field,
+                               phys::Transform<CFG>());
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.01f, point.distance, 1e-5f);
+  EXPECT_NEAR(1.0f, point.ws_normal.y, 1e-5f);
+  EXPECT_NEAR(4.0f, point.ws_position[1].x, 1e-5f);
+  EXPECT_NEAR(2.0f, point.ws_position[1].y, 1e-5f);
+}
+
+TEST(Heightfield, BoxRestingAcrossCells) {
+  auto samples = makeFlatSamples();
+  Heightfield field(9, 9, samples.data(), 1.0f, 0.5f, 0.0f);
+
+  // Its corners lie in four different cells.
+  phys::shapes::Box<CFG> box({0.8f, 0.5f, 0.6f});
+  auto collision = collideOnce(&box, at({4.0f, 0.49f, 3.0f}), &field,
+                               phys::Transform<CFG>());
+
+  ASSERT_EQ(4u, collision.points.size());
+  expectOnFlatGround(collision, -0.01f);
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(0.8f, std::abs(point.ws_position[1].x - 4.0f), 1e-5f);
+    EXPECT_NEAR(0.6f, std::abs(point.ws_position[1].z - 3.0f), 1e-5f);
+  }
+
+  auto above = collideOnce(&box, at({4.0f, 0.6f, 3.0f}), &field,
+                           phys::Transform<CFG>());
+  EXPECT_EQ(0u, above.points.size());
+  EXPECT_NEAR(0.1f, above.separation_, 1e-5f);
+}
+
+TEST(Heightfield, BoxSunkUnderTerrainIsPushedUp) {
+  auto samples = makeFlatSamples();
+  Heightfield field(9, 9, samples.data(), 1.0f, 0.5f, 0.0f);
+
+  phys::shapes::Box<CFG> box({0.3f, 0.3f, 0.3f});
+  auto collision = collideOnce(&box, at({2.5f, -0.1f, 2.5f}), &field,
+                               phys::Transform<CFG>());
+
+  ASSERT_GE(collision.points.size(), 1u);
+  expectOnFlatGround(collision, -0.4f);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "phys/phys.h"
+#include "collide_once.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+namespace {
+// Collides shape with a floor at y = 0.
+phys::Collision<CFG> collideWithFloor(phys::Shape<CFG>* shape,
+                                      phys::Transform<CFG> const& transform) {
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+  return collideOnce(shape, transform, &floor, phys::Transform<CFG>());
+}
+}
+
+TEST(PlaneContacts, FlatBoxGetsFullManifold) {
+  phys::shapes::Box<CFG> box({1.0f, 0.5f, 2.0f});
+  auto collision = collideWithFloor(&box, at({3.0f, 0.49f, -1.0f}));
+
+  ASSERT_EQ(4u, collision.points.size());
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(-0.01f, point.distance, 1e-5f);
+    EXPECT_NEAR(1.0f, std::abs(point.ws_position[1].x - 3.0f), 1e-5f);
+    EXPECT_NEAR(2.0f, std::abs(point.ws_position[1].z + 1.0f), 1e-5f);
+  }
+}
+
+TEST(PlaneContacts, TiltedBoxTouchesWithOneCorner) {
+  phys::shapes::Box<CFG> box({0.5f, 0.5f, 0.5f});
+  auto transform = at({0.0f, 0.8f, 0.0f});
+  transform.setRotation(normalize(CFG::quat_t(0.9f, 0.3f, 0.0f, 0.2f)));
+  auto collision = collideWithFloor(&box, transform);
+
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_LT(collision.points[0].distance, 0.0f);
+}
+
+TEST(PlaneContacts, BoxAboveReportsSeparation) {
+  phys::shapes::Box<CFG> box({0.5f, 0.5f, 0.5f});
+  auto collision = collideWithFloor(&box, at({0.0f, 1.5f, 0.0f}));
+
+  EXPECT_EQ(0u, collision.points.size());
+  EXPECT_FLOAT_EQ(1.0f, collision.separation_);
+}
+
+TEST(PlaneContacts, HullRestingOnFaceGetsFullManifold) {
+  // A cylinder-like hull, its bottom face has many more vertices than a
+  // collision can hold.
+  std::vector<vec3_t> points;
+  for(int i = 0; i < 40; ++i) {
+    real_t angle = real_t(i) * 6.2831853f / 40.0f;
+    for(real_t y : {-0.3f, 0.3f}) {
+      points.push_back({0.5f * std::cos(angle), y, 0.5f * std::sin(angle)});
+    }
+  }
+  phys::shapes::ConvexHull<CFG> hull(points.data(), points.size());
+
+  auto collision = collideWithFloor(&hull, at({0.0f, 0.29f, 0.0f}));
+
+  // The points kept are spread around the rim rather than bunched up.
+  ASSERT_EQ(4u, collision.points.size());
+  real_t widest_sq = 0;
+  for(auto const& point : collision.points) {
+    EXPECT_NEAR(-0.01f, point.distance, 1e-5f);
+    for(auto const& other : collision.points) {
+      vec3_t d = point.ws_position[1] - other.ws_position[1];
+      widest_sq = std::max(widest_sq, dot(d, d));
+    }
+  }
+  EXPECT_GT(widest_sq, 0.9f * 0.9f);
+
+  auto far = collideWithFloor(&hull, at({0.0f, 1.0f, 0.0f}));
+  EXPECT_EQ(0u, far.points.size());
+  EXPECT_NEAR(0.7f, far.separation_, 1e-5f);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using Collision = phys::Collision<CFG>;
+
+TEST(Separation, UnknownSeparationNeverSkips) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  EXPECT_FALSE(collision.updateSeparation());
+}
+
+TEST(Separation, SkipsUntilMotionWearsTheGapDown) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  a.updateMotion();
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+  b.transform.setTranslation({1.5f, 0.0f, 0.0f});
+  b.updateMotion();
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  auto narrowphase = factory.getNarrowphase(&sphere, &sphere);
+  collision.points.setCapacity(narrowphase->contactCapacity());
+
+  // The spheres are 0.5 apart, which the narrowphase reports.
+  narrowphase->process(&collision);
+  ASSERT_EQ(0u, collision.points.size());
+
+  // Each step, b gets 0.1 closer. The narrowphase can be skipped as long as
+  // what is left of the gap is beyond the contact distance.
+  for(int i = 1; i <= 4; ++i) {
+    b.transform.setTranslation({1.5f - 0.1f * real_t(i), 0.0f, 0.0f});
+    b.updateMotion();
+    EXPECT_TRUE(collision.updateSeparation()) << "step " << i;
+  }
+
+  b.transform.setTranslation({1.0f, 0.0f, 0.0f});
+  b.updateMotion();
+  ASSERT_FALSE(collision.updateSeparation());
+
+  narrowphase->process(&collision);
+  ASSERT_EQ(1u, collision.points.size());
+  EXPECT_NEAR(0.0f, collision.points[0].distance, 1e-5f);
+
+  // Once touching, the narrowphase runs every step.
+  b.updateMotion();
+  EXPECT_FALSE(collision.updateSeparation());
+}
+
+TEST(Separation, RotationCountsAsMotion) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> a;
+  a.shape = &sphere;
+  a.updateMotion();
+  phys::col::Object<CFG> b;
+  b.shape = &sphere;
+  b.transform.setTranslation({1.1f, 0.0f, 0.0f});
+  b.updateMotion();
+
+  Collision collision;
+  collision.objects = {&a, &b};
+  auto narrowphase = factory.getNarrowphase(&sphere, &sphere);
+  collision.points.setCapacity(narrowphase->contactCapacity());
+  narrowphase->process(&collision);
+  ASSERT_EQ(0u, collision.points.size());
+
+  // Spinning in place does not bring a sphere any closer, but the bound on
+  // its motion cannot tell, so the gap of 0.1 is used up all the same.
+  a.transform.setRotation(
+      CFG::quat_t(std::cos(0.25f), 0.0f, std::sin(0.25f), 0.0f));
+  a.updateMotion();
+  EXPECT_GT(a.frame_motion_, 0.1f);
+  EXPECT_FALSE(collision.updateSeparation());
+}
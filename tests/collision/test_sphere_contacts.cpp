@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+#include "phys/phys.h"
+#include "collide_once.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+namespace {
+// Collides shape, at the origin, with a sphere of radius 0.5.
+phys::Collision<CFG> collideWithSphere(phys::Shape<CFG>* shape,
+                                       vec3_t const& sphere_position) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  auto collision = collideOnce(shape, phys::Transform<CFG>(), &sphere,
+                               at(sphere_position));
+  EXPECT_EQ(1u, collision.points.capacity());
+  return collision;
+}
+
+phys::shapes::ConvexHull<CFG> makeCubeHull() {
+  std::vector<vec3_t> points;
+  for(int x = -1; x <= 1; x += 2) {
+    for(int y = -1; y <= 1; y += 2) {
+      for(int z = -1; z <= 1; z += 2) {
+        points.push_back({real_t(x), real_t(y), real_t(z)});
+      }
+    }
+  }
+  return phys::shapes::ConvexHull<CFG>(points.data(), points.size());
+}
+}
+
+TEST(SphereContacts, BoxCorner) {
+  phys::shapes::Box<CFG> box({1.0f, 1.0f, 1.0f});
+  auto collision = collideWithSphere(&box, {1.2f, 1.2f, 1.2f});
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  real_t corner_dist = std::sqrt(3.0f * 0.04f);
+  EXPECT_NEAR(corner_dist - 0.5f, point.distance, 1e-5f);
+  expectVecNear({1.0f, 1.0f, 1.0f}, point.ws_position[0]);
+  // The normal points from the sphere towards the box.
+  expectVecNear(-normalize(vec3_t(1.0f, 1.0f, 1.0f)), point.ws_normal);
+}
+
+TEST(SphereContacts, SphereCenterInsideBox) {
+  phys::shapes::Box<CFG> box({1.0f, 2.0f, 1.0f});
+  auto collision = collideWithSphere(&box, {0.0f, 0.0f, 0.8f});
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.7f, point.distance, 1e-5f);
+  expectVecNear({0.0f, 0.0f, -1.0f}, point.ws_normal);
+}
+
+TEST(SphereContacts, SeparatedFromBox) {
+  phys::shapes::Box<CFG> box({1.0f, 1.0f, 1.0f});
+  auto collision = collideWithSphere(&box, {0.0f, 3.0f, 0.0f});
+
+  EXPECT_EQ(0u, collision.points.size());
+}
+
+TEST(SphereContacts, Plane) {
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 1.0f);
+  auto collision = collideWithSphere(&floor, {2.0f, 1.4f, -3.0f});
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.1f, point.distance, 1e-5f);
+  expectVecNear({2.0f, 1.0f, -3.0f}, point.ws_position[0]);
+  expectVecNear({0.0f, -1.0f, 0.0f}, point.ws_normal);
+}
+
+TEST(SphereContacts, ConvexHullEdge) {
+  auto hull = makeCubeHull();
+  auto collision = collideWithSphere(&hull, {1.3f, 0.5f, 1.3f});
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(std::sqrt(0.18f) - 0.5f, point.distance, 1e-5f);
+  expectVecNear({1.0f, 0.5f, 1.0f}, point.ws_position[0]);
+  expectVecNear(-normalize(vec3_t(1.0f, 0.0f, 1.0f)), point.ws_normal);
+}
+
+TEST(SphereContacts, SphereCenterInsideConvexHull) {
+  auto hull = makeCubeHull();
+  auto collision = collideWithSphere(&hull, {0.2f, -0.7f, 0.1f});
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.8f, point.distance, 1e-5f);
+  expectVecNear({0.2f, -1.0f, 0.1f}, point.ws_position[0]);
+  expectVecNear({0.0f, 1.0f, 0.0f}, point.ws_normal);
+}
+
+TEST(SphereContacts, FlatConvexHull) {
+  std::vector<vec3_t> points = {{-1.0f, 0.0f, -1.0f},
+                                {1.0f, 0.0f, -1.0f},
+                                {1.0f, 0.0f, 1.0f},
+                                {-1.0f, 0.0f, 1.0f}};
+  phys::shapes::ConvexHull<CFG> hull(points.data(), points.size());
+  auto collision = collideWithSphere(&hull, {0.3f, 0.45f, 0.6f});
+
+  ASSERT_EQ(1u, collision.points.size());
+  auto const& point = collision.points[0];
+  EXPECT_NEAR(-0.05f, point.distance, 1e-5f);
+  expectVecNear({0.3f, 0.0f, 0.6f}, point.ws_position[0]);
+}
+
+TEST(SphereContacts, ConvexHullWalkMatchesBruteForce) {
+  std::mt19937 rng(99);
+  std::normal_distribution<real_t> dist;
+  std::uniform_real_distribution<real_t> gap(0.0f, 0.4f);
+
+  // A lumpy, stretched hull with plenty of faces.
+  std::vector<vec3_t> points;
+  for(int i = 0; i < 200; ++i) {
+    vec3_t p = normalize(vec3_t(dist(rng), dist(rng), dist(rng)));
+    p *= 1.0f + gap(rng);
+    points.push_back({2.0f * p.x, p.y, 0.5f * p.z});
+  }
+  phys::shapes::ConvexHull<CFG> hull(points.data(), points.size());
+  ASSERT_GT(hull.getFaceCount(), 100u);
+
+  for(int q = 0; q < 200; ++q) {
+    // Somewhere just outside the hull, close enough to touch it.
+    vec3_t dir = normalize(vec3_t(dist(rng), dist(rng), dist(rng)));
+    vec3_t center = hull.getSupportingVertex(dir);
+    center += dir * gap(rng);
+
+    real_t best_dist_sq = std::numeric_limits<real_t>::max();
+    vec3_t best;
+    for(uint32_t i = 0; i < hull.getFaceCount(); ++i) {
+      auto const& face = hull.getFace(i);
+      vec3_t closest = phys::closestPointOnTriangle<CFG>(
+          hull.getVertex(face.vertices[0]), hull.getVertex(face.vertices[1]),
+          hull.getVertex(face.vertices[2]), center);
+      vec3_t delta = center - closest;
+      if(dot(delta, delta) < best_dist_sq) {
+        best_dist_sq = dot(delta, delta);
+        best = closest;
+      }
+    }
+
+    auto collision = collideWithSphere(&hull, center);
+    ASSERT_EQ(1u, collision.points.size());
+    EXPECT_NEAR(std::sqrt(best_dist_sq) - 0.5f, collision.points[0].distance,
+                1e-4f);
+    expectVecNear(best, collision.points[0].ws_position[0], 1e-4f);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include "phys/phys.h"
+#include "grid_mesh.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using TriangleMesh = phys::shapes::TriangleMesh<CFG>;
+
+namespace {
+// Copies a blob to a 16 bytes boundary of storage, as if it was loaded from a
+// file.
+void* alignedCopy(void const* blob, std::size_t size,
+                  std::vector<uint8_t>* storage) {
+  storage->assign(size + 15, 0);
+  void* result = storage->data();
+  std::size_t space = storage->size();
+  std::align(16, size, result, space);
+  if(blob) {
+    std::memcpy(result, blob, size);
+  }
+  return result;
+}
+
+std::vector<vec3_t> collectTriangles(TriangleMesh const& mesh,
+                                     phys::Aabb<CFG> const& query) {
+  std::vector<vec3_t> result;
+  mesh.visitTriangles(query, [&](uint32_t, vec3_t const* tri) {
+    result.insert(result.end(), tri, tri + 3);
+  });
+  return result;
+}
+}
+
+TEST(TriangleMesh, MidphaseFindsAllOverlappingTriangles) {
+  std::vector<vec3_t> vertices;
+  std::vector<uint32_t> indices;
+  makeGrid(32, 0.1f, {0.0f, 0.0f, 0.0f}, &vertices, &indices);
+
+  TriangleMesh mesh(vertices.data(), uint32_t(vertices.size()), indices.data(),
+                    uint32_t(indices.size() / 3));
+  EXPECT_EQ(indices.size() / 3, mesh.getTriangleCount());
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<real_t> pos(-2.0f, 34.0f);
+  std::uniform_real_distribution<real_t> size(0.0f, 3.0f);
+
+  for(int q = 0; q < 200; ++q) {
+    phys::Aabb<CFG> query;
+    query.min_bound = {pos(rng), pos(rng) * 0.05f, pos(rng)};
+    query.max_bound = query.min_bound + vec3_t{size(rng), size(rng), size(rng)};
+
+    std::size_t expected = 0;
+    for(std::size_t t = 0; t < indices.size(); t += 3) {
+      vec3_t tri_min = vertices[indices[t]];
+      vec3_t tri_max = tri_min;
+      for(int v = 1; v < 3; ++v) {
+        tri_min = min(tri_min, vertices[indices[t + v]]);
+        tri_max = max(tri_max, vertices[indices[t + v]]);
+      }
+
+      bool overlap = true;
+      for(int i = 0; i < 3; ++i) {
+        overlap = overlap && tri_max[i] >= query.min_bound[i] &&
+                  tri_min[i] <= query.max_bound[i];
+      }
+      expected += overlap ? 1 : 0;
+    }
+
+    // The midphase is conservative, it may return a few extra triangles.
+    auto found = collectTriangles(mesh, query).size() / 3;
+    EXPECT_GE(found, expected);
+    EXPECT_LE(found, expected + 32);
+  }
+}
+
+TEST(TriangleMesh, BakedDataRoundTrip) {
+  std::vector<vec3_t> vertices;
+  std::vector<uint32_t> indices;
+  makeGrid(16, 0.1f, {0.0f, 0.0f, 0.0f}, &vertices, &indices);
+
+  TriangleMesh built(vertices.data(), uint32_t(vertices.size()),
+                     indices.data(), uint32_t(indices.size() / 3));
+
+  // Simulate loading the blob at a different address.
+  std::size_t size = built.getBakedSize();
+  std::vector<uint8_t> storage;
+  void* blob = alignedCopy(built.getBakedData(), size, &storage);
+
+  ASSERT_TRUE(TriangleMesh::isValidBakedData(blob, size));
+  EXPECT_FALSE(TriangleMesh::isValidBakedData(blob, size - 1));
+
+  TriangleMesh loaded(blob, size);
+  EXPECT_EQ(built.getTriangleCount(), loaded.getTriangleCount());
+
+  phys::Aabb<CFG> query;
+  query.min_bound = {3.5f, -1.0f, 3.5f};
+  query.max_bound = {6.5f, 1.0f, 5.0f};
+  EXPECT_EQ(collectTriangles(built, query), collectTriangles(loaded, query));
+}
+
+TEST(TriangleMesh, RejectsGarbage) {
+  std::vector<uint8_t> storage;
+  EXPECT_FALSE(
+      TriangleMesh::isValidBakedData(alignedCopy(nullptr, 512, &storage), 512));
+}
+
+TEST(TriangleMesh, RejectsOutOfRangeIndices) {
+  using Node = phys::shapes::BakedTriangleMeshNode;
+
+  std::vector<vec3_t> vertices;
+  std::vector<uint32_t> indices;
+  makeGrid(8, 0.1f, {0.0f, 0.0f, 0.0f}, &vertices, &indices);
+
+  TriangleMesh built(vertices.data(), uint32_t(vertices.size()),
+                     indices.data(), uint32_t(indices.size() / 3));
+  std::size_t size = built.getBakedSize();
+  phys::shapes::BakedTriangleMeshHeader header;
+  std::memcpy(&header, built.getBakedData(), sizeof(header));
+
+  // Checks a copy of the blob, after edit(triangles, nodes) corrupted it.
+  auto valid_after = [&](auto edit) {
+    std::vector<uint8_t> storage;
+    auto blob = static_cast<uint8_t*>(
+        alignedCopy(built.getBakedData(), size, &storage));
+    edit(reinterpret_cast<uint32_t*>(blob + header.triangles_offset),
+         reinterpret_cast<Node*>(blob + header.nodes_offset));
+    return TriangleMesh::isValidBakedData(blob, size);
+  };
+
+  EXPECT_TRUE(valid_after([](uint32_t*, Node*) {}));
+
+  EXPECT_FALSE(valid_after([&](uint32_t* triangles, Node*) {
+    triangles[5] = header.vertex_count;
+  }));
+
+  // The root is internal, its right child must be one of the nodes.
+  EXPECT_FALSE(valid_after(
+      [&](uint32_t*, Node* nodes) { nodes[0].data = header.node_count; }));
+
+  // Pointing back up would loop.
+  EXPECT_FALSE(valid_after([&](uint32_t*, Node* nodes) { nodes[0].data = 0; }));
+
+  // The last node is a leaf, its triangles must be in the mesh.
+  EXPECT_FALSE(valid_after([&](uint32_t*, Node* nodes) {
+    auto& leaf = nodes[header.node_count - 1];
+    ASSERT_TRUE(leaf.isLeaf());
+    leaf.data = Node::leaf_flag |
+                ((header.triangle_count - 1) << Node::leaf_count_bits) | 1;
+  }));
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using real_t = CFG::real_t;
+using Scene = TestScene<>;
+
+namespace {
+const real_t threshold = 1e-2f;
+
+// Warm starting leaves each step a fraction of the impulses to build back
+// up, which takes more iterations the taller the column. Three spheres
+// settle within the budget.
+enum { column_height = 3, iterations = 10 };
+
+// Adds a column of spheres at x, and returns its top sphere.
+Scene::DynamicBody* addColumn(Scene* scene, real_t x) {
+  Scene::DynamicBody* top = nullptr;
+  for(int y = 0; y < column_height; ++y) {
+    top = scene->add(&scene->sphere, {x, 0.5f + real_t(y), 0.0f});
+  }
+  return top;
+}
+
+// A box and a column of spheres, far enough from each other to be separate
+// islands, resting on the floor.
+void addIslands(Scene* scene, real_t residual_threshold) {
+  auto& config = scene->world->solver().config();
+  config.iterations = iterations;
+  config.residual_threshold = residual_threshold;
+
+  scene->addFloor();
+  scene->add(&scene->box, {-5.0f, 0.5f, 0.0f});
+  addColumn(scene, 5.0f);
+}
+}
+
+TEST(AdaptiveIterations, ReportsEachIsland) {
+  Scene scene(16);
+  addIslands(&scene, threshold);
+  scene.run(120);
+
+  auto stats = scene.islandStats();
+  ASSERT_EQ(2u, stats.size());
+  EXPECT_NE(stats[0].island_id, stats[1].island_id);
+
+  // The box has four points on the floor, and the column one per sphere.
+  std::vector<uint32_t> contact_counts = {stats[0].contact_count,
+                                          stats[1].contact_count};
+  std::vector<uint32_t> expected = {4u, uint32_t(column_height)};
+  std::sort(contact_counts.begin(), contact_counts.end());
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, contact_counts);
+}
+
+TEST(AdaptiveIterations, RestingIslandsStopEarly) {
+  Scene scene(16);
+  auto& config = scene.world->solver().config();
+  config.iterations = iterations;
+  config.residual_threshold = threshold;
+
+  // Two identical columns, left to settle.
+  scene.addFloor();
+  auto resting = addColumn(&scene, -5.0f);
+  auto disturbed = addColumn(&scene, 5.0f);
+  scene.run(120);
+
+  // Then one of them gets pushed down hard for a step. The impulses its
+  // contacts start from are then far off, while the other column's are
+  // still right.
+  disturbed->applyForce({0.0f, -50.0f * 9.81f * disturbed->getMass(), 0.0f});
+  scene.run(1);
+
+  auto stats = scene.islandStats();
+  ASSERT_EQ(2u, stats.size());
+  for(auto const& island : stats) {
+    bool is_resting = island.island_id == resting->island_id_;
+    ASSERT_TRUE(is_resting || island.island_id == disturbed->island_id_);
+    if(is_resting) {
+      EXPECT_LT(island.iterations, iterations);
+      EXPECT_LE(island.residual, threshold);
+    } else {
+      EXPECT_EQ(iterations, island.iterations);
+      EXPECT_GT(island.residual, threshold);
+    }
+  }
+}
+
+TEST(AdaptiveIterations, RestingBoxSettlesInFewIterations) {
+  Scene scene(16);
+  addIslands(&scene, threshold);
+  scene.run(120);
+
+  for(auto const& island : scene.islandStats()) {
+    EXPECT_EQ(1, island.penetration_iterations);
+
+    // Warm starting does most of the box's work.
+    if(island.contact_count == 4) {
+      EXPECT_LE(island.iterations, 5);
+    }
+  }
+}
+
+TEST(AdaptiveIterations, RunsEveryIterationByDefault) {
+  Scene scene(16);
+  addIslands(&scene, phys::seqi_solver::Config<CFG>().residual_threshold);
+  scene.run(120);
+
+  for(auto const& island : scene.islandStats()) {
+    EXPECT_EQ(iterations, island.iterations);
+  }
+}
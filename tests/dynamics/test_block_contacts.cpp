@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using real_t = CFG::real_t;
+using Block = phys::seqi_solver::ContactBlock<CFG>;
+
+namespace {
+// A block of size contacts, whose mass matrix is 2 on the diagonal and 1
+// everywhere else.
+Block makeBlock(uint32_t size) {
+  Block block;
+  block.contacts_begin = 0;
+  block.contacts_end = size;
+  for(uint32_t i = 0; i < size; ++i) {
+    for(uint32_t j = 0; j < size; ++j) {
+      block.mass[i * Block::max_size + j] = i == j ? 2.0f : 1.0f;
+    }
+  }
+  return block;
+}
+
+void expectComplementarity(Block const& block, real_t const* q,
+                           real_t const* x) {
+  for(uint32_t i = 0; i < block.size(); ++i) {
+    real_t w = -q[i];
+    for(uint32_t j = 0; j < block.size(); ++j) {
+      w += block.mass[i * Block::max_size + j] * x[j];
+    }
+
+    EXPECT_GE(x[i], 0.0f);
+    EXPECT_GE(w, -1e-5f);
+    EXPECT_NEAR(0.0f, x[i] * w, 1e-5f);
+  }
+}
+}
+
+TEST(ContactBlock, SolvesEveryCase) {
+  const real_t qs[][4] = {{3.0f, 3.0f, 3.0f, 3.0f},
+                          {3.0f, -1.0f, 2.0f, 0.5f},
+                          {-1.0f, -1.0f, 4.0f, -2.0f},
+                          {-1.0f, -1.0f, -1.0f, -1.0f}};
+
+  for(uint32_t size = 2; size <= Block::max_size; ++size) {
+    Block block = makeBlock(size);
+    for(auto const& q : qs) {
+      // The hint should not matter.
+      for(uint32_t active : {0u, 1u, (1u << size) - 1}) {
+        real_t x[Block::max_size];
+        ASSERT_TRUE(block.solve(q, active, x));
+        expectComplementarity(block, q, x);
+      }
+    }
+  }
+}
+
+TEST(ContactBlock, SharesLoadEvenly) {
+  Block block = makeBlock(4);
+  const real_t q[] = {5.0f, 5.0f, 5.0f, 5.0f};
+  real_t x[Block::max_size];
+  ASSERT_TRUE(block.solve(q, 0, x));
+
+  for(auto impulse : x) {
+    EXPECT_NEAR(1.0f, impulse, 1e-5f);
+  }
+}
+
+TEST(BlockContacts, RestingPlankSettlesInOneIteration) {
+  phys::shapes::Box<CFG> plank({2.0f, 0.25f, 0.5f});
+  TestScene<> scene(4);
+  auto& config = scene.world->solver().config();
+  config.block_contacts = true;
+  config.iterations = 1;
+  config.warm_start_factor = 0.0f;
+
+  scene.addFloor();
+  auto body = scene.add(&plank, {0.0f, 0.25f, 0.0f});
+
+  for(int i = 0; i < 120; ++i) {
+    scene.run(1);
+
+    EXPECT_NEAR(0.0f, body->getLinearVelocity().y, 1e-3f);
+    EXPECT_NEAR(0.0f, length(body->getAngularVelocity()), 1e-3f);
+  }
+  EXPECT_NEAR(0.25f, body->getPosition().y, 1e-3f);
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using World = TestScene<>::World;
+using SolverBody = phys::seqi_solver::Body<CFG>;
+using BodyDeltas = phys::seqi_solver::BodyDeltas<CFG>;
+using Constraint = phys::seqi_solver::ContactConstraint<CFG>;
+
+namespace {
+const real_t dt = 1.0f / 60.0f;
+
+// Random contacts between a set of unit bodies and the static body, which
+// comes last. Since constraints refer to bodies by index, copies of the
+// deltas can be solved both ways.
+struct Scene {
+  enum { hub_contacts = 80 };
+
+  Scene(int body_count, int contact_count, bool independent)
+      : data(body_count), transforms(body_count), points(contact_count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<real_t> dist(-1.0f, 1.0f);
+    auto random_vec = [&]() { return vec3_t{dist(rng), dist(rng), dist(rng)}; };
+
+    for(int i = 0; i < body_count; ++i) {
+      data[i].transform = &transforms[i];
+      data[i].inv_inertia_tensor_world_ = CFG::mat3x3_t(1.0f);
+      data[i].linear_velocity_ = random_vec();
+      bodies.emplace_back(&data[i], dt);
+    }
+    bodies.emplace_back();
+    deltas.resize(bodies.size());
+    push_deltas.resize(bodies.size());
+
+    phys::seqi_solver::Config<CFG> config;
+    for(int i = 0; i < contact_count; ++i) {
+      int a = independent ? 2 * i : int(rng() % body_count);
+      int b = independent ? 2 * i + 1 : int(rng() % body_count);
+      if(!independent && i < hub_contacts) {
+        // More contacts on the same body than there are colors.
+        a = 0;
+        b = 1 + i;
+      }
+      uint32_t body_b = (b == a || i % 5 == 0) ? uint32_t(body_count)
+                                               : uint32_t(b);
+
+      points[i].ws_normal = normalize(random_vec());
+      points[i].distance = -0.05f * (dist(rng) + 1.0f);
+      constraints.emplace_back(config, dt, &points[i], bodies, uint32_t(a),
+                               body_b, random_vec(), random_vec(), -1.0f);
+    }
+  }
+
+  std::vector<phys::DynamicBodyData<CFG>> data;
+  std::vector<phys::Transform<CFG>> transforms;
+  std::vector<phys::Contact<CFG>> points;
+  std::vector<SolverBody> bodies;
+  BodyDeltas deltas;
+  BodyDeltas push_deltas;
+  std::vector<Constraint> constraints;
+};
+
+void expectSameDeltas(BodyDeltas const& expected, BodyDeltas const& actual,
+                      real_t tolerance) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for(std::size_t i = 0; i < expected.size(); ++i) {
+    for(int c = 0; c < 3; ++c) {
+      EXPECT_NEAR(expected[i].linear[c], actual[i].linear[c], tolerance);
+      EXPECT_NEAR(expected[i].angular[c], actual[i].angular[c], tolerance);
+    }
+  }
+}
+}
+
+using Solver = phys::seqi_solver::Solver<CFG>;
+
+TEST(ContactBatches, IndependentContactsMatchScalarSolver) {
+  Scene scene(200, 100, true);
+  auto deltas = scene.deltas;
+  auto push_deltas = scene.push_deltas;
+  auto constraints = scene.constraints;
+
+  for(auto& constraint : scene.constraints) {
+    Solver::solvePenetration_(constraint, scene.push_deltas.data());
+    Solver::solveContact_(constraint, scene.deltas.data());
+  }
+
+  phys::seqi_solver::ContactBatches<CFG> batches;
+  batches.build(constraints, deltas, push_deltas);
+  batches.solvePenetrations();
+  batches.solveContacts();
+  batches.store();
+
+  expectSameDeltas(scene.deltas, deltas, 1e-5f);
+  expectSameDeltas(scene.push_deltas, push_deltas, 1e-5f);
+  for(std::size_t i = 0; i < constraints.size(); ++i) {
+    EXPECT_NEAR(scene.constraints[i].applied_impulse,
+                constraints[i].applied_impulse, 1e-4f);
+    EXPECT_NEAR(scene.constraints[i].applied_push_impulse,
+                constraints[i].applied_push_impulse, 1e-4f);
+  }
+  for(int c = 0; c < 3; ++c) {
+    EXPECT_EQ(0.0f, scene.deltas.back().linear[c]);
+    EXPECT_EQ(0.0f, deltas.back().linear[c]);
+  }
+}
+
+TEST(ContactBatches, SharedBodiesConvergeLikeScalarSolver) {
+  Scene scene(200, 500, false);
+  auto deltas = scene.deltas;
+  auto push_deltas = scene.push_deltas;
+  auto constraints = scene.constraints;
+
+  phys::seqi_solver::ContactBatches<CFG> batches;
+  batches.build(constraints, deltas, push_deltas);
+  for(int i = 0; i < 500; ++i) {
+    for(auto& constraint : scene.constraints) {
+      Solver::solveContact_(constraint, scene.deltas.data());
+    }
+    batches.solveContacts();
+  }
+  batches.store();
+
+  expectSameDeltas(scene.deltas, deltas, 1e-3f);
+}
+
+TEST(ContactBatches, ThreadPoolDoesNotChangeResults) {
+  Scene scene(2000, 4000, false);
+  auto serial_deltas = scene.deltas;
+  auto serial_push_deltas = scene.push_deltas;
+  auto serial_constraints = scene.constraints;
+  auto parallel_deltas = scene.deltas;
+  auto parallel_push_deltas = scene.push_deltas;
+  auto parallel_constraints = scene.constraints;
+
+  phys::ThreadPool thread_pool(3);
+  phys::seqi_solver::ContactBatches<CFG> serial;
+  phys::seqi_solver::ContactBatches<CFG> parallel;
+  serial.build(serial_constraints, serial_deltas, serial_push_deltas);
+  parallel.build(parallel_constraints, parallel_deltas, parallel_push_deltas);
+  for(int i = 0; i < 10; ++i) {
+    EXPECT_EQ(serial.solvePenetrations(),
+              parallel.solvePenetrations(&thread_pool));
+  }
+  for(int i = 0; i < 10; ++i) {
+    EXPECT_EQ(serial.solveContacts(), parallel.solveContacts(&thread_pool));
+  }
+  serial.store();
+  parallel.store();
+
+  expectSameDeltas(serial_deltas, parallel_deltas, 0.0f);
+  expectSameDeltas(serial_push_deltas, parallel_push_deltas, 0.0f);
+  for(std::size_t i = 0; i < serial_constraints.size(); ++i) {
+    EXPECT_EQ(serial_constraints[i].applied_impulse,
+              parallel_constraints[i].applied_impulse);
+    EXPECT_EQ(serial_constraints[i].applied_push_impulse,
+              parallel_constraints[i].applied_push_impulse);
+  }
+  for(int c = 0; c < 3; ++c) {
+    EXPECT_EQ(0.0f, serial_deltas.back().linear[c]);
+  }
+}
+
+TEST(ContactBatches, SpheresRestOnEachOther) {
+  phys::shapes::Box<CFG> wall_x({0.5f, 1.0f, 2.9f});
+  phys::shapes::Box<CFG> wall_z({2.9f, 1.0f, 0.5f});
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+
+  TestScene<> scene(64);
+  scene.world->solver().config().batch_contacts = true;
+  scene.addFloor();
+
+  // Walls around a 6 x 6 area, which a tightly packed layer of spheres fills
+  // up. A second layer rests in the hollows of the first one, and they all
+  // end up in the same island.
+  for(int side = 0; side < 2; ++side) {
+    World::StaticBody::Config cfg_x(&wall_x);
+    cfg_x.initial_transform.setTranslation(
+        {side ? 6.0f : -1.0f, 1.0f, 2.5f});
+    scene.world->createBody(cfg_x);
+
+    World::StaticBody::Config cfg_z(&wall_z);
+    cfg_z.initial_transform.setTranslation(
+        {2.5f, 1.0f, side ? 6.0f : -1.0f});
+    scene.world->createBody(cfg_z);
+  }
+
+  std::vector<World::DynamicBody*> bottom;
+  std::vector<World::DynamicBody*> top;
+  for(int x = 0; x < 6; ++x) {
+    for(int z = 0; z < 6; ++z) {
+      bottom.push_back(scene.add(&sphere, {real_t(x), 0.5f, real_t(z)}));
+
+      if(x > 1 && x < 4 && z > 1 && z < 4) {
+        top.push_back(scene.add(
+            &sphere, {real_t(x) + 0.5f, 1.21f, real_t(z) + 0.5f}));
+      }
+    }
+  }
+
+  scene.run(60);
+
+  for(auto body : bottom) {
+    EXPECT_NEAR(0.5f, body->getPosition().y, 0.02f);
+  }
+  for(auto body : top) {
+    EXPECT_GT(body->getPosition().y, 1.1f);
+  }
+}
\ No newline at end of file
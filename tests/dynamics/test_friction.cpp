@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using Scene = TestScene<>;
+
+namespace {
+// A box resting on the floor, with both of them having the same friction
+// coefficient.
+Scene::DynamicBody* addBoxOnFloor(Scene* scene, real_t friction,
+                                  bool batched) {
+  scene->world->solver().config().batch_contacts = batched;
+  scene->world->solver().config().min_batched_contacts = 1;
+
+  scene->addFloor(friction);
+  Scene::DynamicBody::Config box_cfg(&scene->box);
+  box_cfg.friction = friction;
+  return scene->add(box_cfg, {0.0f, 0.5f, 0.0f});
+}
+
+// Every test runs through both the scalar and the batched solver.
+const bool solver_paths[] = {false, true};
+}
+
+TEST(Friction, HoldsOnGentleSlope) {
+  for(bool batched : solver_paths) {
+    Scene scene(4);
+    auto box = addBoxOnFloor(&scene, 0.5f, batched);
+    scene.run(120, Scene::slope(std::atan(0.3f)));
+
+    EXPECT_NEAR(0.0f, box->getPosition().x, 0.01f);
+    EXPECT_NEAR(0.0f, box->getLinearVelocity().x, 0.01f);
+  }
+}
+
+TEST(Friction, SlidesDownSteepSlope) {
+  for(bool batched : solver_paths) {
+    // Sliding friction takes mu * cos(angle) off the acceleration.
+    Scene scene(4);
+    auto box = addBoxOnFloor(&scene, 0.5f, batched);
+    real_t angle = std::atan(1.0f);
+    scene.run(60, Scene::slope(angle));
+
+    real_t expected = 9.81f * (std::sin(angle) - 0.5f * std::cos(angle));
+    EXPECT_NEAR(expected, box->getLinearVelocity().x, 0.1f);
+  }
+}
+
+TEST(Friction, StopsSlidingBox) {
+  for(bool batched : solver_paths) {
+    Scene scene(4);
+    auto box = addBoxOnFloor(&scene, 0.5f, batched);
+    box->setLinearVelocity({2.0f, 0.0f, 1.0f});
+    scene.run(60);
+
+    // It takes v / (mu * g) to stop, about half a second.
+    vec3_t vel = box->getLinearVelocity();
+    EXPECT_NEAR(0.0f, vel.x, 0.01f);
+    EXPECT_NEAR(0.0f, vel.z, 0.01f);
+    EXPECT_NEAR(0.5f, box->getPosition().y, 0.01f);
+
+    // Along a straight line.
+    vec3_t pos = box->getPosition();
+    EXPECT_NEAR(pos.x, pos.z * 2.0f, 0.02f);
+  }
+}
+
+TEST(Friction, StopsSpinningBox) {
+  for(bool batched : solver_paths) {
+    Scene scene(4);
+    auto box = addBoxOnFloor(&scene, 0.5f, batched);
+    box->setAngularVelocity({0.0f, 5.0f, 0.0f});
+    scene.run(60);
+
+    EXPECT_NEAR(0.0f, box->getAngularVelocity().y, 0.01f);
+    EXPECT_NEAR(0.0f, length(box->getLinearVelocity()), 0.01f);
+  }
+}
+
+TEST(Friction, NoFrictionKeepsSliding) {
+  for(bool batched : solver_paths) {
+    Scene scene(4);
+    auto box = addBoxOnFloor(&scene, 0.0f, batched);
+    box->setLinearVelocity({2.0f, 0.0f, 0.0f});
+    scene.run(60);
+
+    EXPECT_NEAR(2.0f, box->getLinearVelocity().x, 1e-3f);
+  }
+}
+
+TEST(Friction, BatchedMatchesScalar) {
+  // A single box's contacts and friction each get a group of their own, in
+  // the same order as the scalar solver, so both paths should agree.
+  Scene scalar_scene(4);
+  Scene batched_scene(4);
+  auto scalar = addBoxOnFloor(&scalar_scene, 0.5f, false);
+  auto batched = addBoxOnFloor(&batched_scene, 0.5f, true);
+  for(auto box : {scalar, batched}) {
+    box->setLinearVelocity({2.0f, 0.0f, 1.0f});
+    box->setAngularVelocity({0.0f, 3.0f, 0.0f});
+  }
+  scalar_scene.run(20);
+  batched_scene.run(20);
+
+  for(int c = 0; c < 3; ++c) {
+    EXPECT_NEAR(scalar->getPosition()[c], batched->getPosition()[c], 1e-4f);
+    EXPECT_NEAR(scalar->getLinearVelocity()[c],
+                batched->getLinearVelocity()[c], 1e-4f);
+    EXPECT_NEAR(scalar->getAngularVelocity()[c],
+                batched->getAngularVelocity()[c], 1e-4f);
+  }
+}
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using World = TestScene<>::World;
+using Joint = World::Joint;
+
+namespace {
+vec3_t position(World::DynamicBody* body) {
+  return body->getTransform().getTranslation();
+}
+}
+
+// Bodies floating in the air, small and far enough apart not to collide.
+class Joints : public ::testing::Test {
+ protected:
+  Joints() : box({0.25f, 0.25f, 0.25f}), sphere(0.25f), scene(16) {}
+
+  Joint* join(Joint::Type type, World::DynamicBody* body_0,
+              World::DynamicBody* body_1, vec3_t const& anchor,
+              vec3_t const& axis = {0.0f, 1.0f, 0.0f}) {
+    Joint::Config cfg(type, body_0, body_1);
+    cfg.anchor = anchor;
+    cfg.axis = axis;
+    return scene.world->createJoint(cfg);
+  }
+
+  phys::shapes::Box<CFG> box;
+  phys::shapes::Sphere<CFG> sphere;
+  TestScene<> scene;
+};
+
+TEST_F(Joints, BallSocketKeepsPendulumLength) {
+  auto bob = scene.add(&sphere, {1.0f, 0.0f, 0.0f});
+  join(Joint::BALL_SOCKET, bob, nullptr, {0.0f, 0.0f, 0.0f});
+
+  real_t lowest = 0.0f;
+  for(int i = 0; i < 120; ++i) {
+    scene.run(1);
+    EXPECT_NEAR(1.0f, length(position(bob)), 0.02f);
+    lowest = std::min(lowest, position(bob)[1]);
+  }
+
+  // It swung down rather than hanging in the air.
+  EXPECT_LT(lowest, -0.9f);
+}
+
+TEST_F(Joints, ChainsShareAnIsland) {
+  enum { link_count = 4 };
+
+  std::vector<World::DynamicBody*> links;
+  for(int i = 0; i < link_count; ++i) {
+    links.push_back(scene.add(&sphere, {real_t(i + 1), 0.0f, 0.0f}));
+    auto previous = i > 0 ? links[i - 1] : nullptr;
+    join(Joint::BALL_SOCKET, links[i], previous,
+         {real_t(i) + 0.5f, 0.0f, 0.0f});
+  }
+
+  // Unrelated to the chain.
+  scene.add(&sphere, {-5.0f, 0.0f, 0.0f});
+  scene.run(90);
+
+  auto stats = scene.islandStats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ(uint32_t(link_count), stats[0].joint_count);
+  EXPECT_EQ(0u, stats[0].contact_count);
+
+  vec3_t first_anchor = {0.5f, 0.0f, 0.0f};
+  EXPECT_NEAR(0.5f, length(position(links[0]) - first_anchor), 0.05f);
+  for(int i = 1; i < link_count; ++i) {
+    auto gap = length(position(links[i]) - position(links[i - 1]));
+    EXPECT_NEAR(1.0f, gap, 0.05f);
+  }
+}
+
+TEST_F(Joints, HingeOnlyTurnsAroundItsAxis) {
+  auto door = scene.add(&box, {1.0f, 0.0f, 0.0f});
+  vec3_t axis = {0.0f, 0.0f, 1.0f};
+  join(Joint::HINGE, door, nullptr, {0.0f, 0.0f, 0.0f}, axis);
+
+  // Tries to twist it off its axis.
+  door->setAngularVelocity({2.0f, 3.0f, 0.0f});
+  scene.run(120);
+
+  auto const& rot = door->getTransform().getRotationMatrix();
+  vec3_t turned_axis = rot * axis;
+  EXPECT_NEAR(1.0f, turned_axis[2], 0.01f);
+
+  auto ang_vel = door->getAngularVelocity();
+  EXPECT_NEAR(0.0f, ang_vel[0], 0.05f);
+  EXPECT_NEAR(0.0f, ang_vel[1], 0.05f);
+  EXPECT_NEAR(1.0f, length(position(door)), 0.02f);
+
+  // Gravity still swings it around the axis.
+  EXPECT_LT(position(door)[1], -0.5f);
+}
+
+TEST_F(Joints, SliderOnlySlidesAlongItsAxis) {
+  auto carriage = scene.add(&box, {0.0f, 0.0f, 0.0f});
+  join(Joint::SLIDER, carriage, nullptr, {0.0f, 0.0f, 0.0f},
+       {1.0f, 0.0f, 0.0f});
+
+  // Pushed along the axis and down.
+  vec3_t accel = {2.0f, -9.81f, 0.0f};
+  scene.run(60, accel);
+
+  EXPECT_NEAR(2.0f, carriage->getLinearVelocity()[0], 0.1f);
+  EXPECT_NEAR(1.0f, position(carriage)[0], 0.1f);
+  EXPECT_NEAR(0.0f, position(carriage)[1], 0.01f);
+  EXPECT_NEAR(0.0f, position(carriage)[2], 0.01f);
+  EXPECT_NEAR(0.0f, length(carriage->getAngularVelocity()), 0.01f);
+}
+
+TEST_F(Joints, FixedJointsKeepBodiesTogether) {
+  auto base = scene.add(&box, {0.0f, 0.0f, 0.0f});
+  auto arm = scene.add(&sphere, {1.0f, 0.0f, 0.0f});
+  join(Joint::FIXED, base, arm, {0.5f, 0.0f, 0.0f});
+
+  // Spins and falls together.
+  base->setAngularVelocity({0.0f, 3.0f, 1.0f});
+  scene.run(60);
+
+  auto const& trans = base->getTransform();
+  vec3_t relative = trans.applyInverse(position(arm));
+  EXPECT_NEAR(1.0f, relative[0], 0.02f);
+  EXPECT_NEAR(0.0f, relative[1], 0.02f);
+  EXPECT_NEAR(0.0f, relative[2], 0.02f);
+  EXPECT_LT(position(base)[1], -1.0f);
+}
+
+TEST_F(Joints, DeletedJointsReleaseBodies) {
+  auto body = scene.add(&box, {0.0f, 0.0f, 0.0f});
+  auto joint = join(Joint::FIXED, body, nullptr, {0.0f, 0.0f, 0.0f});
+
+  scene.run(30);
+  EXPECT_NEAR(0.0f, position(body)[1], 0.01f);
+  EXPECT_EQ(1u, scene.world->joints().size());
+
+  scene.world->deleteJoint(joint);
+  EXPECT_EQ(0u, scene.world->joints().size());
+
+  scene.run(30);
+  EXPECT_LT(position(body)[1], -1.0f);
+}
\ No newline at end of file
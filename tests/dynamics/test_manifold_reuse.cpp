@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using Scene = TestScene<>;
+
+namespace {
+// BoxPlane, counting how many times the narrowphase runs.
+struct CountingBoxPlane : public phys::col::narrow::BoxPlane<CFG> {
+  static int calls;
+
+  void process(phys::Collision<CFG>* result) override {
+    ++calls;
+    phys::col::narrow::BoxPlane<CFG>::process(result);
+  }
+};
+
+int CountingBoxPlane::calls = 0;
+
+// A box settled on the floor, with the box-plane pairs counted.
+Scene::DynamicBody* settleBox(Scene* scene, bool reuse) {
+  scene->world->manifoldReuse().enabled = reuse;
+  scene->factory.registerAlgorithm<CountingBoxPlane>(2);
+  scene->factory.prepopulate();
+
+  scene->addFloor();
+  auto body = scene->add(&scene->box, {0.0f, 0.5f, 0.0f});
+  scene->run(60);
+  return body;
+}
+}
+
+TEST(ManifoldReuse, SkipsNarrowphaseOfRestingPairs) {
+  Scene scene(4);
+  auto body = settleBox(&scene, true);
+
+  // The box-plane manifold is complete from the first run, and the box
+  // stays within the tolerances while it rests.
+  CountingBoxPlane::calls = 0;
+  scene.run(30);
+  EXPECT_EQ(0, CountingBoxPlane::calls);
+  EXPECT_EQ(4u, scene.islandStats().at(0).contact_count);
+
+  // Sliding by more than ManifoldReuse::max_translation in a step gets the
+  // points found again. The box only moves after the first step's collision
+  // detection, so it shows in the second one.
+  ASSERT_GT(0.5f * scene.dt, scene.world->manifoldReuse().max_translation);
+  body->setLinearVelocity({1.0f, 0.0f, 0.0f});
+  scene.run(2);
+  EXPECT_EQ(1, CountingBoxPlane::calls);
+  EXPECT_EQ(4u, scene.islandStats().at(0).contact_count);
+}
+
+TEST(ManifoldReuse, RunsNarrowphaseEveryStepWhenDisabled) {
+  Scene scene(4);
+  settleBox(&scene, false);
+
+  CountingBoxPlane::calls = 0;
+  scene.run(30);
+  EXPECT_EQ(30, CountingBoxPlane::calls);
+}
+
+// Box pairs go through ConvexConvex, which adds a single point per run. A
+// box settling on another one barely moves, yet its manifold must still fill
+// up as it does, rather than being reused with its first points.
+TEST(ManifoldReuse, FillsManifoldOfSettlingBoxes) {
+  Scene scene(4);
+  scene.world->manifoldReuse().enabled = true;
+
+  Scene::StaticBody::Config ground_cfg(&scene.box);
+  ground_cfg.initial_transform.setTranslation({0.0f, -0.5f, 0.0f});
+  scene.world->createBody(ground_cfg);
+
+  // Tilted by less than ManifoldReuse::max_rotation.
+  Scene::DynamicBody::Config box_cfg(&scene.box);
+  box_cfg.initial_transform.setRotation(
+      normalize(CFG::quat_t(1.0f, 0.002f, 0.0f, 0.001f)));
+  auto body = scene.add(box_cfg, {0.0f, 0.5016f, 0.0f});
+  scene.run(15);
+
+  auto stats = scene.islandStats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ(std::size_t(CFG::max_contact_points_per_collision),
+            std::size_t(stats[0].contact_count));
+  EXPECT_NEAR(0.5f, body->getPosition().y, 0.01f);
+}
@@ -0,0 +1,234 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+namespace {
+// Keeps track of what it is asked to solve.
+struct RecordingSolver : public phys::seqi_solver::Solver<CFG> {
+  template <typename ALGO>
+  void solve(phys::ArrayView<phys::DynamicBody<CFG, ALGO>*> objects,
+             phys::ArrayView<phys::Collision<CFG>*> collisions,
+             phys::ArrayView<phys::Joint<CFG, ALGO>*> joints, real_t dt,
+             phys::ThreadPool* thread_pool = nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for(auto object : objects) {
+        solved.push_back(object);
+      }
+      solvers.insert(this);
+      ++calls;
+
+      std::size_t contact_count = 0;
+      for(auto collision : collisions) {
+        contact_count += collision->points.size();
+      }
+      if(thread_pool) {
+        pooled.push_back({contact_count, joints.size()});
+      } else if(joints.size() != 0) {
+        serial_jointed.push_back({contact_count, joints.size()});
+      }
+    }
+    phys::seqi_solver::Solver<CFG>::solve(objects, collisions, joints, dt,
+                                          thread_pool);
+  }
+
+  static std::mutex mutex;
+  static std::vector<void const*> solved;
+  static std::set<void const*> solvers;
+  static int calls;
+
+  // The contact points and joints of the visits that got the thread pool,
+  // and of the ones with joints that did not.
+  struct Pooled {
+    std::size_t contact_count;
+    std::size_t joint_count;
+  };
+  static std::vector<Pooled> pooled;
+  static std::vector<Pooled> serial_jointed;
+};
+
+std::mutex RecordingSolver::mutex;
+std::vector<void const*> RecordingSolver::solved;
+std::set<void const*> RecordingSolver::solvers;
+int RecordingSolver::calls = 0;
+std::vector<RecordingSolver::Pooled> RecordingSolver::pooled;
+std::vector<RecordingSolver::Pooled> RecordingSolver::serial_jointed;
+
+struct RecordingAlgos {
+  using Solver = RecordingSolver;
+  using Broadphase = phys::DefaultAlgos<CFG>::Broadphase;
+};
+
+using World = phys::World<CFG, RecordingAlgos>;
+}
+
+TEST(ParallelIslands, SolvesEveryIslandOnce) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  phys::ThreadPool thread_pool(3);
+  World world(256, &factory, &thread_pool);
+
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+  world.createBody(World::StaticBody::Config(&floor));
+
+  // Stacks of spheres, each of them its own island. They get taller along x,
+  // so that islands have very different costs.
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  std::vector<World::DynamicBody*> bodies;
+  std::vector<real_t> heights;
+  for(int x = 0; x < 8; ++x) {
+    for(int z = 0; z < 8; ++z) {
+      for(int y = 0; y <= x; ++y) {
+        World::DynamicBody::Config cfg(&sphere);
+        cfg.initial_transform.setTranslation(
+            {real_t(x * 4), 0.5f + real_t(y), real_t(z * 4)});
+        bodies.push_back(world.createBody(cfg));
+        heights.push_back(0.5f + real_t(y));
+      }
+    }
+  }
+
+  for(int i = 0; i < 30; ++i) {
+    for(auto body : world.dynamicBodies()) {
+      body->applyForce(vec3_t{0.0f, -9.81f, 0.0f} * body->getMass());
+    }
+
+    RecordingSolver::solved.clear();
+    world.step(1.0f / 60.0f);
+
+    ASSERT_EQ(bodies.size(), RecordingSolver::solved.size());
+    std::set<void const*> unique(RecordingSolver::solved.begin(),
+                                 RecordingSolver::solved.end());
+    EXPECT_EQ(bodies.size(), unique.size());
+  }
+
+  // Every thread has its own solver, and the stacks stay up.
+  EXPECT_LE(RecordingSolver::solvers.size(), thread_pool.threadCount());
+  for(std::size_t i = 0; i < bodies.size(); ++i) {
+    EXPECT_NEAR(heights[i], bodies[i]->getPosition().y, 0.05f);
+  }
+}
+
+TEST(ParallelIslands, MergesSmallIslands) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  World world(256, &factory);
+
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+  world.createBody(World::StaticBody::Config(&floor));
+
+  // Scattered spheres, every one of them its own island. Half of them rest
+  // on the floor, the others are dropped from different heights, and land
+  // while the islands they were merged with are still at rest.
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  std::vector<World::DynamicBody*> bodies;
+  for(int x = 0; x < 10; ++x) {
+    for(int z = 0; z < 10; ++z) {
+      real_t height = (x + z) % 2 ? 0.5f + real_t(x) * 0.1f : 0.5f;
+      World::DynamicBody::Config cfg(&sphere);
+      cfg.initial_transform.setTranslation(
+          {real_t(x * 2), height, real_t(z * 2)});
+      bodies.push_back(world.createBody(cfg));
+    }
+  }
+
+  for(int i = 0; i < 60; ++i) {
+    for(auto body : world.dynamicBodies()) {
+      body->applyForce(vec3_t{0.0f, -9.81f, 0.0f} * body->getMass());
+    }
+
+    RecordingSolver::solved.clear();
+    RecordingSolver::calls = 0;
+    world.step(1.0f / 60.0f);
+
+    ASSERT_EQ(bodies.size(), RecordingSolver::solved.size());
+    EXPECT_LT(RecordingSolver::calls, int(bodies.size()) / 8);
+  }
+
+  for(auto body : bodies) {
+    EXPECT_NEAR(0.5f, body->getPosition().y, 0.01f);
+    EXPECT_NEAR(0.0f, body->getLinearVelocity().y, 0.05f);
+  }
+}
+
+TEST(ParallelIslands, OnlyLargeIslandsWithoutJointsGetThePool) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  phys::ThreadPool thread_pool(3);
+  World world(256, &factory, &thread_pool);
+  world.solver().config().min_parallel_contacts = 16;
+
+  phys::shapes::AxisAlignedPlane<CFG> floor(1, 0.0f);
+  world.createBody(World::StaticBody::Config(&floor));
+
+  // Four rafts of 5x5 spheres pressed against each other, each of them an
+  // island with dozens of contact points. One of them also has a joint,
+  // which the solver cannot spread across threads.
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  std::vector<World::DynamicBody*> jointed;
+  for(int raft = 0; raft < 4; ++raft) {
+    for(int x = 0; x < 5; ++x) {
+      for(int z = 0; z < 5; ++z) {
+        World::DynamicBody::Config cfg(&sphere);
+        cfg.initial_transform.setTranslation(
+            {real_t(raft * 10) + real_t(x) * 0.99f, 0.5f, real_t(z) * 0.99f});
+        auto body = world.createBody(cfg);
+        if(raft == 0) {
+          jointed.push_back(body);
+        }
+      }
+    }
+  }
+
+  World::Joint::Config joint_cfg(World::Joint::FIXED, jointed[0], jointed[1]);
+  joint_cfg.anchor = {0.0f, 0.5f, 0.495f};
+  world.createJoint(joint_cfg);
+
+  // Lone spheres, merged together into islands with more contact points than
+  // min_parallel_contacts, which the solver does not split either.
+  for(int x = 0; x < 40; ++x) {
+    World::DynamicBody::Config cfg(&sphere);
+    cfg.initial_transform.setTranslation({real_t(x * 2), 0.5f, 20.0f});
+    world.createBody(cfg);
+  }
+
+  for(int i = 0; i < 10; ++i) {
+    for(auto body : world.dynamicBodies()) {
+      body->applyForce(vec3_t{0.0f, -9.81f, 0.0f} * body->getMass());
+    }
+
+    RecordingSolver::pooled.clear();
+    RecordingSolver::serial_jointed.clear();
+    world.step(1.0f / 60.0f);
+
+    ASSERT_EQ(3u, RecordingSolver::pooled.size());
+    for(auto const& pooled : RecordingSolver::pooled) {
+      EXPECT_EQ(0u, pooled.joint_count);
+      EXPECT_LE(16u, pooled.contact_count);
+    }
+
+    // The jointed raft is as large as the others, and falls back to the
+    // serial path.
+    ASSERT_EQ(1u, RecordingSolver::serial_jointed.size());
+    EXPECT_EQ(1u, RecordingSolver::serial_jointed[0].joint_count);
+    EXPECT_LE(16u, RecordingSolver::serial_jointed[0].contact_count);
+  }
+
+  for(auto body : jointed) {
+    EXPECT_NEAR(0.5f, body->getPosition().y, 0.01f);
+  }
+}
\ No newline at end of file
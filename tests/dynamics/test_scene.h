@@ -0,0 +1,77 @@
+#ifndef PHYS_TESTS_DYNAMICS_TEST_SCENE_H
+#define PHYS_TESTS_DYNAMICS_TEST_SCENE_H
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "phys/phys.h"
+
+// A world over the default shapes and algorithms, stepped at 60Hz with
+// gravity applied to every dynamic body.
+//
+// Bodies can use the scene's own sphere and box, other shapes given to add()
+// must outlive the scene.
+template <typename ALGO = phys::DefaultAlgos<phys::DefaultConfig>>
+struct TestScene {
+  using CFG = phys::DefaultConfig;
+  using real_t = CFG::real_t;
+  using vec3_t = CFG::vec3_t;
+  using World = phys::World<CFG, ALGO>;
+  using StaticBody = typename World::StaticBody;
+  using DynamicBody = typename World::DynamicBody;
+  using IslandStats = typename World::Solver::IslandStats;
+
+  TestScene(unsigned int object_count_hint)
+      : floor_shape(1, 0.0f), sphere(0.5f), box({0.5f, 0.5f, 0.5f}) {
+    factory.registerDefaultShapesAndAlgorithms();
+    factory.prepopulate();
+
+    world.reset(new World(object_count_hint, &factory));
+  }
+
+  // A plane at y = 0.
+  StaticBody* addFloor(real_t friction = 0.5f) {
+    typename StaticBody::Config cfg(&floor_shape);
+    cfg.friction = friction;
+    return world->createBody(cfg);
+  }
+
+  DynamicBody* add(typename DynamicBody::Config cfg, vec3_t const& position) {
+    cfg.initial_transform.setTranslation(position);
+    return world->createBody(cfg);
+  }
+
+  void run(int steps, vec3_t const& gravity = {0.0f, -9.81f, 0.0f}) {
+    for(int i = 0; i < steps; ++i) {
+      for(auto body : world->dynamicBodies()) {
+        body->applyForce(gravity * body->getMass());
+      }
+      world->step(dt);
+    }
+  }
+
+  // Gravity tilted by angle along x, as if the floor was a slope.
+  static vec3_t slope(real_t angle) {
+    return vec3_t{std::sin(angle), -std::cos(angle), 0.0f} * 9.81f;
+  }
+
+  // The islands solved by the last step.
+  std::vector<IslandStats> islandStats() const {
+    std::vector<IslandStats> result;
+    world->visitIslandStats(
+        [&result](IslandStats const& stats) { result.push_back(stats); });
+    return result;
+  }
+
+  const real_t dt = 1.0f / 60.0f;
+
+  phys::col::NarrowphaseFactory<CFG> factory;
+  phys::shapes::AxisAlignedPlane<CFG> floor_shape;
+
+  // Both one unit across.
+  phys::shapes::Sphere<CFG> sphere;
+  phys::shapes::Box<CFG> box;
+  std::unique_ptr<World> world;
+};
+
+#endif
\ No newline at end of file
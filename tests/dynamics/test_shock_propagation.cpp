@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using real_t = CFG::real_t;
+using Scene = TestScene<>;
+
+namespace {
+using Columns = std::vector<std::vector<Scene::DynamicBody*>>;
+
+// Columns of spheres resting on the floor, far enough from each other to
+// be separate islands.
+Columns addColumns(Scene* scene, bool shock_propagation,
+                   std::vector<int> const& heights) {
+  auto& config = scene->world->solver().config();
+  config.shock_propagation = shock_propagation;
+  config.iterations = 4;
+  config.penetration_iterations = 4;
+  config.warm_start_factor = 0.0f;
+
+  scene->addFloor();
+  Columns columns;
+  for(std::size_t i = 0; i < heights.size(); ++i) {
+    columns.emplace_back();
+    for(int y = 0; y < heights[i]; ++y) {
+      columns.back().push_back(scene->add(
+          &scene->sphere, {real_t(i) * 4.0f, 0.5f + real_t(y), 0.0f}));
+    }
+  }
+  return columns;
+}
+}
+
+TEST(ShockPropagation, TallColumnsHoldWithFewIterations) {
+  Scene scene(64);
+  auto columns = addColumns(&scene, true, {30, 20});
+  scene.run(300);
+
+  for(auto const& column : columns) {
+    for(std::size_t y = 0; y < column.size(); ++y) {
+      EXPECT_NEAR(0.5f + real_t(y), column[y]->getPosition().y, 0.01f);
+      EXPECT_NEAR(0.0f, column[y]->getLinearVelocity().y, 0.01f);
+    }
+  }
+
+  // Without it, the same columns sink into themselves, by several bodies.
+  Scene without(64);
+  auto without_columns = addColumns(&without, false, {30, 20});
+  without.run(300);
+  for(auto const& column : without_columns) {
+    real_t top = real_t(column.size()) - 0.5f;
+    EXPECT_LT(column.back()->getPosition().y, top - 2.0f);
+  }
+}
+
+TEST(ShockPropagation, SameOnSingleBodies) {
+  // With nothing stacked, every contact is against the ground anyway.
+  Scene with(64), without(64);
+  auto with_columns = addColumns(&with, true, {1, 1});
+  auto without_columns = addColumns(&without, false, {1, 1});
+  with_columns[0][0]->setLinearVelocity({1.0f, -2.0f, 0.0f});
+  without_columns[0][0]->setLinearVelocity({1.0f, -2.0f, 0.0f});
+  with.run(60);
+  without.run(60);
+
+  for(int i = 0; i < 2; ++i) {
+    auto pos = with_columns[i][0]->getPosition();
+    auto expected = without_columns[i][0]->getPosition();
+    EXPECT_FLOAT_EQ(expected.x, pos.x);
+    EXPECT_FLOAT_EQ(expected.y, pos.y);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+#include "phys/phys.h"
+#include "grid_mesh.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+using World = phys::World<CFG, phys::DefaultAlgos<CFG>>;
+
+namespace {
+const real_t dt = 1.0f / 30.0f;
+
+// Drops a body onto the floor fast enough to cross it several times over in
+// a single step.
+real_t dropOnFloor(phys::Shape<CFG>* shape) {
+  phys::col::NarrowphaseFactory<CFG> factory;
+  factory.registerDefaultShapesAndAlgorithms();
+  factory.prepopulate();
+
+  std::vector<vec3_t> vertices;
+  std::vector<uint32_t> indices;
+  // A flat floor of 10 x 10 quads, centered on the origin.
+  makeGrid(10, 0.0f, {-5.0f, 0.0f, -5.0f}, &vertices, &indices);
+  phys::shapes::TriangleMesh<CFG> floor(vertices.data(),
+                                        uint32_t(vertices.size()),
+                                        indices.data(),
+                                        uint32_t(indices.size() / 3));
+
+  World world(4, &factory);
+  world.createBody(World::StaticBody::Config(&floor));
+
+  World::DynamicBody::Config cfg(shape);
+  cfg.initial_transform.setTranslation({0.3f, 5.0f, 0.3f});
+  auto body = world.createBody(cfg);
+  body->setLinearVelocity({0.0f, -120.0f, 0.0f});
+
+  for(int i = 0; i < 30; ++i) {
+    body->applyForce(vec3_t{0.0f, -9.81f, 0.0f} * body->getMass());
+    world.step(dt);
+  }
+
+  return body->getPosition().y;
+}
+}
+
+TEST(SpeculativeContacts, SweepExpandsAabb) {
+  phys::shapes::Sphere<CFG> sphere(0.5f);
+  phys::col::Object<CFG> obj;
+  obj.shape = &sphere;
+
+  phys::Aabb<CFG> still;
+  obj.getAabb(&still);
+
+  obj.setSweep({0.0f, -60.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, dt);
+  phys::Aabb<CFG> swept;
+  obj.getAabb(&swept);
+
+  EXPECT_FLOAT_EQ(still.max_bound.y, swept.max_bound.y);
+  EXPECT_NEAR(still.min_bound.y - 2.0f, swept.min_bound.y, 1e-5f);
+  EXPECT_FLOAT_EQ(still.min_bound.x, swept.min_bound.x);
+  EXPECT_NEAR(2.0f, obj.getSweepDistance(), 1e-5f);
+}
+
+TEST(SpeculativeContacts, FastSphereStopsOnFloor) {
+  phys::shapes::Sphere<CFG> sphere(0.1f);
+  EXPECT_NEAR(0.1f, dropOnFloor(&sphere), 0.01f);
+}
+
+TEST(SpeculativeContacts, FastBoxStopsOnFloor) {
+  phys::shapes::Box<CFG> box({0.1f, 0.1f, 0.1f});
+  EXPECT_NEAR(0.1f, dropOnFloor(&box), 0.01f);
+}
\ No newline at end of file
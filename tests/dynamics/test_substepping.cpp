@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using real_t = CFG::real_t;
+using Scene = TestScene<phys::SubsteppingAlgos<CFG>>;
+
+TEST(Substepping, FreeFall) {
+  Scene scene(16);
+  scene.addFloor();
+  auto body = scene.add(&scene.sphere, {0.0f, 10.0f, 0.0f});
+  body->setLinearVelocity({1.0f, 0.0f, 0.0f});
+  scene.run(30);
+
+  // The substeps integrate velocities before positions.
+  real_t t = 30 * scene.dt;
+  EXPECT_NEAR(t, body->getPosition().x, 1e-4f);
+  EXPECT_NEAR(10.0f - 0.5f * 9.81f * t * t, body->getPosition().y, 0.02f);
+  EXPECT_NEAR(-9.81f * t, body->getLinearVelocity().y, 1e-3f);
+}
+
+TEST(Substepping, BoxRestsOnFloor) {
+  Scene scene(16);
+  scene.addFloor();
+  auto body = scene.add(&scene.box, {0.0f, 0.6f, 0.0f});
+  scene.run(120);
+
+  EXPECT_NEAR(0.5f, body->getPosition().y, 0.01f);
+  EXPECT_NEAR(0.0f, length(body->getLinearVelocity()), 0.01f);
+  EXPECT_NEAR(0.0f, length(body->getAngularVelocity()), 0.01f);
+}
+
+TEST(Substepping, HeavySphereOnLightOneHolds) {
+  // A single iteration per substep is enough where iterations on the whole
+  // step let the heavy sphere sink through.
+  Scene scene(16);
+  scene.addFloor();
+  Scene::DynamicBody::Config heavy_cfg(&scene.sphere);
+  heavy_cfg.mass = 100.0f;
+  auto light = scene.add(&scene.sphere, {0.0f, 0.5f, 0.0f});
+  auto heavy = scene.add(heavy_cfg, {0.0f, 1.5f, 0.0f});
+  scene.run(300);
+
+  EXPECT_NEAR(0.5f, light->getPosition().y, 0.03f);
+  EXPECT_NEAR(1.5f, heavy->getPosition().y, 0.05f);
+  EXPECT_NEAR(0.0f, heavy->getLinearVelocity().y, 0.01f);
+}
+
+TEST(Substepping, Friction) {
+  // Holds on a gentle slope, and slides down a steep one, taking mu * cos
+  // off the acceleration.
+  Scene gentle(16);
+  gentle.addFloor();
+  auto held = gentle.add(&gentle.box, {0.0f, 0.5f, 0.0f});
+  gentle.run(120, Scene::slope(std::atan(0.3f)));
+  EXPECT_NEAR(0.0f, held->getLinearVelocity().x, 0.01f);
+
+  Scene steep(16);
+  steep.addFloor();
+  auto sliding = steep.add(&steep.box, {0.0f, 0.5f, 0.0f});
+  real_t angle = std::atan(1.0f);
+  steep.run(60, Scene::slope(angle));
+  real_t expected = 9.81f * (std::sin(angle) - 0.5f * std::cos(angle));
+  EXPECT_NEAR(expected, sliding->getLinearVelocity().x, 0.1f);
+}
\ No newline at end of file
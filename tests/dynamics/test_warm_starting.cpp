@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+#include "phys/phys.h"
+#include "test_scene.h"
+
+using CFG = phys::DefaultConfig;
+using real_t = CFG::real_t;
+using Scene = TestScene<>;
+
+namespace {
+enum { stack_height = 10 };
+
+// Drops a stack of spheres on the floor, and lets it settle. The solver stops
+// early once the residual is low enough.
+std::vector<Scene::DynamicBody*> settleStack(Scene* scene,
+                                             real_t warm_start_factor,
+                                             int iterations) {
+  auto& config = scene->world->solver().config();
+  config.warm_start_factor = warm_start_factor;
+  config.iterations = iterations;
+  config.residual_threshold = 1e-2f;
+  config.penetration_iterations = 4;
+
+  scene->addFloor();
+  std::vector<Scene::DynamicBody*> bodies;
+  for(int y = 0; y < stack_height; ++y) {
+    bodies.push_back(
+        scene->add(&scene->sphere, {0.0f, 0.5f + real_t(y), 0.0f}));
+  }
+  scene->run(300);
+  return bodies;
+}
+
+// The stack is a single island.
+Scene::IslandStats stackStats(Scene const& scene) {
+  auto stats = scene.islandStats();
+  EXPECT_EQ(1u, stats.size());
+  return stats.front();
+}
+}
+
+TEST(WarmStarting, TallStackSettles) {
+  Scene scene(16);
+  auto bodies = settleStack(&scene, 0.85f, 4);
+
+  EXPECT_NEAR(0.5f, bodies.front()->getPosition().y, 0.01f);
+  for(auto body : bodies) {
+    EXPECT_NEAR(0.0f, body->getLinearVelocity().y, 0.01f);
+  }
+}
+
+// The comparisons below leave a wide margin, since how far each iteration
+// gets depends on the order the contacts are solved in, which follows the
+// bodies' addresses.
+TEST(WarmStarting, ConvergesInFewerIterations) {
+  Scene warm(16), cold(16);
+  settleStack(&warm, 0.85f, 50);
+  settleStack(&cold, 0.0f, 50);
+
+  EXPECT_LT(stackStats(warm).iterations, 25);
+  EXPECT_LT(stackStats(warm).iterations * 2, stackStats(cold).iterations);
+}
+
+TEST(WarmStarting, CanBeDisabled) {
+  // Without it, four iterations leave much more of the stack's weight to
+  // carry down to the floor.
+  Scene warm(16), cold(16);
+  settleStack(&warm, 0.85f, 4);
+  settleStack(&cold, 0.0f, 4);
+
+  EXPECT_EQ(4, stackStats(cold).iterations);
+  EXPECT_GT(stackStats(cold).residual, stackStats(warm).residual * 3);
+}
@@ -0,0 +1,35 @@
+#ifndef PHYS_TESTS_GRID_MESH_H
+#define PHYS_TESTS_GRID_MESH_H
+
+#include <vector>
+#include "phys/phys.h"
+
+// A grid of size x size unit quads, two triangles each, facing up. Its first
+// vertex is at origin, and vertices are raised by up to 4 times bump in a
+// repeating pattern, a bump of 0 makes a flat grid.
+inline void makeGrid(int size, phys::DefaultConfig::real_t bump,
+                     phys::DefaultConfig::vec3_t const& origin,
+                     std::vector<phys::DefaultConfig::vec3_t>* vertices,
+                     std::vector<uint32_t>* indices) {
+  using real_t = phys::DefaultConfig::real_t;
+  using vec3_t = phys::DefaultConfig::vec3_t;
+
+  for(int z = 0; z <= size; ++z) {
+    for(int x = 0; x <= size; ++x) {
+      real_t y = real_t((x * 7 + z * 13) % 5) * bump;
+      vertices->push_back(origin + vec3_t(real_t(x), y, real_t(z)));
+    }
+  }
+
+  for(int z = 0; z < size; ++z) {
+    for(int x = 0; x < size; ++x) {
+      uint32_t a = z * (size + 1) + x;
+      uint32_t b = a + 1;
+      uint32_t c = a + size + 1;
+      uint32_t d = c + 1;
+      indices->insert(indices->end(), {a, c, b, b, c, d});
+    }
+  }
+}
+
+#endif
\ No newline at end of file
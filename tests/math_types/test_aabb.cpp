@@ -0,0 +1,32 @@
+#include "gtest/gtest.h"
+
+#include "phys/math_types/aabb.h"
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+
+TEST(Aabb, RotatedBox) {
+  // A 2x2x2 cube turned 45 degrees around y spans sqrt(2) along x and z.
+  phys::Transform<CFG> transform;
+  transform.setRotation(CFG::quat_t(0.9238795f, 0.0f, 0.3826834f, 0.0f));
+  transform.setTranslation({1, 2, 3});
+
+  phys::Aabb<CFG> bounds({1, 1, 1}, transform);
+  EXPECT_NEAR(1.0f - 1.4142136f, bounds.min_bound.x, 1e-5f);
+  EXPECT_NEAR(1.0f, bounds.min_bound.y, 1e-5f);
+  EXPECT_NEAR(3.0f + 1.4142136f, bounds.max_bound.z, 1e-5f);
+}
+
+TEST(Aabb, OffsetCenter) {
+  phys::Transform<CFG> transform;
+  transform.setRotation(CFG::quat_t(0.7071068f, 0.0f, 0.0f, 0.7071068f));
+
+  // Rotating around z by 90 degrees moves the center from +x to +y and swaps
+  // the x and y extents.
+  phys::Aabb<CFG> bounds({2, 0, 0}, {1, 3, 1}, transform);
+  EXPECT_NEAR(-3.0f, bounds.min_bound.x, 1e-5f);
+  EXPECT_NEAR(3.0f, bounds.max_bound.x, 1e-5f);
+  EXPECT_NEAR(1.0f, bounds.min_bound.y, 1e-5f);
+  EXPECT_NEAR(3.0f, bounds.max_bound.y, 1e-5f);
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include "phys/math_types/closest_points.h"
+#include "phys/phys.h"
+
+using CFG = phys::DefaultConfig;
+using vec3_t = CFG::vec3_t;
+using real_t = CFG::real_t;
+
+TEST(ClosestPoints, PointOnSegment) {
+  vec3_t a = {0.0f, 0.0f, 0.0f};
+  vec3_t b = {2.0f, 0.0f, 0.0f};
+
+  EXPECT_FLOAT_EQ(0.5f, phys::closestPointOnSegment<CFG>(a, b, {1, 5, 0}));
+  EXPECT_FLOAT_EQ(0.0f, phys::closestPointOnSegment<CFG>(a, b, {-3, 1, 0}));
+  EXPECT_FLOAT_EQ(1.0f, phys::closestPointOnSegment<CFG>(a, b, {3, 0, 1}));
+
+  // Degenerate segment.
+  EXPECT_FLOAT_EQ(0.0f, phys::closestPointOnSegment<CFG>(a, a, {3, 0, 1}));
+}
+
+TEST(ClosestPoints, CrossingSegments) {
+  real_t s, t;
+  phys::closestPointsSegmentSegment<CFG>({-1, 0, 0}, {1, 0, 0}, {0, -1, 1},
+                                         {0, 1, 1}, &s, &t);
+  EXPECT_FLOAT_EQ(0.5f, s);
+  EXPECT_FLOAT_EQ(0.5f, t);
+}
+
+TEST(ClosestPoints, DisjointSegments) {
+  real_t s, t;
+  phys::closestPointsSegmentSegment<CFG>({0, 0, 0}, {1, 0, 0}, {2, 1, 0},
+                                         {2, 3, 0}, &s, &t);
+  EXPECT_FLOAT_EQ(1.0f, s);
+  EXPECT_FLOAT_EQ(0.0f, t);
+}
+
+TEST(ClosestPoints, ParallelSegments) {
+  real_t s, t;
+  phys::closestPointsSegmentSegment<CFG>({0, 0, 0}, {2, 0, 0}, {1, 1, 0},
+                                         {3, 1, 0}, &s, &t);
+
+  // Any point within the overlap is valid.
+  vec3_t p = vec3_t{2, 0, 0} * s;
+  vec3_t q = vec3_t{1, 1, 0} + vec3_t{2, 0, 0} * t;
+  EXPECT_NEAR(1.0f, length(p - q), 1e-5f);
+}
+
+TEST(ClosestPoints, SegmentOutsideBox) {
+  vec3_t half_extent = {1, 1, 1};
+  real_t t;
+
+  // Parallel to a face.
+  real_t dist_sq =
+      phys::closestPointSegmentBox<CFG>(half_extent, {-3, 2, 0}, {3, 2, 0}, &t);
+  EXPECT_NEAR(1.0f, dist_sq, 1e-5f);
+
+  // Passing by an edge.
+  dist_sq = phys::closestPointSegmentBox<CFG>(half_extent, {2, 3, 0},
+                                              {4, 1, 0}, &t);
+  EXPECT_NEAR(0.25f, t, 1e-5f);
+  EXPECT_NEAR(4.5f, dist_sq, 1e-5f);
+}
+
+TEST(ClosestPoints, SegmentThroughBox) {
+  vec3_t half_extent = {1, 1, 1};
+  real_t t;
+
+  real_t dist_sq = phys::closestPointSegmentBox<CFG>(half_extent, {-3, 0.5f, 0},
+                                                     {3, 0.5f, 0}, &t);
+  EXPECT_FLOAT_EQ(0.0f, dist_sq);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+#include "phys/util_types/aligned_allocator.h"
+
+namespace {
+struct alignas(64) Wide {
+  float value;
+};
+}
+
+TEST(AlignedAllocator, VectorsHonorTheAlignment) {
+  std::vector<Wide, phys::AlignedAllocator<Wide>> values;
+  for(int i = 0; i < 100; ++i) {
+    values.push_back({float(i)});
+
+    // Every reallocation gets its own block.
+    auto address = reinterpret_cast<std::uintptr_t>(values.data());
+    EXPECT_EQ(0u, address % 64);
+  }
+
+  for(int i = 0; i < 100; ++i) {
+    EXPECT_EQ(float(i), values[i].value);
+  }
+}
+
+TEST(AlignedAllocator, WorksWithPlainTypes) {
+  std::vector<char, phys::AlignedAllocator<char>> values(3, 'a');
+  values.resize(1000, 'b');
+  EXPECT_EQ('a', values[2]);
+  EXPECT_EQ('b', values[999]);
+}
\ No newline at end of file
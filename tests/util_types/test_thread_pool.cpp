@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include "phys/util_types/thread_pool.h"
+
+TEST(ThreadPool, NoWorkersRunsInline) {
+  phys::ThreadPool pool(0);
+  EXPECT_EQ(1, pool.threadCount());
+
+  std::vector<int> visited(16, 0);
+  pool.parallelFor(visited.size(), [&](std::size_t task, std::size_t thread) {
+    EXPECT_EQ(0, thread);
+    visited[task]++;
+  });
+
+  for(auto v : visited) {
+    EXPECT_EQ(1, v);
+  }
+}
+
+TEST(ThreadPool, EveryTaskRunsExactlyOnce) {
+  phys::ThreadPool pool(3);
+  EXPECT_EQ(4, pool.threadCount());
+
+  std::vector<std::atomic<int>> visited(1000);
+  for(auto& v : visited) {
+    v = 0;
+  }
+
+  // Run a few jobs back to back to exercise the worker wake-up logic.
+  for(int job = 0; job < 10; ++job) {
+    pool.parallelFor(visited.size(), [&](std::size_t task, std::size_t thread) {
+      EXPECT_LT(thread, pool.threadCount());
+      visited[task]++;
+    });
+  }
+
+  for(auto& v : visited) {
+    EXPECT_EQ(10, v);
+  }
+}
\ No newline at end of file